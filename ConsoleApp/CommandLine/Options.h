@@ -1,26 +1,39 @@
-﻿#pragma once
-
-enum class Command
-{
-    Convert,
-    Show,
-    Help,
-    Unknown
-};
-
-enum class ImageConverterOption
-{
-    InputFile,
-    OutputFile,
-    OutputFormat,
-    Filter,
-    Help,
-    Unknown
-};
-
-enum class AudioShowOption
-{
-    InputFile,
-    Help,
-    Unknown
-};
+﻿#pragma once
+
+enum class Command
+{
+    Convert,
+    Show,
+    Help,
+    Unknown
+};
+
+enum class ImageConverterOption
+{
+    InputFile,
+    OutputFile,
+    OutputFormat,
+    Quality,
+    Filter,
+    Transform,
+    Crop,
+    Thumbnail,
+    AutoOrient,
+    Conceal,
+    Help,
+    Unknown
+};
+
+enum class AudioShowOption
+{
+    InputFile,
+    Help,
+    Unknown
+};
+
+enum class ImageShowOption
+{
+    InputFile,
+    Help,
+    Unknown
+};
@@ -1,133 +1,365 @@
-﻿#pragma once
-#include <memory>
-#include <print>
-#include <ranges>
-#include <string_view>
-#include <type_traits>
-#include <vector>
-#include "CommandLine/Options.h"
-#include "Image/Bitmap/Bitmap.h"
-#include "Image/Filter/IImageFilter.h"
-#include "Image/Filter/BinaryFilter.h"
-#include "Image/Filter/GaussianFilter.h"
-#include "Image/Filter/GrayscaleFilter.h"
-#include "Image/Filter/LaplacianFilter.h"
-#include "Image/Filter/MosaicFilter.h"
-#include "Image/Jpeg/Decoder/JpegDecoder.h"
-
-class ImageConverter final
-{
-public:
-    ImageConverter(std::vector<std::string_view> options) noexcept
-    {
-        m_Options = std::move(options);
-    }
-
-    bool parse() noexcept
-    {
-        for (size_t i = 0; i < m_Options.size(); ++i) {
-            auto& option = m_Options[i];
-            switch (toOption(option)) {
-            case ImageConverterOption::InputFile:
-                m_InputFile = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
-                break;
-            case ImageConverterOption::OutputFile:
-                m_OutputFile = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
-                break;
-            case ImageConverterOption::OutputFormat:
-                m_OutputFormat = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
-                break;
-            case ImageConverterOption::Filter:
-                m_Filters = toFilters((i + 1 < m_Options.size()) ? m_Options[++i] : "");
-                break;
-            default:
-                break;
-            }
-        }
-
-        return !m_InputFile.empty() && !m_OutputFile.empty();
-    }
-
-    bool execute() noexcept
-    {
-        using namespace RagiMagick2::Image::Bitmap;
-        using namespace RagiMagick2::Image::Jpeg;
-        using namespace RagiMagick2::Image::Filter;
-
-        ImageInfo imageInfo{};
-        if (m_InputFile.ends_with(".jpg") || m_InputFile.ends_with(".jpeg")) {
-            imageInfo = decodeJpeg(m_InputFile);
-        }
-        else {
-            return false;
-        }
-        
-        for (auto& filter : m_Filters) {
-            imageInfo = filter->apply(imageInfo);
-        }
-
-        writeBitmap(m_OutputFile, imageInfo.width, imageInfo.height, imageInfo.componentCount * 8, imageInfo.pixels);
-        return true;
-    }
-
-private:
-    ImageConverterOption toOption(std::string_view option) const noexcept
-    {
-        using enum ImageConverterOption;
-        if (option == "--input-file" || option == "-i") {
-            return InputFile;
-        }
-        if (option == "--output-file" || option == "-o") {
-            return OutputFile;
-        }
-        if (option == "--output-format" || option == "-of") {
-            return OutputFormat;
-        }
-        if (option == "--filter") {
-            return Filter;
-        }
-        return Unknown;
-    }
-
-    std::vector<std::shared_ptr<RagiMagick2::Image::Filter::IImageFilter>> toFilters(std::string_view option) const noexcept
-    {
-        using namespace RagiMagick2::Image::Filter;
-        std::vector<std::shared_ptr<IImageFilter>> filters;
-
-        for (const auto& value : std::views::split(option, ',')) {
-            const auto filter = std::string_view{ value.begin(), value.end() };
-            if (filter == "binary") {
-                filters.emplace_back(std::make_shared<BinaryFilter>());
-            }
-            else if (filter == "gaussian") {
-                filters.emplace_back(std::make_shared<GaussianFilter>());
-            }
-            else if (filter == "grayscale") {
-                filters.emplace_back(std::make_shared<GrayscaleFilter>());
-            }
-            else if (filter == "laplacian") {
-                filters.emplace_back(std::make_shared<LaplacianFilter>());
-            }
-            else if (filter == "mosaic") {
-                filters.emplace_back(std::make_shared<MosaicFilter>());
-            }
-        }
-        return filters;
-    }
-
-    RagiMagick2::Image::Filter::ImageInfo decodeJpeg(std::string_view fileName) const noexcept
-    {
-        using namespace RagiMagick2::Image::Jpeg;
-        auto decoder = JpegDecoder(fileName);
-        DecodeResult result{};
-        decoder.decode(result);
-        return { result.width, result.height, 4, result.pixels };
-    }
-
-private:
-    std::vector<std::string_view> m_Options;
-    std::string_view m_InputFile;
-    std::string_view m_OutputFile;
-    std::string_view m_OutputFormat;
-    std::vector<std::shared_ptr<RagiMagick2::Image::Filter::IImageFilter>> m_Filters;
-};
+﻿#pragma once
+#include <memory>
+#include <print>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "CommandLine/Options.h"
+#include "Image/Bitmap/Bitmap.h"
+#include "Image/Filter/IImageFilter.h"
+#include "Image/Filter/BinaryFilter.h"
+#include "Image/Filter/GaussianFilter.h"
+#include "Image/Filter/GrayscaleFilter.h"
+#include "Image/Filter/LaplacianFilter.h"
+#include "Image/Filter/MosaicFilter.h"
+#include "Image/Jpeg/Decoder/JpegDecoder.h"
+#include "Image/Jpeg/Encoder/JpegEncoder.h"
+#include "Image/Jpeg/Exif/ExifReader.h"
+#include "Image/Jpeg/Parser/JpegParser.h"
+#include "Image/Jpeg/Transform/JpegTransformer.h"
+#include "Image/Pixel/PixelOrientation.h"
+
+class ImageConverter final
+{
+public:
+    ImageConverter(std::vector<std::string_view> options) noexcept
+    {
+        m_Options = std::move(options);
+    }
+
+    bool parse() noexcept
+    {
+        for (size_t i = 0; i < m_Options.size(); ++i) {
+            auto& option = m_Options[i];
+            switch (toOption(option)) {
+            case ImageConverterOption::InputFile:
+                m_InputFile = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
+                break;
+            case ImageConverterOption::OutputFile:
+                m_OutputFile = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
+                break;
+            case ImageConverterOption::OutputFormat:
+                m_OutputFormat = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
+                break;
+            case ImageConverterOption::Quality:
+                m_Quality = toQuality((i + 1 < m_Options.size()) ? m_Options[++i] : "");
+                break;
+            case ImageConverterOption::Filter:
+                m_Filters = toFilters((i + 1 < m_Options.size()) ? m_Options[++i] : "");
+                break;
+            case ImageConverterOption::Transform:
+                m_Transform = toTransform((i + 1 < m_Options.size()) ? m_Options[++i] : "");
+                break;
+            case ImageConverterOption::Crop:
+                m_Crop = toCrop((i + 1 < m_Options.size()) ? m_Options[++i] : "");
+                break;
+            case ImageConverterOption::Thumbnail:
+                m_UseThumbnail = true;
+                break;
+            case ImageConverterOption::AutoOrient:
+                m_AutoOrient = true;
+                break;
+            case ImageConverterOption::Conceal:
+                m_ErrorConcealment = toErrorConcealment((i + 1 < m_Options.size()) ? m_Options[++i] : "");
+                break;
+            default:
+                break;
+            }
+        }
+
+        return !m_InputFile.empty() && !m_OutputFile.empty();
+    }
+
+    bool execute() noexcept
+    {
+        using namespace RagiMagick2::Image::Bitmap;
+        using namespace RagiMagick2::Image::Jpeg;
+        using namespace RagiMagick2::Image::Filter;
+
+        const bool isJpegInput = m_InputFile.ends_with(".jpg") || m_InputFile.ends_with(".jpeg");
+        const bool isJpegOutput = m_OutputFormat == "jpeg" || m_OutputFormat == "jpg";
+
+        // JPEG から JPEG への回転・反転・切り抜きだけなら、デコードせずに係数のまま変換する
+        const bool isCropped = m_Crop.width > 0 && m_Crop.height > 0;
+        const bool isTransformed = m_Transform != TransformType::None || isCropped;
+        if (isJpegInput && isJpegOutput && isTransformed && m_Filters.empty() && !m_UseThumbnail) {
+            return transformJpeg(m_InputFile, m_OutputFile);
+        }
+        // 切り抜く範囲は本体の座標なので、大きさの違うサムネイルには使えない
+        if (m_UseThumbnail && isCropped) {
+            std::println("--crop cannot be used with --thumbnail");
+            return false;
+        }
+
+        ImageInfo imageInfo{};
+        if (isJpegInput) {
+            imageInfo = decodeJpeg(m_InputFile);
+        }
+        else {
+            return false;
+        }
+
+        // 係数のまま変換しない場合は、デコードした画像を回転・反転する (切り抜きはデコードで行う)
+        if (m_Transform != TransformType::None) {
+            imageInfo = orientImage(imageInfo.width, imageInfo.height, imageInfo.pixels, getTransformOrientation(m_Transform));
+        }
+        
+        for (auto& filter : m_Filters) {
+            imageInfo = filter->apply(imageInfo);
+        }
+
+        if (isJpegOutput) {
+            return encodeJpeg(m_OutputFile, imageInfo);
+        }
+
+        writeBitmap(m_OutputFile, imageInfo.width, imageInfo.height, imageInfo.componentCount * 8, imageInfo.pixels);
+        return true;
+    }
+
+private:
+    ImageConverterOption toOption(std::string_view option) const noexcept
+    {
+        using enum ImageConverterOption;
+        if (option == "--input-file" || option == "-i") {
+            return InputFile;
+        }
+        if (option == "--output-file" || option == "-o") {
+            return OutputFile;
+        }
+        if (option == "--output-format" || option == "-of") {
+            return OutputFormat;
+        }
+        if (option == "--quality" || option == "-q") {
+            return Quality;
+        }
+        if (option == "--filter") {
+            return Filter;
+        }
+        if (option == "--transform") {
+            return Transform;
+        }
+        if (option == "--crop") {
+            return Crop;
+        }
+        if (option == "--thumbnail") {
+            return Thumbnail;
+        }
+        if (option == "--auto-orient") {
+            return AutoOrient;
+        }
+        if (option == "--conceal") {
+            return Conceal;
+        }
+        return Unknown;
+    }
+
+    std::vector<std::shared_ptr<RagiMagick2::Image::Filter::IImageFilter>> toFilters(std::string_view option) const noexcept
+    {
+        using namespace RagiMagick2::Image::Filter;
+        std::vector<std::shared_ptr<IImageFilter>> filters;
+
+        for (const auto& value : std::views::split(option, ',')) {
+            const auto filter = std::string_view{ value.begin(), value.end() };
+            if (filter == "binary") {
+                filters.emplace_back(std::make_shared<BinaryFilter>());
+            }
+            else if (filter == "gaussian") {
+                filters.emplace_back(std::make_shared<GaussianFilter>());
+            }
+            else if (filter == "grayscale") {
+                filters.emplace_back(std::make_shared<GrayscaleFilter>());
+            }
+            else if (filter == "laplacian") {
+                filters.emplace_back(std::make_shared<LaplacianFilter>());
+            }
+            else if (filter == "mosaic") {
+                filters.emplace_back(std::make_shared<MosaicFilter>());
+            }
+        }
+        return filters;
+    }
+
+    // 1～100 の整数でなければ既定値 (75)
+    int toQuality(std::string_view option) const noexcept
+    {
+        int quality = 0;
+        const auto [ptr, ec] = std::from_chars(option.data(), option.data() + option.size(), quality);
+        if (ec != std::errc{} || ptr != option.data() + option.size() || quality < 1 || quality > 100) {
+            return RagiMagick2::Image::Jpeg::EncodeOptions{}.quality;
+        }
+        return quality;
+    }
+
+    RagiMagick2::Image::Jpeg::TransformType toTransform(std::string_view option) const noexcept
+    {
+        using enum RagiMagick2::Image::Jpeg::TransformType;
+        if (option == "flip-h") {
+            return FlipHorizontal;
+        }
+        if (option == "flip-v") {
+            return FlipVertical;
+        }
+        if (option == "transpose") {
+            return Transpose;
+        }
+        if (option == "transverse") {
+            return Transverse;
+        }
+        if (option == "rotate90") {
+            return Rotate90;
+        }
+        if (option == "rotate180") {
+            return Rotate180;
+        }
+        if (option == "rotate270") {
+            return Rotate270;
+        }
+        return None;
+    }
+
+    RagiMagick2::Image::Jpeg::ErrorConcealment toErrorConcealment(std::string_view option) const noexcept
+    {
+        using enum RagiMagick2::Image::Jpeg::ErrorConcealment;
+        if (option == "gray") {
+            return Gray;
+        }
+        if (option == "previous") {
+            return PreviousRow;
+        }
+        return None;
+    }
+
+    // x,y,width,height (形式が違えば切り抜かない)
+    RagiMagick2::Image::Jpeg::DecodeRegion toCrop(std::string_view option) const noexcept
+    {
+        std::array<int, 4> values{};
+        size_t count = 0;
+        for (const auto& value : std::views::split(option, ',')) {
+            const auto text = std::string_view{ value.begin(), value.end() };
+            if (count >= values.size()) {
+                return {};
+            }
+            const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), values[count]);
+            if (ec != std::errc{} || ptr != text.data() + text.size() || values[count] < 0) {
+                return {};
+            }
+            ++count;
+        }
+        if (count != values.size()) {
+            return {};
+        }
+        return { values[0], values[1], values[2], values[3] };
+    }
+
+    bool transformJpeg(std::string_view inputFile, std::string_view outputFile) const noexcept
+    {
+        using namespace RagiMagick2::Image::Jpeg;
+
+        TransformOptions options{};
+        options.type = m_Transform;
+        options.crop = m_Crop;
+        options.applyExifOrientation = m_AutoOrient;
+        auto transformer = JpegTransformer(inputFile);
+        std::vector<uint8_t> output;
+        if (!transformer.transform(output, options)) {
+            return false;
+        }
+
+        std::ofstream file(std::string(outputFile), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(output.data()), output.size());
+        return file.good();
+    }
+
+    RagiMagick2::Image::Filter::ImageInfo decodeJpeg(std::string_view fileName) const noexcept
+    {
+        using namespace RagiMagick2::Image::Jpeg;
+        // EXIF のサムネイルがあれば、本体の代わりにそれをデコードする (無ければ本体)
+        if (m_UseThumbnail) {
+            JpegParser parser(fileName);
+            if (JpegInfo info{}; parser.probe(info)) {
+                if (const auto thumbnail = ExifReader(parser.getExif()).getThumbnail(); !thumbnail.empty()) {
+                    auto decoder = JpegDecoder(thumbnail);
+                    DecodeResult result{};
+                    decoder.decode(result);
+                    if (result.width > 0) {
+                        // サムネイル自体には EXIF が無いので、本体の Orientation に従って向きを変える
+                        if (m_AutoOrient) {
+                            return orientImage(result.width, result.height, result.pixels, RagiMagick2::Image::Pixel::getOrientation(info.orientation));
+                        }
+                        return { result.width, result.height, 4, result.pixels };
+                    }
+                }
+            }
+        }
+
+        // EXIF の Orientation に従って、デコードしながら表示の向きに回転する
+        // 切り抜く範囲は回転した後の座標で、その範囲と重なる MCU だけデコードする
+        DecodeOptions options{};
+        options.applyExifOrientation = m_AutoOrient;
+        options.errorConcealment = m_ErrorConcealment;
+        auto decoder = JpegDecoder(fileName);
+        DecodeResult result{};
+        if (m_Crop.width > 0 && m_Crop.height > 0) {
+            decoder.decode(result, m_Crop, options);
+        }
+        else {
+            decoder.decode(result, options);
+        }
+        for (const auto& range : decoder.getDamagedMCURanges()) {
+            std::println("Damaged MCU: {} - {}", range.firstMCU, range.firstMCU + range.mcuCount - 1);
+        }
+        return { result.width, result.height, 4, result.pixels };
+    }
+
+    // BGRA32 の画像の向きを orientation に従って変える
+    static RagiMagick2::Image::Filter::ImageInfo orientImage(int width, int height, const std::vector<uint8_t>& pixels, const RagiMagick2::Image::Pixel::Orientation& orientation)
+    {
+        using namespace RagiMagick2::Image::Pixel;
+
+        if (orientation.isIdentity()) {
+            return { width, height, 4, pixels };
+        }
+        const auto [orientedWidth, orientedHeight] = getOrientedSize(width, height, orientation);
+        std::vector<uint8_t> oriented(pixels.size());
+        storeOriented(
+            orientation, 4,
+            pixels.data(), static_cast<size_t>(width) * 4, 0, 0, width, height,
+            width, height, oriented.data(), static_cast<size_t>(orientedWidth) * 4
+        );
+        return { orientedWidth, orientedHeight, 4, std::move(oriented) };
+    }
+
+    // フィルタの出力 (BGRA32) を JPEG で書き出す
+    bool encodeJpeg(std::string_view fileName, const RagiMagick2::Image::Filter::ImageInfo& imageInfo) const noexcept
+    {
+        using namespace RagiMagick2::Image;
+        using namespace RagiMagick2::Image::Jpeg;
+
+        if (imageInfo.componentCount != 4) {
+            return false;
+        }
+
+        EncodeOptions options{};
+        options.quality = m_Quality;
+        auto encoder = JpegEncoder(fileName);
+        const size_t stride = static_cast<size_t>(imageInfo.width) * imageInfo.componentCount;
+        return encoder.encode(imageInfo.pixels, stride, imageInfo.width, imageInfo.height, Pixel::PixelFormat::B8G8R8A8_UINT, options);
+    }
+
+private:
+    std::vector<std::string_view> m_Options;
+    std::string_view m_InputFile;
+    std::string_view m_OutputFile;
+    std::string_view m_OutputFormat;
+    int m_Quality = RagiMagick2::Image::Jpeg::EncodeOptions{}.quality;
+    std::vector<std::shared_ptr<RagiMagick2::Image::Filter::IImageFilter>> m_Filters;
+    RagiMagick2::Image::Jpeg::TransformType m_Transform = RagiMagick2::Image::Jpeg::TransformType::None;
+    RagiMagick2::Image::Jpeg::DecodeRegion m_Crop{};
+    bool m_UseThumbnail = false;
+    bool m_AutoOrient = false;
+    RagiMagick2::Image::Jpeg::ErrorConcealment m_ErrorConcealment = RagiMagick2::Image::Jpeg::ErrorConcealment::None;
+};
@@ -0,0 +1,134 @@
+﻿#pragma once
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CommandLine/Options.h"
+#include "Common/ThreadPool.h"
+#include "Image/Jpeg/Parser/JpegParser.h"
+
+class ImageDumper final
+{
+public:
+    ImageDumper(std::vector<std::string_view> options)
+    {
+        m_Options = std::move(options);
+    }
+
+    bool parse() noexcept
+    {
+        for (size_t i = 0; i < m_Options.size(); ++i) {
+            auto& option = m_Options[i];
+            switch (toOption(option)) {
+            case ImageShowOption::InputFile:
+                m_InputFile = (i + 1 < m_Options.size()) ? m_Options[++i] : "";
+                break;
+            default:
+                break;
+            }
+        }
+
+        return !m_InputFile.empty();
+    }
+
+    // ディレクトリが指定された場合は、その下の JPEG を全てスレッドプールでヘッダだけ読む
+    bool execute()
+    {
+        using namespace RagiMagick2::Image::Jpeg;
+
+        const auto files = collectFiles(m_InputFile);
+        if (files.empty()) {
+            std::println("No JPEG files found: {}", m_InputFile);
+            return false;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::optional<JpegInfo>> infos(files.size());
+        RagiMagick2::Common::ThreadPool::shared().parallelFor(files.size(), [&](size_t i) {
+            JpegParser parser(files[i].string());
+            if (JpegInfo info{}; parser.probe(info)) {
+                infos[i] = std::move(info);
+            }
+        });
+
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        size_t failed = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            const auto& info = infos[i];
+            if (!info) {
+                std::println("{}: failed to probe", files[i].string());
+                ++failed;
+                continue;
+            }
+
+            std::string sampling;
+            for (const auto& [h, v] : info->samplingFactors) {
+                sampling += std::format("{}{}x{}", sampling.empty() ? "" : ",", h, v);
+            }
+            std::println(
+                "{}: {}x{}, components: {} ({}), {}, orientation: {}, date: {}, thumbnail: {} bytes",
+                files[i].string(),
+                info->width,
+                info->height,
+                info->componentCount,
+                sampling,
+                info->isProgressive ? "progressive" : "baseline",
+                info->orientation,
+                info->dateTime.empty() ? "-" : info->dateTime,
+                info->thumbnailSize
+            );
+        }
+
+        std::println();
+        std::println("{} files ({} failed), {:.1f} ms", files.size(), failed, elapsed.count());
+        return failed == 0;
+    }
+
+private:
+    ImageShowOption toOption(std::string_view option) const noexcept
+    {
+        using enum ImageShowOption;
+        if (option == "--input-file" || option == "-i") {
+            return InputFile;
+        }
+        return Unknown;
+    }
+
+    static bool isJpeg(const std::filesystem::path& path)
+    {
+        auto extension = path.extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".jpg" || extension == ".jpeg";
+    }
+
+    static std::vector<std::filesystem::path> collectFiles(std::string_view input)
+    {
+        std::vector<std::filesystem::path> files;
+        std::error_code error;
+
+        const std::filesystem::path path(input);
+        if (!std::filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            return files;
+        }
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, error)) {
+            if (entry.is_regular_file(error) && isJpeg(entry.path())) {
+                files.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(files);
+        return files;
+    }
+
+    std::vector<std::string_view> m_Options;
+    std::string_view m_InputFile;
+};
@@ -0,0 +1,153 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace RagiMagick2::Common
+{
+    // メモリ上のバイト列を BinaryFileReader と同じ要領で読む
+    // 範囲外を読もうとした場合は、足りない分を 0 で埋めて末尾で止まる
+    class BinaryMemoryReader final
+    {
+    public:
+        enum class SeekOrigin
+        {
+            Begin,
+            Current,
+            End
+        };
+
+    public:
+        BinaryMemoryReader() noexcept = default;
+
+        BinaryMemoryReader(std::span<const uint8_t> data, bool isByteSwap = true) noexcept
+            : m_Data(data)
+            , m_IsByteSwap(isByteSwap)
+        {
+        }
+
+        template <typename T, size_t N>
+        void ReadBytes(std::array<T, N>& buffer, size_t count = sizeof(T) * N) noexcept
+        {
+            copyTo(buffer.data(), count);
+        }
+
+        template <std::ranges::random_access_range T>
+        std::size_t ReadBytes(T& buffer) noexcept
+        {
+            return copyTo(std::data(buffer), std::size(buffer) * sizeof(std::ranges::range_value_t<T>));
+        }
+
+        // コピーせずに、現在位置から count バイトの範囲を返す (足りない場合は末尾まで)
+        std::span<const uint8_t> ReadSpan(size_t count) noexcept
+        {
+            auto span = m_Data.subspan(m_Position, std::min(count, GetRemaining()));
+            m_Position += span.size();
+            return span;
+        }
+
+        template <typename T>
+            requires (std::is_same_v<T, uint8_t> || (std::is_enum_v<T> && std::is_same_v<std::underlying_type_t<T>, uint8_t>))
+        void ReadUInt8(T& buffer) noexcept
+        {
+            copyTo(&buffer, sizeof(T));
+        }
+
+        template <typename T>
+            requires (std::is_same_v<T, uint16_t> || (std::is_enum_v<T> && std::is_same_v<std::underlying_type_t<T>, uint16_t>))
+        void ReadUInt16(T& buffer) noexcept
+        {
+            copyTo(&buffer, sizeof(T));
+            if (m_IsByteSwap) {
+                if constexpr (std::is_enum_v<T>) {
+                    buffer = static_cast<T>(std::byteswap(static_cast<std::underlying_type_t<T>>(buffer)));
+                }
+                else {
+                    buffer = std::byteswap(buffer);
+                }
+            }
+        }
+
+        template <typename T>
+            requires (std::is_same_v<T, uint32_t> || (std::is_enum_v<T> && std::is_same_v<std::underlying_type_t<T>, uint32_t>))
+        void ReadUInt32(T& buffer) noexcept
+        {
+            copyTo(&buffer, sizeof(T));
+            if (m_IsByteSwap) {
+                if constexpr (std::is_enum_v<T>) {
+                    buffer = static_cast<T>(std::byteswap(static_cast<std::underlying_type_t<T>>(buffer)));
+                }
+                else {
+                    buffer = std::byteswap(buffer);
+                }
+            }
+        }
+
+        size_t GetSize() const noexcept
+        {
+            return m_Data.size();
+        }
+
+        size_t GetRemaining() const noexcept
+        {
+            return m_Data.size() - m_Position;
+        }
+
+        void Seek(std::ptrdiff_t pos, SeekOrigin origin = SeekOrigin::Begin) noexcept
+        {
+            using enum SeekOrigin;
+            std::ptrdiff_t base = 0;
+            switch (origin) {
+            case Begin:
+                base = 0;
+                break;
+            case Current:
+                base = static_cast<std::ptrdiff_t>(m_Position);
+                break;
+            case End:
+                base = static_cast<std::ptrdiff_t>(m_Data.size());
+                break;
+            }
+            m_Position = static_cast<size_t>(std::clamp<std::ptrdiff_t>(base + pos, 0, static_cast<std::ptrdiff_t>(m_Data.size())));
+        }
+
+        size_t GetCurrentPosition() const noexcept
+        {
+            return m_Position;
+        }
+
+        // 現在位置から末尾までの範囲 (読み進めはしない)
+        std::span<const uint8_t> GetRemainingData() const noexcept
+        {
+            return m_Data.subspan(m_Position);
+        }
+
+        bool isEOF() const noexcept
+        {
+            return m_Position >= m_Data.size();
+        }
+
+    private:
+        size_t copyTo(void* dst, size_t count) noexcept
+        {
+            const size_t size = std::min(count, GetRemaining());
+            if (size > 0) {
+                std::memcpy(dst, m_Data.data() + m_Position, size);
+            }
+            std::memset(static_cast<uint8_t*>(dst) + size, 0, count - size);
+            m_Position += size;
+            return size;
+        }
+
+    private:
+        std::span<const uint8_t> m_Data{};
+        size_t m_Position = 0;
+        bool m_IsByteSwap = true;
+    };
+} // namespace RagiMagick2::Common
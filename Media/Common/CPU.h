@@ -1,157 +1,233 @@
-﻿#pragma once
-#include <intrin.h>
-#include <string>
-#include <vector>
-
-namespace RagiMagick2::Common
-{
-    struct CPUID
-    {
-        int eax;
-        int ebx;
-        int ecx;
-        int edx;
-    };
-
-    enum class CPUFeature
-    {
-        // MMX
-        MMX = 0,
-        // SSE
-        SSE,
-        // SSE2
-        SSE2,
-        // SSE3
-        SSE3,
-        // SSSE3
-        SSSE3,
-        // SSE4.1
-        SSE41,
-        // SSE4.2
-        SSE42,
-        // AVX
-        AVX,
-        // AVX2
-        AVX2,
-        // AVX512 Foundation
-        AVX512F,
-        // AVX512 Doubleword and Quadword Instructions
-        AVX512DQ,
-        // AVX512 Integer Fused Multiply-Add Instructions
-        AVX512IFMA,
-        // AVX512 Prefetch Instructions
-        AVX512PF,
-        // AVX512 Exponential and Reciprocal Instructions
-        AVX512ER,
-        // AVX512 Conflict Detection Instructions
-        AVX512CD,
-        // AVX512 Byte and Word Instructions
-        AVX512BW,
-        // AVX512 Vector Length Extensions
-        AVX512VL,
-        // AVX512 Vector Bit Manipulation Instructions
-        AVX512VBMI,
-        // AVX512 Vector Bit Manipulation Instructions 2
-        AVX512VBMI2,
-        // AVX512 Vector Neural Network Instructions
-        AVX512VNNI,
-        // AVX512 Vector Bitwise Arithmetic Instructions
-        AVX512BITALG,
-        // AVX512 Vector Population Count Doubleword and Quadword Instructions
-        AVX512VPOPCNTDQ
-    };
-
-    inline CPUID cpuid(int leaf)
-    {
-        CPUID id{};
-        __cpuidex(reinterpret_cast<int*>(&id), leaf, 0);
-        return id;
-    }
-
-    inline std::string cpuVendorID()
-    {
-        auto leaf0 = cpuid(0);
-        char vendor[13] = {};
-        memcpy(vendor + 0, &leaf0.ebx, 4);
-        memcpy(vendor + 4, &leaf0.edx, 4);
-        memcpy(vendor + 8, &leaf0.ecx, 4);
-        return vendor;
-    }
-
-    inline std::vector<CPUFeature> cpuAavailableFeatures()
-    {
-        using enum RagiMagick2::Common::CPUFeature;
-        std::vector<CPUFeature> features;
-        auto leaf1 = cpuid(1);
-        auto leaf7 = cpuid(7);
-
-        if (leaf1.edx & (1 << 23)) {
-            features.emplace_back(MMX);
-        }
-        if (leaf1.edx & (1 << 25)) {
-            features.emplace_back(SSE);
-        }
-        if (leaf1.edx & (1 << 26)) {
-            features.emplace_back(SSE2);
-        }
-        if (leaf1.ecx & (1 << 0)) {
-            features.emplace_back(SSE3);
-        }
-        if (leaf1.ecx & (1 << 9)) {
-            features.emplace_back(SSSE3);
-        }
-        if (leaf1.ecx & (1 << 19)) {
-            features.emplace_back(SSE41);
-        }
-        if (leaf1.ecx & (1 << 20)) {
-            features.emplace_back(SSE42);
-        }
-        if (leaf1.ecx & (1 << 28)) {
-            features.emplace_back(AVX);
-        }
-        if (leaf7.ebx & (1 << 5)) {
-            features.emplace_back(AVX2);
-        }
-        if (leaf7.ebx & (1 << 16)) {
-            features.emplace_back(AVX512F);
-        }
-        if (leaf7.ebx & (1 << 17)) {
-            features.emplace_back(AVX512DQ);
-        }
-        if (leaf7.ebx & (1 << 21)) {
-            features.emplace_back(AVX512IFMA);
-        }
-        if (leaf7.ebx & (1 << 26)) {
-            features.emplace_back(AVX512PF);
-        }
-        if (leaf7.ebx & (1 << 27)) {
-            features.emplace_back(AVX512ER);
-        }
-        if (leaf7.ebx & (1 << 28)) {
-            features.emplace_back(AVX512CD);
-        }
-        if (leaf7.ebx & (1 << 30)) {
-            features.emplace_back(AVX512BW);
-        }
-        if (leaf7.ebx & (1 << 31)) {
-            features.emplace_back(AVX512VL);
-        }
-        if (leaf7.ecx & (1 << 1)) {
-            features.emplace_back(AVX512VBMI);
-        }
-        if (leaf7.ecx & (1 << 6)) {
-            features.emplace_back(AVX512VBMI2);
-        }
-        if (leaf7.ecx & (1 << 11)) {
-            features.emplace_back(AVX512VNNI);
-        }
-        if (leaf7.ecx & (1 << 12)) {
-            features.emplace_back(AVX512BITALG);
-        }
-        if (leaf7.ecx & (1 << 14)) {
-            features.emplace_back(AVX512VPOPCNTDQ);
-        }
-
-        return features;
-    }
-} // namespace RagiMagick2::Common
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace RagiMagick2::Common
+{
+    struct CPUID
+    {
+        int eax;
+        int ebx;
+        int ecx;
+        int edx;
+    };
+
+    enum class CPUFeature
+    {
+        // MMX
+        MMX = 0,
+        // SSE
+        SSE,
+        // SSE2
+        SSE2,
+        // SSE3
+        SSE3,
+        // SSSE3
+        SSSE3,
+        // SSE4.1
+        SSE41,
+        // SSE4.2
+        SSE42,
+        // AVX
+        AVX,
+        // AVX2
+        AVX2,
+        // AVX512 Foundation
+        AVX512F,
+        // AVX512 Doubleword and Quadword Instructions
+        AVX512DQ,
+        // AVX512 Integer Fused Multiply-Add Instructions
+        AVX512IFMA,
+        // AVX512 Prefetch Instructions
+        AVX512PF,
+        // AVX512 Exponential and Reciprocal Instructions
+        AVX512ER,
+        // AVX512 Conflict Detection Instructions
+        AVX512CD,
+        // AVX512 Byte and Word Instructions
+        AVX512BW,
+        // AVX512 Vector Length Extensions
+        AVX512VL,
+        // AVX512 Vector Bit Manipulation Instructions
+        AVX512VBMI,
+        // AVX512 Vector Bit Manipulation Instructions 2
+        AVX512VBMI2,
+        // AVX512 Vector Neural Network Instructions
+        AVX512VNNI,
+        // AVX512 Vector Bitwise Arithmetic Instructions
+        AVX512BITALG,
+        // AVX512 Vector Population Count Doubleword and Quadword Instructions
+        AVX512VPOPCNTDQ
+    };
+
+    // SIMD の実装を選ぶときの段階
+    // SSE2 は x64 の最低限の命令セットで、コンパイラの既定の設定でビルドしたスカラー版を使う
+    enum class SIMDLevel
+    {
+        SSE2 = 0,
+        AVX2,
+        // AVX512F, AVX512BW, AVX512DQ, AVX512VL の全て
+        AVX512,
+    };
+
+    inline CPUID cpuid(int leaf)
+    {
+        CPUID id{};
+#if defined(_MSC_VER)
+        __cpuidex(reinterpret_cast<int*>(&id), leaf, 0);
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        __cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+        id = { static_cast<int>(eax), static_cast<int>(ebx), static_cast<int>(ecx), static_cast<int>(edx) };
+#endif
+        return id;
+    }
+
+    // XCR0 (OS が保存・復元するレジスタの種類)
+    // CPU が AVX に対応していても、 OS が YMM / ZMM レジスタを保存しない場合は使えない
+    inline uint64_t xgetbv0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    inline std::string cpuVendorID()
+    {
+        auto leaf0 = cpuid(0);
+        char vendor[13] = {};
+        memcpy(vendor + 0, &leaf0.ebx, 4);
+        memcpy(vendor + 4, &leaf0.edx, 4);
+        memcpy(vendor + 8, &leaf0.ecx, 4);
+        return vendor;
+    }
+
+    inline std::vector<CPUFeature> cpuAavailableFeatures()
+    {
+        using enum RagiMagick2::Common::CPUFeature;
+        std::vector<CPUFeature> features;
+        const int maxLeaf = cpuid(0).eax;
+        auto leaf1 = cpuid(1);
+        auto leaf7 = maxLeaf >= 7 ? cpuid(7) : CPUID{};
+
+        // OSXSAVE が立っている場合だけ XCR0 を読める
+        // AVX 以降は XMM, YMM (ビット 1, 2) を、 AVX-512 はさらに opmask, ZMM (ビット 5～7) を OS が保存する場合だけ有効とする
+        const uint64_t xcr0 = (leaf1.ecx & (1 << 27)) ? xgetbv0() : 0;
+        const bool isAVXEnabled = (xcr0 & 0x06) == 0x06;
+        const bool isAVX512Enabled = (xcr0 & 0xE6) == 0xE6;
+        if (!isAVXEnabled) {
+            leaf1.ecx &= ~(1 << 28);
+            leaf7.ebx &= (1 << 3) | (1 << 8);   // BMI1, BMI2 以外のビットは AVX 以降の拡張
+            leaf7.ecx = 0;
+        }
+        else if (!isAVX512Enabled) {
+            leaf7.ebx &= ~static_cast<int>(0xDC230000u);  // AVX512F, DQ, IFMA, PF, ER, CD, BW, VL
+            leaf7.ecx &= ~((1 << 1) | (1 << 6) | (1 << 11) | (1 << 12) | (1 << 14));
+        }
+
+        if (leaf1.edx & (1 << 23)) {
+            features.emplace_back(MMX);
+        }
+        if (leaf1.edx & (1 << 25)) {
+            features.emplace_back(SSE);
+        }
+        if (leaf1.edx & (1 << 26)) {
+            features.emplace_back(SSE2);
+        }
+        if (leaf1.ecx & (1 << 0)) {
+            features.emplace_back(SSE3);
+        }
+        if (leaf1.ecx & (1 << 9)) {
+            features.emplace_back(SSSE3);
+        }
+        if (leaf1.ecx & (1 << 19)) {
+            features.emplace_back(SSE41);
+        }
+        if (leaf1.ecx & (1 << 20)) {
+            features.emplace_back(SSE42);
+        }
+        if (leaf1.ecx & (1 << 28)) {
+            features.emplace_back(AVX);
+        }
+        if (leaf7.ebx & (1 << 5)) {
+            features.emplace_back(AVX2);
+        }
+        if (leaf7.ebx & (1 << 16)) {
+            features.emplace_back(AVX512F);
+        }
+        if (leaf7.ebx & (1 << 17)) {
+            features.emplace_back(AVX512DQ);
+        }
+        if (leaf7.ebx & (1 << 21)) {
+            features.emplace_back(AVX512IFMA);
+        }
+        if (leaf7.ebx & (1 << 26)) {
+            features.emplace_back(AVX512PF);
+        }
+        if (leaf7.ebx & (1 << 27)) {
+            features.emplace_back(AVX512ER);
+        }
+        if (leaf7.ebx & (1 << 28)) {
+            features.emplace_back(AVX512CD);
+        }
+        if (leaf7.ebx & (1 << 30)) {
+            features.emplace_back(AVX512BW);
+        }
+        if (leaf7.ebx & (1 << 31)) {
+            features.emplace_back(AVX512VL);
+        }
+        if (leaf7.ecx & (1 << 1)) {
+            features.emplace_back(AVX512VBMI);
+        }
+        if (leaf7.ecx & (1 << 6)) {
+            features.emplace_back(AVX512VBMI2);
+        }
+        if (leaf7.ecx & (1 << 11)) {
+            features.emplace_back(AVX512VNNI);
+        }
+        if (leaf7.ecx & (1 << 12)) {
+            features.emplace_back(AVX512BITALG);
+        }
+        if (leaf7.ecx & (1 << 14)) {
+            features.emplace_back(AVX512VPOPCNTDQ);
+        }
+
+        return features;
+    }
+
+    // 起動後に1度だけ調べた結果を使う
+    inline bool hasCPUFeature(CPUFeature feature)
+    {
+        static const std::vector<CPUFeature> features = cpuAavailableFeatures();
+        return std::ranges::contains(features, feature);
+    }
+
+    // この CPU で使える SIMD の段階 (起動後に1度だけ決める)
+    inline SIMDLevel getSIMDLevel()
+    {
+        static const SIMDLevel level = [] {
+            using enum RagiMagick2::Common::CPUFeature;
+            if (hasCPUFeature(AVX512F) && hasCPUFeature(AVX512BW) && hasCPUFeature(AVX512DQ) && hasCPUFeature(AVX512VL)) {
+                return SIMDLevel::AVX512;
+            }
+            if (hasCPUFeature(AVX2)) {
+                return SIMDLevel::AVX2;
+            }
+            return SIMDLevel::SSE2;
+        }();
+        return level;
+    }
+} // namespace RagiMagick2::Common
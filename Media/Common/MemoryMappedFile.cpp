@@ -0,0 +1,99 @@
+﻿#include "MemoryMappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RagiMagick2::Common
+{
+    bool MemoryMappedFile::open() noexcept
+    {
+        if (m_Data != nullptr) {
+            return true;
+        }
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(m_Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        m_File = file;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        m_Size = static_cast<size_t>(size.QuadPart);
+
+        m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_Mapping == nullptr) {
+            close();
+            return false;
+        }
+
+        m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_Data == nullptr) {
+            close();
+            return false;
+        }
+#else
+        m_File = ::open(m_Filename.c_str(), O_RDONLY);
+        if (m_File < 0) {
+            return false;
+        }
+
+        struct stat st{};
+        if (fstat(m_File, &st) != 0 || st.st_size == 0) {
+            close();
+            return false;
+        }
+        m_Size = static_cast<size_t>(st.st_size);
+
+        void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+        if (data == MAP_FAILED) {
+            close();
+            return false;
+        }
+        m_Data = static_cast<const uint8_t*>(data);
+#endif
+        return true;
+    }
+
+    void MemoryMappedFile::close() noexcept
+    {
+#ifdef _WIN32
+        if (m_Data != nullptr) {
+            UnmapViewOfFile(m_Data);
+        }
+        if (m_Mapping != nullptr) {
+            CloseHandle(m_Mapping);
+        }
+        if (m_File != nullptr) {
+            CloseHandle(m_File);
+        }
+        m_Mapping = nullptr;
+        m_File = nullptr;
+#else
+        if (m_Data != nullptr) {
+            munmap(const_cast<uint8_t*>(m_Data), m_Size);
+        }
+        if (m_File >= 0) {
+            ::close(m_File);
+        }
+        m_File = -1;
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+} // namespace RagiMagick2::Common
@@ -0,0 +1,53 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace RagiMagick2::Common
+{
+    // ファイル全体を読み取り専用でメモリにマップする
+    // GetData() で返すメモリは、このオブジェクトが破棄されるか close() するまで有効
+    class MemoryMappedFile final
+    {
+    public:
+        MemoryMappedFile(std::string_view filename) noexcept
+            : m_Filename(filename)
+        {
+        }
+
+        ~MemoryMappedFile()
+        {
+            close();
+        }
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        bool open() noexcept;
+        void close() noexcept;
+
+        std::span<const uint8_t> GetData() const noexcept
+        {
+            return { m_Data, m_Size };
+        }
+
+        size_t GetSize() const noexcept
+        {
+            return m_Size;
+        }
+
+    private:
+        std::string m_Filename;
+#ifdef _WIN32
+        // HANDLE (Windows.h をヘッダで include しないように void* で持つ、開いていなければ nullptr)
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#else
+        int m_File = -1;
+#endif
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+    };
+} // namespace RagiMagick2::Common
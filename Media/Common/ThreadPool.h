@@ -0,0 +1,127 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <queue>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace RagiMagick2::Common
+{
+    class ThreadPool final
+    {
+    public:
+        explicit ThreadPool(size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u))
+        {
+            m_Workers.reserve(threadCount);
+            for (size_t i = 0; i < threadCount; ++i) {
+                m_Workers.emplace_back([this](std::stop_token stopToken) { workerLoop(stopToken); });
+            }
+        }
+
+        // std::jthread のデストラクタで停止要求と join が行われる
+        ~ThreadPool() = default;
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // プロセス全体で共有するプール
+        static ThreadPool& shared()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        size_t size() const noexcept
+        {
+            return m_Workers.size();
+        }
+
+        // 呼び出し元のスレッドがこのプールのワーカーか
+        bool isWorkerThread() const noexcept
+        {
+            return s_CurrentPool == this;
+        }
+
+        // ワーカーで実行中のタスクから enqueue する場合、そのタスクの中で完了を待たないこと
+        // 全てのワーカーが待ちになると、キューのタスクを実行するスレッドが無くなる
+        void enqueue(std::function<void()> task)
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+                m_Tasks.push(std::move(task));
+            }
+            m_Condition.notify_one();
+        }
+
+        // func(0) ～ func(count - 1) を並列に実行し、全て終わるまで待つ
+        // 呼び出し元のスレッドも処理に加わる
+        // ワーカーから呼ばれた場合 (func の中からの呼び出しを含む) は、呼び出し元のスレッドだけで順に実行する
+        template <typename F>
+        void parallelFor(size_t count, F&& func)
+        {
+            if (count == 0) {
+                return;
+            }
+            if (isWorkerThread()) {
+                for (size_t i = 0; i < count; ++i) {
+                    func(i);
+                }
+                return;
+            }
+
+            std::atomic<size_t> next = 0;
+            auto run = [&] {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    func(i);
+                }
+            };
+
+            size_t helperCount = std::min(count - 1, m_Workers.size());
+            std::latch done(static_cast<std::ptrdiff_t>(helperCount));
+            for (size_t i = 0; i < helperCount; ++i) {
+                enqueue([&] {
+                    run();
+                    done.count_down();
+                });
+            }
+
+            run();
+            done.wait();
+        }
+
+    private:
+        void workerLoop(std::stop_token stopToken)
+        {
+            s_CurrentPool = this;
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(m_Mutex);
+                    m_Condition.wait(lock, stopToken, [&] { return !m_Tasks.empty(); });
+                    if (m_Tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(m_Tasks.front());
+                    m_Tasks.pop();
+                }
+                task();
+            }
+        }
+
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable_any m_Condition;
+        std::queue<std::function<void()>> m_Tasks;
+        std::vector<std::jthread> m_Workers;
+
+        // ワーカーのスレッドでは、そのワーカーのプール
+        static inline thread_local const ThreadPool* s_CurrentPool = nullptr;
+    };
+} // namespace RagiMagick2::Common
@@ -1,37 +1,37 @@
-﻿#include "BinaryFilter.h"
-#include <cassert>
-#include <cstdint>
-#include <vector>
-#include "IImageFilter.h"
-
-namespace
-{
-    constexpr uint8_t THRESHOLD = 128;
-}
-
-namespace RagiMagick2::Image::Filter
-{
-    ImageInfo BinaryFilter::apply(const ImageInfo& src) noexcept
-    {
-        assert(src.componentCount >= 3);
-
-        ImageInfo dst{};
-        dst.width = src.width;
-        dst.height = src.height;
-        dst.componentCount = src.componentCount;
-        dst.pixels.resize(src.pixels.size());
-
-        for (size_t i = 0; i < src.pixels.size(); i += src.componentCount) {
-            uint8_t r = src.pixels[i + 0];
-            uint8_t g = src.pixels[i + 1];
-            uint8_t b = src.pixels[i + 2];
-            uint8_t gray = (r + g + b) / 3;
-            uint8_t binary = gray > THRESHOLD ? 255 : 0;
-            dst.pixels[i + 0] = binary;
-            dst.pixels[i + 1] = binary;
-            dst.pixels[i + 2] = binary;
-        }
-
-        return dst;
-    }
-} // namespace RagiMagick2::Image::Filter
+﻿#include "BinaryFilter.h"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "IImageFilter.h"
+
+namespace
+{
+    constexpr uint8_t THRESHOLD = 128;
+}
+
+namespace RagiMagick2::Image::Filter
+{
+    ImageInfo BinaryFilter::apply(const ImageInfo& src) noexcept
+    {
+        assert(src.componentCount >= 3);
+
+        ImageInfo dst{};
+        dst.width = src.width;
+        dst.height = src.height;
+        dst.componentCount = src.componentCount;
+        dst.pixels.resize(src.pixels.size());
+
+        for (size_t i = 0; i < src.pixels.size(); i += src.componentCount) {
+            uint8_t r = src.pixels[i + 0];
+            uint8_t g = src.pixels[i + 1];
+            uint8_t b = src.pixels[i + 2];
+            uint8_t gray = (r + g + b) / 3;
+            uint8_t binary = gray > THRESHOLD ? 255 : 0;
+            dst.pixels[i + 0] = binary;
+            dst.pixels[i + 1] = binary;
+            dst.pixels[i + 2] = binary;
+        }
+
+        return dst;
+    }
+} // namespace RagiMagick2::Image::Filter
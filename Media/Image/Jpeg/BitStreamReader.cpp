@@ -1,70 +1,111 @@
-﻿#include "BitStreamReader.h"
-#include <cstdint>
-
-namespace RagiMagick2::Image::Jpeg
-{
-    // Figure F.17 - Procedure for RECEIVE(SSSS)
-    int BitStreamReader::receive(int ssss)
-    {
-        int v = 0;
-        for (int i = 0; i < ssss; ++i) {
-            v = (v << 1) + nextBit();
-        }
-        return v;
-    }
-
-    // Figure F.18 – Procedure for fetching the next bit of compressed data
-    uint8_t BitStreamReader::nextBit()
-    {
-        if (m_ReadBitCount == 0) {
-            if (m_DataIndex >= m_StreamLastIndex) {
-                return 0;
-            }
-            m_CurrentByte = m_Stream[++m_DataIndex];
-            if (m_CurrentByte == 0xFF) {
-                uint8_t byte = m_Stream[++m_DataIndex];
-                // DNL マーカーの暫定対応
-                // あまり使用されないらしい。とりあえず2バイトスキップしておく。
-                if (byte == 0xDC) {
-                    //std::println("* DNL");
-                    nextByte();
-                    nextByte();
-                }
-                // RST マーカー
-                // デコーダー側で処理するから、ここでは何もしない。
-                // デコーダー側で処理されなかったら、ここでログが記録される。
-                else if (byte >= 0xD0 && byte <= 0xD7) {
-                    //std::println("* RST{}", byte - 0xD0);
-                }
-                // マーカーの後に 0x00 が続く場合はスキップ
-                else if (byte == 0x00) {
-                    // 何もしない
-                }
-                else {
-                    //std::println("Unknown marker: 0xFF{:02X}", byte);
-                }
-            }
-            m_ReadBitCount = 8;
-        }
-
-        uint8_t bit = (m_CurrentByte & 0x80) ? 1 : 0;
-        m_ReadBitCount--;
-        m_CurrentByte <<= 1;
-
-        return bit;
-    }
-
-    uint8_t BitStreamReader::nextByte()
-    {
-        m_ReadBitCount = 0;
-
-        if (m_DataIndex < m_StreamLastIndex) {
-            m_CurrentByte = m_Stream[++m_DataIndex];
-        }
-        else {
-            m_CurrentByte = 0;
-        }
-
-        return m_CurrentByte;
-    }
-} // namespace RagiMagick2::Image::Jpeg
+﻿#include "BitStreamReader.h"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    // 8バイトの中に 0xFF が含まれているか
+    constexpr bool hasFFByte(uint64_t word) noexcept
+    {
+        uint64_t inverted = ~word;
+        return ((inverted - 0x0101010101010101ull) & ~inverted & 0x8080808080808080ull) != 0;
+    }
+    static_assert(hasFFByte(0x00000000000000FFull));
+    static_assert(hasFFByte(0xFF00000000000000ull));
+    static_assert(!hasFFByte(0xFEFEFEFEFEFEFEFEull));
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    uint8_t BitStreamReader::readMarker()
+    {
+        // 末尾やマーカーを越えて読み捨てた分 (0 埋め) はなかったことにする
+        if (m_BitCount < 0) {
+            m_IsCorrupted = true;
+            m_BitCount = 0;
+        }
+
+        // 読みかけのバイトの残り (パディングの 1) を捨てる
+        skipBits(m_BitCount % 8);
+        if (m_BitCount > 0) {
+            // まだデータが残っているので、マーカーの位置ではない
+            return 0;
+        }
+
+        // B.1.1.2 マーカーの前には 0xFF の fill byte が任意の数だけ置かれることがある
+        while (m_Position + 2 < m_Stream.size() && m_Stream[m_Position] == 0xFF && m_Stream[m_Position + 1] == 0xFF) {
+            ++m_Position;
+        }
+
+        if (m_Position + 1 >= m_Stream.size() || m_Stream[m_Position] != 0xFF || m_Stream[m_Position + 1] == 0x00) {
+            return 0;
+        }
+
+        uint8_t marker = m_Stream[m_Position + 1];
+        m_Position += 2;
+        m_IsMarkerReached = false;
+        return marker;
+    }
+
+    bool BitStreamReader::isEndReached() const noexcept
+    {
+        if (m_BitCount >= 8) {
+            return false;
+        }
+        for (size_t i = m_Position; i < m_Stream.size(); ++i) {
+            if (m_Stream[i] != 0xFF) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void BitStreamReader::fill()
+    {
+        // 足りない分は 0 埋めで読み捨てられているので、壊れたデータとして覚えておく
+        if (m_BitCount < 0) {
+            m_IsCorrupted = true;
+            m_BitCount = 0;
+        }
+
+        // 8バイト先まで 0xFF が無ければ、スタッフィングもマーカーも無いのでまとめて読み込む
+        if (!m_IsMarkerReached && m_Position + 8 <= m_Stream.size()) {
+            uint64_t word = 0;
+            std::memcpy(&word, &m_Stream[m_Position], sizeof(word));
+
+            if (!hasFFByte(word)) {
+                word = std::byteswap(word);
+
+                int bytes = (63 - m_BitCount) / 8;
+                int total = m_BitCount + bytes * 8;
+                uint64_t mask = ~((1ull << (64 - total)) - 1);
+
+                m_BitBuffer |= (word >> m_BitCount) & mask;
+                m_BitCount = total;
+                m_Position += bytes;
+                return;
+            }
+        }
+
+        // 1バイトずつ、スタッフィングを取り除きながら読み込む
+        while (m_BitCount <= 56 && !m_IsMarkerReached && m_Position < m_Stream.size()) {
+            uint8_t byte = m_Stream[m_Position];
+            if (byte == 0xFF) {
+                // 0xFF の後に 0x00 が続く場合はスタッフィングなのでスキップ
+                // それ以外 (RST, DNL, EOI など) はマーカーなので、ここでは読まずに readMarker() に任せる
+                if (m_Position + 1 >= m_Stream.size() || m_Stream[m_Position + 1] != 0x00) {
+                    m_IsMarkerReached = true;
+                    break;
+                }
+                m_Position += 2;
+            }
+            else {
+                m_Position += 1;
+            }
+
+            m_BitBuffer |= static_cast<uint64_t>(byte) << (56 - m_BitCount);
+            m_BitCount += 8;
+        }
+    }
+} // namespace RagiMagick2::Image::Jpeg
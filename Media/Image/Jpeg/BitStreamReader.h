@@ -1,37 +1,110 @@
-﻿#pragma once
-#include <cstdint>
-#include <vector>
-
-namespace RagiMagick2::Image::Jpeg
-{
-    class BitStreamReader
-    {
-    public:
-        BitStreamReader(const std::vector<uint8_t>& stream)
-            : m_Stream(stream)
-            , m_StreamSize(stream.size())
-            , m_StreamLastIndex(stream.size() - 1)
-        {
-        }
-
-        ~BitStreamReader() = default;
-
-        int receive(int ssss);
-        uint8_t nextBit();
-        uint8_t nextByte();
-
-        inline bool hasMore() const noexcept
-        {
-            return m_DataIndex < m_StreamLastIndex;
-        }
-
-    private:
-        std::vector<uint8_t> m_Stream;
-        uint8_t m_CurrentByte = 0;
-        int m_DataIndex = 0;
-        int m_ReadBitCount = 0;
-        const size_t m_StreamSize;
-        const size_t m_StreamLastIndex;
-    };
-
-} // namespace RagiMagick2::Image::Jpeg
+﻿#pragma once
+#include <cstdint>
+#include <span>
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // エントロピー符号化データ (ECS) を MSB から順に読むビットリーダー
+    // 64ビットのバッファにまとめて読み込み、0xFF00 のスタッフィングは読み込み時に取り除く。
+    // マーカー (RSTn, DNL など) の手前で読み込みを止めるので、マーカーは readMarker() で読む。
+    class BitStreamReader
+    {
+    public:
+        // stream はこのインスタンスより長く生存していること (コピーしない)
+        explicit BitStreamReader(std::span<const uint8_t> stream) noexcept
+            : m_Stream(stream)
+        {
+        }
+
+        ~BitStreamReader() = default;
+
+        // 先頭から n ビット (1 <= n <= 32) を消費せずに返す
+        // マーカーやストリーム末尾に達して足りない分は 0 で埋められる
+        inline uint32_t peekBits(int n)
+        {
+            if (m_BitCount < n) {
+                fill();
+            }
+            return static_cast<uint32_t>(m_BitBuffer >> (64 - n));
+        }
+
+        // peekBits で確認したビットを読み捨てる
+        inline void skipBits(int n) noexcept
+        {
+            m_BitBuffer <<= n;
+            m_BitCount -= n;
+        }
+
+        // n ビット (0 <= n <= 32) 読む
+        inline uint32_t getBits(int n)
+        {
+            if (n == 0) {
+                return 0;
+            }
+            uint32_t v = peekBits(n);
+            skipBits(n);
+            return v;
+        }
+
+        // Figure F.17 - Procedure for RECEIVE(SSSS)
+        inline int receive(int ssss)
+        {
+            return static_cast<int>(getBits(ssss));
+        }
+
+        // Figure F.18 – Procedure for fetching the next bit of compressed data
+        inline uint8_t nextBit()
+        {
+            return static_cast<uint8_t>(getBits(1));
+        }
+
+        // 読みかけのバイトの残りを捨てて、マーカーを読む
+        // 現在位置がマーカーでなければ何も読まずに 0 を返す
+        uint8_t readMarker();
+
+        // 読み込みがマーカーの手前で止まっている
+        inline bool isMarkerReached() const noexcept
+        {
+            return m_IsMarkerReached;
+        }
+
+        inline bool hasMore() const noexcept
+        {
+            return m_BitCount > 0 || m_Position < m_Stream.size();
+        }
+
+        // 読みかけのバイトの残り (パディング) と、マーカーの前の fill byte (0xFF) 以外に読んでいないデータが無い
+        // リスタート区間ごとに切り出したデータを、ちょうど最後まで復号できたかを確かめる
+        bool isEndReached() const noexcept;
+
+        // 壊れたデータを読んだ (マーカーやストリーム末尾を越えて読んだか、 setCorrupted() が呼ばれた)
+        // 正しいデータならマーカーの手前の 0 埋めを読むことは無いので、越えて読んだ時点で壊れている
+        inline bool isCorrupted() const noexcept
+        {
+            return m_IsCorrupted || m_BitCount < 0;
+        }
+
+        // どの符号にも一致しないなど、復号する側で壊れたデータを見つけた場合に呼ぶ
+        inline void setCorrupted() noexcept
+        {
+            m_IsCorrupted = true;
+        }
+
+    private:
+        void fill();
+
+    private:
+        std::span<const uint8_t> m_Stream;
+        // 次に読み込むバイトの位置
+        size_t m_Position = 0;
+        // MSB 側から詰めたビットバッファ (未読ビット以外は常に 0)
+        uint64_t m_BitBuffer = 0;
+        // m_BitBuffer 内の未読ビット数
+        int m_BitCount = 0;
+        // マーカーの手前で fill を止めている
+        bool m_IsMarkerReached = false;
+        // 壊れたデータを読んだ
+        bool m_IsCorrupted = false;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,55 @@
+﻿#include "BitStreamWriter.h"
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+namespace RagiMagick2::Image::Jpeg
+{
+    void BitStreamWriter::flush()
+    {
+        const int padding = (8 - m_BitCount % 8) % 8;
+        if (padding > 0) {
+            putBits(0xFF, padding);
+        }
+        drain();
+    }
+
+    void BitStreamWriter::writeMarker(uint8_t marker)
+    {
+        flush();
+        m_Output.push_back(0xFF);
+        m_Output.push_back(marker);
+    }
+
+    void BitStreamWriter::writeByte(uint8_t value)
+    {
+        assert(m_BitCount == 0);
+        m_Output.push_back(value);
+    }
+
+    void BitStreamWriter::writeWord(uint16_t value)
+    {
+        assert(m_BitCount == 0);
+        m_Output.push_back(static_cast<uint8_t>(value >> 8));
+        m_Output.push_back(static_cast<uint8_t>(value));
+    }
+
+    void BitStreamWriter::writeBytes(std::span<const uint8_t> bytes)
+    {
+        assert(m_BitCount == 0);
+        m_Output.insert(m_Output.end(), bytes.begin(), bytes.end());
+    }
+
+    void BitStreamWriter::drain()
+    {
+        while (m_BitCount >= 8) {
+            m_BitCount -= 8;
+            const uint8_t byte = static_cast<uint8_t>(m_BitBuffer >> m_BitCount);
+            m_Output.push_back(byte);
+            if (byte == 0xFF) {
+                m_Output.push_back(0x00);
+            }
+        }
+        m_BitBuffer &= (uint64_t{ 1 } << m_BitCount) - 1;
+    }
+} // namespace RagiMagick2::Image::Jpeg
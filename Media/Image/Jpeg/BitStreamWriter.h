@@ -0,0 +1,56 @@
+﻿#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // エントロピー符号化データ (ECS) を MSB から順に書き込むビットライター (BitStreamReader の逆)
+    // 64ビットのバッファに溜めて、4バイトずつ output に書き出す。
+    // 0xFF のバイトの後ろには 0x00 を挿入する (B.1.1.5 のスタッフィング)
+    // マーカーセグメントの書き込みは、ビットを全て書き出した後 (flush した後) に行うこと
+    class BitStreamWriter
+    {
+    public:
+        // output はこのインスタンスより長く生存していること (末尾に追記する)
+        explicit BitStreamWriter(std::vector<uint8_t>& output) noexcept
+            : m_Output(output)
+        {
+        }
+
+        ~BitStreamWriter() = default;
+
+        // code の下位 length ビット (0 <= length <= 24) を書き込む
+        inline void putBits(uint32_t code, int length)
+        {
+            m_BitBuffer = (m_BitBuffer << length) | (code & ((1u << length) - 1));
+            m_BitCount += length;
+            if (m_BitCount >= 32) {
+                drain();
+            }
+        }
+
+        // 書きかけのバイトの残りを 1 で埋めて (F.1.2.3)、全て output に書き出す
+        void flush();
+
+        // flush してからマーカー (0xFF, marker) を書き込む
+        void writeMarker(uint8_t marker);
+
+        // マーカーセグメントの中身を書き込む (スタッフィングしない)
+        void writeByte(uint8_t value);
+        // ビッグエンディアンで書き込む
+        void writeWord(uint16_t value);
+        void writeBytes(std::span<const uint8_t> bytes);
+
+    private:
+        // 8ビット単位で書き出せる分を、スタッフィングしながら output に書き出す
+        void drain();
+
+    private:
+        std::vector<uint8_t>& m_Output;
+        // LSB 側に詰めたビットバッファ (下位 m_BitCount ビットが未出力)
+        uint64_t m_BitBuffer = 0;
+        int m_BitCount = 0;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -1,395 +1,2029 @@
-﻿#include "JpegDecoder.h"
-#include <immintrin.h>
-#include <array>
-#include <cassert>
-#include <cstdint>
-#include <memory>
-#include <print>
-#include <span>
-#include <string_view>
-#include <tuple>
-#include <utility>
-#include <variant>
-#include <vector>
-//#include <nameof.hpp>
-#include "Common.h"
-#include "Utility.h"
-#include "YCbCrComponents.h"
-#include "Image/Pixel/PixelFormat.h"
-#include "Image/Pixel/PixelFormatConverters.h"
-#include "Image/Jpeg/BitStreamReader.h"
-#include "Image/Jpeg/Syntax/Segment.h"
-#include "Image/Math/Math.h"
-
-using namespace RagiMagick2::Image::Pixel;
-
-namespace
-{
-    using namespace RagiMagick2::Image::Jpeg;
-    using namespace RagiMagick2::Image::Jpeg::Syntax;
-
-    // Figure F.12 – Extending the sign bit of a decoded value in V
-    constexpr int extend(int v, int t)
-    {
-        int vt = 1 << (t - 1);
-        if (v < vt) {
-            vt = (-1 << t) + 1;
-            v += vt;
-        }
-        return v;
-    }
-
-    inline void dequantize(MCUBlock8x8& block, const DQT& dqt)
-    {
-        if (dqt.precision == DQT::Precision::BITS_8) {
-            auto& table = std::get<DQT::Bits8Table>(dqt.table);
-
-            std::array<int16_t, 64> tmp{};
-
-            // uint8_t[] to int16_t[]
-            for (size_t i = 0; i < 64; i += 16) {
-                __m128i tbl = _mm_load_si128(reinterpret_cast<const __m128i*>(&table[i]));
-                __m256i tbl2 = _mm256_cvtepu8_epi16(tbl);
-                _mm256_store_si256(reinterpret_cast<__m256i*>(&tmp[i]), tbl2);
-            }
-
-            for (size_t i = 0; i < block.size(); i += 16) {
-                __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(&block[i]));
-                __m256i t = _mm256_load_si256(reinterpret_cast<const __m256i*>(&tmp[i]));
-                b = _mm256_mullo_epi16(b, t);
-                _mm256_store_si256(reinterpret_cast<__m256i*>(&block[i]), b);
-            }
-        }
-        else if (dqt.precision == DQT::Precision::BITS_16) {
-            auto& table = std::get<DQT::Bits16Table>(dqt.table);
-            for (size_t i = 0; i < block.size(); ++i) {
-                block[i] *= table[i];
-            }
-        }
-    }
-
-    inline void reorder(MCUBlock8x8& block)
-    {
-        alignas(32) std::array<int32_t, 64> tmp{};
-        alignas(32) std::array<int32_t, 64> reordered{};
-
-        // int16_t[] to int32_t[]
-#pragma omp simd
-        for (size_t i = 0; i < block.size(); i++) {
-            tmp[i] = block[i];
-        }
-
-        // reorder
-        for (size_t i = 0; i < tmp.size(); i += 8) {
-            __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(&ZIGZAG[i]));
-            __m256i gathered = _mm256_i32gather_epi32(tmp.data(), idx, sizeof(int32_t));
-            _mm256_store_si256(reinterpret_cast<__m256i*>(&reordered[i]), gathered);
-        }
-
-        // int32_t[] to int16_t[]
-#pragma omp simd
-        for (size_t i = 0; i < reordered.size(); i++) {
-            block[i] = static_cast<int16_t>(reordered[i]);
-        }
-    }
-
-    inline void levelShift(MCUBlock8x8& block)
-    {
-        for (int i = 0; i < block.size(); i += 16) {
-            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(&block[i]));
-            v = _mm256_add_epi16(v, _mm256_set1_epi16(128));
-            _mm256_store_si256(reinterpret_cast<__m256i*>(&block[i]), v);
-        }
-    }
-}
-
-namespace RagiMagick2::Image::Jpeg
-{
-    JpegDecoder::JpegDecoder(std::string_view fileName)
-        : m_Parser(fileName)
-    {
-    }
-
-    JpegDecoder::~JpegDecoder()
-    {
-    }
-
-    void JpegDecoder::decode(DecodeResult& result)
-    {
-        m_Parser.parse();
-
-        //debugging::dumpSummary(m_Parser.getMarkers(), m_Parser.getSegments());
-
-        // 必須セグメント
-        auto sos = findFirstSegment<SOS>(m_Parser.getSegments());
-        assert(sos);
-        auto dhts = findSegments<DHT>(m_Parser.getSegments());
-        assert(!dhts.empty());
-        auto sof0 = findFirstSegment<SOF0>(m_Parser.getSegments());
-        assert(sof0);
-        auto dqts = findSegments<DQT>(m_Parser.getSegments());
-        assert(!dqts.empty());
-
-        // 省略可能なセグメント
-        auto dri = findFirstSegment<DRI>(m_Parser.getSegments());
-
-        if (auto colorSpace = getColorSpace(*sof0); colorSpace != ColorSpace::YCbCr) {
-            //std::println("Unsupported color space: {}", NAMEOF_ENUM(colorSpace));
-            return;
-        }
-
-        if (auto format = getYUVFormat(*sof0); format != YUVFormat::YUV420 && format != YUVFormat::YUV444) {
-            //std::println("Unsupported YUV format: {}", NAMEOF_ENUM(format));
-            return;
-        }
-
-        m_BitStreamReader = std::make_unique<BitStreamReader>(m_Parser.getECS());
-        using TableInfo = std::tuple<HuffmanTable, std::shared_ptr<DHT>>;
-        std::array<TableInfo, 4> dcTables{};
-        std::array<TableInfo, 4> acTables{};
-
-        for (const auto& dht : dhts) {
-            auto huffmanTable = createHuffmanTable(dht->counts);
-
-            if (dht->tableClass == Syntax::DHT::TableClass::DC_OR_LOSSLESS) {
-                dcTables[std::to_underlying(dht->tableID)] = { huffmanTable, dht };
-            }
-            else {
-                acTables[std::to_underlying(dht->tableID)] = { huffmanTable, dht };
-            }
-        }
-
-        YCbCrComponents ycc(*sof0);
-        std::println("MCU: {}x{}", ycc.getMCUHorizontalCount(), ycc.getMCUVerticalCount());
-
-        // ファイル全体を通して更新し続ける
-        std::array<int, 3> dcPred = { 0, 0, 0 };
-
-        int mcuCount = 0;
-
-        for (size_t mcuRow = 0; mcuRow < ycc.getMCUVerticalCount(); ++mcuRow) {
-            for (size_t mcuCol = 0; mcuCol < ycc.getMCUHorizontalCount(); ++mcuCol) {
-                ++mcuCount;
-
-                if (!m_BitStreamReader->hasMore()) {
-                    break;
-                }
-
-                // DRI で指定された間隔でリスタートマーカーがある場合、 dcPred をリセット
-                if (dri && mcuCount % dri->restartInterval == 0) {
-                    if (m_BitStreamReader->nextByte() != 0xFF) {
-                        std::println("Restart marker not found");
-                        return;
-                    }
-                    uint8_t marker = m_BitStreamReader->nextByte();
-                    if (marker < 0xD0 || marker > 0xD7) {
-                        std::println("Invalid restart marker: 0xFF{:02X}", marker);
-                        return;
-                    }
-                    dcPred = { 0, 0, 0 };
-                }
-
-                for (auto&& component : sof0->components) {
-                    auto componentIndex = std::distance(sof0->components.data(), &component);
-                    auto& [dcTable, dcDHT] = dcTables[std::to_underlying(component.tableID)];
-                    auto& [acTable, acDHT] = acTables[std::to_underlying(component.tableID)];
-                    auto& dqt = dqts[std::to_underlying(component.tableID)];
-                    auto& buf = ycc.getComponent(component.id).buffer;
-                    int width = ycc.getComponent(component.id).width;
-
-                    // 4:4:4 の場合、1 MCU Y  8 x  8, Cb 8 x 8, Cr 8 x 8 で処理
-                    // 4:2:0 の場合、1 MCU Y 16 x 16, Cb 8 x 8, Cr 8 x 8 となるため、Y は 2 ブロック分の処理が必要
-
-                    for (size_t blockRow = 0; blockRow < component.verticalSamplingFactor; ++blockRow) {
-                        for (size_t blockCol = 0; blockCol < component.horizonalSamplingFactor; ++blockCol) {
-                            size_t dstBlockX = (mcuCol * component.horizonalSamplingFactor + blockCol) * 8;
-                            size_t dstBlockY = (mcuRow * component.verticalSamplingFactor + blockRow) * 8;
-
-                            alignas(32) MCUBlock8x8 block {};
-                            decodeBlock(dcTable, dcDHT, acTable, acDHT, dqt, block, dcPred[componentIndex]);
-
-                            for (size_t y = 0; y < 8; ++y) {
-                                size_t offset = (dstBlockY + y) * width + dstBlockX;
-                                __m128i data = _mm_load_si128(reinterpret_cast<const __m128i*>(&block[y * 8]));
-                                _mm_storeu_si128(reinterpret_cast<__m128i*>(&buf[offset]), data);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        std::vector<uint8_t> pixels(sof0->width * sof0->height * 4, 0);
-
-        if (getYUVFormat(*sof0) == YUVFormat::YUV420) {
-            convertYCbCrToBGRA32<PixelFormat::YCBCR420_UINT>(
-                sof0->width, sof0->height, pixels,
-                std::span{ ycc.getComponent(ComponentID::Y).buffer },
-                std::span{ ycc.getComponent(ComponentID::Cb).buffer },
-                std::span{ ycc.getComponent(ComponentID::Cr).buffer }
-            );
-        }
-        else if (getYUVFormat(*sof0) == YUVFormat::YUV444) {
-            convertYCbCrToBGRA32<PixelFormat::YCBCR444_UINT>(
-                sof0->width, sof0->height, pixels,
-                std::span{ ycc.getComponent(ComponentID::Y).buffer },
-                std::span{ ycc.getComponent(ComponentID::Cb).buffer },
-                std::span{ ycc.getComponent(ComponentID::Cr).buffer }
-            );
-        }
-
-        result = {
-            .width = sof0->width,
-            .height = sof0->height,
-            .pixels = pixels
-        };
-    }
-
-    std::vector<int> JpegDecoder::createHuffSize(const std::array<uint8_t, 16>& counts)
-    {
-        std::vector<int> huffSize;
-        for (int bits = 1; bits <= counts.size(); ++bits) {
-            for (int count = 0; count < counts[bits - 1]; ++count) {
-                huffSize.push_back(bits);
-            }
-        }
-        return huffSize;
-    }
-
-    std::vector<int> JpegDecoder::createHuffCode(const std::vector<int>& huffSize)
-    {
-        assert(!huffSize.empty());
-
-        std::vector<int> huffCode(huffSize.size());
-        int code = 0;
-        int si = huffSize[0];
-
-        for (int i = 0; i < huffSize.size(); ++i) {
-            int bits = huffSize[i];
-
-            if (bits == 0) {
-                break;
-            }
-
-            if (bits != si) {
-                code <<= (bits - si);
-                si = bits;
-            }
-
-            huffCode[i] = code;
-            code++;
-        }
-        return huffCode;
-    }
-
-    JpegDecoder::HuffmanTable JpegDecoder::createHuffmanTable(const std::array<uint8_t, 16>& counts)
-    {
-        auto huffSize = createHuffSize(counts);
-        auto huffCode = createHuffCode(huffSize);
-
-        HuffmanTable table{};
-
-        int j = 0;
-        for (size_t i = 0; i < 16; ++i) {
-            auto bit = counts[i];
-            if (bit == 0) {
-                continue;
-            }
-            table.valPtr[i] = j;
-            table.minCode[i] = huffCode[j];
-            j += bit - 1;
-            table.maxCode[i] = huffCode[j];
-            ++j;
-        }
-
-        return table;
-    }
-
-    int JpegDecoder::decodeHuffmanSymbol(HuffmanTable& table, const std::vector<uint8_t>& symbols)
-    {
-        int code = 0;
-        int i = 0;
-
-        for (; i < 16; ++i) {
-            code = (code << 1) | m_BitStreamReader->nextBit();
-            if (code <= table.maxCode[i]) {
-                break;
-            }
-        }
-
-        int j = table.valPtr[i];
-        j = j + code - table.minCode[i];
-        int value = symbols[j];
-        return value;
-    }
-
-    inline int JpegDecoder::decodeZZ(int ssss)
-    {
-        int value = m_BitStreamReader->receive(ssss);
-        return extend(value, ssss);
-    }
-
-    void JpegDecoder::decodeACCoefs(
-        HuffmanTable& table,
-        const std::vector<uint8_t>& symbols,
-        MCUBlock8x8& block
-    )
-    {
-        int k = 1; // DC係数は既にデコード済みなので、kを1から開始
-
-        while (k < 64) {
-            int symbol = decodeHuffmanSymbol(table, symbols);
-            if (symbol == 0) {
-                break; // EOBマーカー
-            }
-
-            int rrrr = symbol >> 4;   // ランレングス（連続するゼロの個数）
-            int ssss = symbol & 0x0F; // 非ゼロ係数のビット長
-
-            if (ssss == 0) {
-                if (rrrr == 15) {
-                    k += 16; // ZRL（16個のゼロ）
-                }
-                else {
-                    break; // 他に非ゼロ係数はない
-                }
-            }
-            else {
-                k += rrrr; // ランレングス分インデックスを進める
-                if (k >= 64) {
-                    break;
-                }
-                // decodeZZ や receive 時点で int16_t にしてもいいかもしれない
-                block[k++] = static_cast<int16_t>(decodeZZ(ssss));
-            }
-        }
-    }
-
-    int JpegDecoder::decodeDCCoef(HuffmanTable& table, const std::vector<uint8_t>& symbols, int& pred)
-    {
-        int symbol = decodeHuffmanSymbol(table, symbols);
-        int diff = (symbol == 0) ? 0 : extend(m_BitStreamReader->receive(symbol), symbol);
-        int dcCoef = pred + diff;
-        pred = dcCoef;
-        return dcCoef;
-    }
-
-    void JpegDecoder::decodeBlock(
-        HuffmanTable& dcTable,
-        std::shared_ptr<DHT> dcDHT,
-        HuffmanTable& acTable,
-        std::shared_ptr<DHT> acDHT,
-        std::shared_ptr<DQT> dqt,
-        MCUBlock8x8& block,
-        int& dcPred
-    )
-    {
-        // TODO: すごく雑に int -> int16_t にしているので、全体的にどうするか考える
-        block[0] = static_cast<int16_t>(decodeDCCoef(dcTable, dcDHT->symbols, dcPred));
-        decodeACCoefs(acTable, acDHT->symbols, block);
-        reorder(block);
-        dequantize(block, *dqt);
-        Math::idct(block);
-        levelShift(block);
-    }
-} // namespace RagiMagick2::Image::Jpeg
+﻿#include "JpegDecoder.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <print>
+#include <semaphore>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+//#include <nameof.hpp>
+#include "Common.h"
+#include "JpegDecoderContext.h"
+#include "Utility.h"
+#include "YCbCrComponents.h"
+#include "Common/ThreadPool.h"
+#include "Image/Pixel/PixelFormat.h"
+#include "Image/Pixel/PixelFormatConverters.h"
+#include "Image/Pixel/PixelOrientation.h"
+#include "Image/Jpeg/BitStreamReader.h"
+#include "Image/Jpeg/Exif/ExifReader.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+#include "Image/Math/IDCT.h"
+
+using namespace RagiMagick2::Image;
+using namespace RagiMagick2::Image::Pixel;
+
+namespace
+{
+    using namespace RagiMagick2::Image::Jpeg;
+    using namespace RagiMagick2::Image::Jpeg::Syntax;
+
+    // Figure F.12 – Extending the sign bit of a decoded value in V
+    constexpr int extend(int v, int t)
+    {
+        int vt = 1 << (t - 1);
+        if (v < vt) {
+            vt = (-1 << t) + 1;
+            v += vt;
+        }
+        return v;
+    }
+
+    // DQT (ジグザグ順) を自然順に並べ替えて、 IDCT の逆量子化テーブルを作る
+    Math::IDCT::QuantTable createQuantTable(const DQT& dqt)
+    {
+        Math::IDCT::QuantTable table{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (dqt.precision == DQT::Precision::BITS_8) {
+                table[i] = std::get<DQT::Bits8Table>(dqt.table)[ZIGZAG[i]];
+            }
+            else {
+                table[i] = std::get<DQT::Bits16Table>(dqt.table)[ZIGZAG[i]];
+            }
+        }
+        return table;
+    }
+
+    // ECS をリスタートマーカー (RSTn) で区切り、各リスタート区間のデータを返す
+    std::vector<std::span<const uint8_t>> findRestartIntervals(std::span<const uint8_t> ecs)
+    {
+        std::vector<std::span<const uint8_t>> intervals;
+        const uint8_t* begin = ecs.data();
+        const uint8_t* end = ecs.data() + ecs.size();
+        const uint8_t* intervalBegin = begin;
+
+        for (const uint8_t* p = begin; p + 1 < end; ++p) {
+            p = static_cast<const uint8_t*>(std::memchr(p, 0xFF, end - p - 1));
+            if (p == nullptr) {
+                break;
+            }
+            if (p[1] >= 0xD0 && p[1] <= 0xD7) {
+                intervals.emplace_back(intervalBegin, p);
+                intervalBegin = p + 2;
+                ++p;
+            }
+        }
+        intervals.emplace_back(intervalBegin, end);
+
+        return intervals;
+    }
+
+    // 壊れた ECS を、 RSTn の番号を頼りに intervalCount 個のリスタート区間に割り当てる
+    // RSTn は n 番目 (mod 8) の区間の後ろに置かれるので、期待した番号と違う場合は次のマーカーの番号で判断する。
+    // - 次のマーカーが期待した番号の続きなら、このマーカーの番号だけが壊れている
+    // - 次のマーカーがこのマーカーの続きなら、間の区間のマーカーが失われている
+    // - どちらでもなければ、壊れたデータの中の偽のマーカーとして無視する
+    // データが見つからなかった区間は空になる
+    std::vector<std::span<const uint8_t>> findRestartIntervals(std::span<const uint8_t> ecs, int intervalCount)
+    {
+        // マーカーの位置と番号
+        std::vector<std::tuple<const uint8_t*, int>> markers;
+        const uint8_t* begin = ecs.data();
+        const uint8_t* end = ecs.data() + ecs.size();
+        for (const uint8_t* p = begin; p + 1 < end; ++p) {
+            p = static_cast<const uint8_t*>(std::memchr(p, 0xFF, end - p - 1));
+            if (p == nullptr) {
+                break;
+            }
+            if (p[1] >= 0xD0 && p[1] <= 0xD7) {
+                markers.emplace_back(p, p[1] - 0xD0);
+                ++p;
+            }
+        }
+
+        std::vector<std::span<const uint8_t>> intervals(intervalCount);
+        int index = 0;
+        const uint8_t* intervalBegin = begin;
+        for (size_t i = 0; i < markers.size(); ++i) {
+            const auto [marker, number] = markers[i];
+            // 区間 index の後ろのマーカーは RST(index % 8) なので、そこからいくつ飛んでいるか
+            int skipped = (number - index % 8 + 8) % 8;
+            if (skipped != 0 && i + 1 < markers.size()) {
+                const int nextNumber = std::get<1>(markers[i + 1]);
+                if (nextNumber == (index + 1) % 8) {
+                    skipped = 0;
+                }
+                else if (nextNumber != (number + 1) % 8) {
+                    continue;
+                }
+            }
+            const int next = index + 1 + skipped;
+            if (next >= intervalCount) {
+                break;
+            }
+            intervals[index] = { intervalBegin, marker };
+            index = next;
+            intervalBegin = marker + 2;
+        }
+        intervals[index] = { intervalBegin, end };
+
+        return intervals;
+    }
+
+    // ジグザグ順の k 番目の係数の、自然順での位置 (ZIGZAG の逆引き)
+    constexpr auto DEZIGZAG = [] {
+        std::array<uint8_t, BLOCK_SIZE> table{};
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            table[ZIGZAG[i]] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }();
+    static_assert(DEZIGZAG[2] == 8 && DEZIGZAG[9] == 24);
+
+    // IDCT::idctPair に渡す並び順 (ZIGZAG を int16_t にしたもの)
+    constexpr auto ZIGZAG_ORDER = [] {
+        Math::IDCT::CoefficientOrder order{};
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            order[i] = static_cast<int16_t>(ZIGZAG[i]);
+        }
+        return order;
+    }();
+
+    // ジグザグ順でこの位置までなら、非ゼロの係数は左上 4x4 に収まる
+    constexpr int LOW_FREQUENCY_LAST_INDEX = 9;
+    static_assert(DEZIGZAG[LOW_FREQUENCY_LAST_INDEX] == 3 * 8 + 0 && DEZIGZAG[LOW_FREQUENCY_LAST_INDEX + 1] == 4 * 8 + 0);
+
+    // エントロピー復号した係数 (ジグザグ順) からサンプル値を復元する
+    // lastIndex はジグザグ順で最後の非ゼロ係数の位置で、 AC 係数が無いブロックや低周波だけのブロックは専用の処理で済ませる
+    // blockSize が 8 未満の場合は縮小 IDCT で、 block の左上 blockSize x blockSize に書き込む
+    inline void reconstructBlock(MCUBlock8x8& block, int lastIndex, const Math::IDCT::QuantTable& quant, int blockSize)
+    {
+        // DC 係数だけなら、どのサイズでも全て同じ値になる
+        if (lastIndex == 0 || blockSize == 1) {
+            Math::IDCT::idctDCOnly(block[0], quant[0], block);
+            return;
+        }
+
+        // ジグザグ順から自然順へ (最後の非ゼロ係数までだけ並べ替える)
+        alignas(32) MCUBlock8x8 natural{};
+        for (int k = 0; k <= lastIndex; ++k) {
+            natural[DEZIGZAG[k]] = block[k];
+        }
+        block = natural;
+
+        switch (blockSize) {
+        case 8:
+            if (lastIndex <= LOW_FREQUENCY_LAST_INDEX) {
+                Math::IDCT::getKernels().idct4x4(block, quant, block);
+            }
+            else {
+                Math::IDCT::getKernels().idct(block, quant, block);
+            }
+            break;
+        case 4:
+            Math::IDCT::idctReduced4x4(block, quant, block);
+            break;
+        case 2:
+            Math::IDCT::idctReduced2x2(block, quant, block);
+            break;
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    constexpr int getBlockSize(DecodeScale scale)
+    {
+        switch (scale) {
+        case DecodeScale::Half:
+            return 4;
+        case DecodeScale::Quarter:
+            return 2;
+        case DecodeScale::Eighth:
+            return 1;
+        default:
+            return 8;
+        }
+    }
+
+    // ycc の (left, top) から width x height の範囲を、 outputFormat で dst (1行 dstStride バイト) に書き込む
+    // upsampledRow は 4:2:2 などの色差を拡大する作業用 (呼び出し元で使い回す)
+    // isNonTemporal が true なら、 SIMD 版の色変換ではキャッシュを経由せずに dst に書き込む
+    void convertSamples(
+        const SOF0& sof0,
+        const YCbCrComponents& ycc,
+        PixelFormat outputFormat,
+        int left,
+        int top,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        std::vector<int16_t>& upsampledRow,
+        bool isNonTemporal = false
+    )
+    {
+        const auto& y = ycc.getComponent(0);
+
+        // R8_UINT の場合、 Y は色差より粗くサンプリングされることは無い前提 (prepareScan で確かめる)
+        if (outputFormat == PixelFormat::R8_UINT || ycc.getComponentCount() == 1) {
+            convertGray(outputFormat, width, height, dst, dstStride, y.buffer, y.width, left, top, isNonTemporal);
+            return;
+        }
+
+        const auto& cb = ycc.getComponent(1);
+        const auto& cr = ycc.getComponent(2);
+
+        switch (getYUVFormat(sof0)) {
+        case YUVFormat::YUV420:
+            convertYCbCr<PixelFormat::YCBCR420_UINT>(
+                outputFormat, width, height, dst, dstStride,
+                y.buffer, cb.buffer, cr.buffer, y.width, left, top, isNonTemporal
+            );
+            break;
+        case YUVFormat::YUV444:
+            convertYCbCr<PixelFormat::YCBCR444_UINT>(
+                outputFormat, width, height, dst, dstStride,
+                y.buffer, cb.buffer, cr.buffer, y.width, left, top, isNonTemporal
+            );
+            break;
+        default:
+            // 4:2:2, 4:4:0, 4:1:1 などは、サンプリングファクタの比で色差を拡大する
+            auto plane = [](const ComponentInfo& info) {
+                return SamplePlane{ info.buffer, info.width, info.horizontalSamplingFactor, info.verticalSamplingFactor };
+            };
+            convertYCbCr(
+                outputFormat, width, height, dst, dstStride,
+                plane(y), plane(cb), plane(cr),
+                ycc.getMaxHorizontalSamplingFactor(), ycc.getMaxVerticalSamplingFactor(),
+                upsampledRow, left, top, isNonTemporal
+            );
+            break;
+        }
+    }
+
+    // ycc の (left, top) から width x height の範囲を、色変換せずに 8bit の平面 YUV として dst の (dstX, dstY) の位置に書き込む
+    // 色差のプレーンは、サンプリングファクタの比で縮小した範囲 (端は切り上げ) を書き込む
+    // left, top, dstX, dstY は MCU の境界にあること
+    void convertSamplesToPlanes(
+        const YCbCrComponents& ycc,
+        int left,
+        int top,
+        int width,
+        int height,
+        const PlanarBuffer& dst,
+        int dstX,
+        int dstY,
+        bool isNonTemporal
+    )
+    {
+        const int hMaxFactor = ycc.getMaxHorizontalSamplingFactor();
+        const int vMaxFactor = ycc.getMaxVerticalSamplingFactor();
+
+        for (size_t i = 0; i < ycc.getComponentCount(); ++i) {
+            const auto& info = ycc.getComponent(i);
+            auto scaleX = [&](int x) { return (x * info.horizontalSamplingFactor + hMaxFactor - 1) / hMaxFactor; };
+            auto scaleY = [&](int y) { return (y * info.verticalSamplingFactor + vMaxFactor - 1) / vMaxFactor; };
+
+            const int planeLeft = scaleX(left);
+            const int planeTop = scaleY(top);
+            const size_t offset = static_cast<size_t>(scaleY(dstY)) * dst.strides[i] + scaleX(dstX);
+            convertGray(
+                PixelFormat::R8_UINT,
+                scaleX(left + width) - planeLeft, scaleY(top + height) - planeTop,
+                dst.planes[i].subspan(offset), dst.strides[i],
+                info.buffer, info.width, planeLeft, planeTop, isNonTemporal
+            );
+        }
+    }
+
+    // 4:2:0 の色差を三角フィルタで拡大して、 current の (left, top) から width x height の範囲を outputFormat (isRGBFormat) で dst に書き込む
+    // upper, lower は current の上下の MCU 行のサンプル値 (画像の上端・下端では nullptr)
+    // chromaLines は current の色差の行のうち、画像に含まれる行数
+    void convertSamplesFancy(
+        const YCbCrComponents* upper,
+        const YCbCrComponents& current,
+        const YCbCrComponents* lower,
+        int chromaLines,
+        PixelFormat outputFormat,
+        int left,
+        int top,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        bool isNonTemporal
+    )
+    {
+        const auto& y = current.getComponent(0);
+        const int chromaWidth = current.getComponent(1).width;
+
+        for (int row = 0; row < height; ++row) {
+            const int line = top + row;
+            const int nearLine = line / 2;
+            // 偶数行は上の色差の行、奇数行は下の色差の行と混ぜる (画像の外なら near と同じ行)
+            const int farLine = line % 2 == 0 ? nearLine - 1 : nearLine + 1;
+
+            auto chromaRows = [&](size_t index) -> std::tuple<const int16_t*, const int16_t*> {
+                const auto& plane = current.getComponent(index);
+                const int16_t* near = &plane.buffer[static_cast<size_t>(nearLine) * chromaWidth];
+                if (farLine < 0) {
+                    if (!upper) {
+                        return { near, near };
+                    }
+                    const auto& above = upper->getComponent(index);
+                    return { near, &above.buffer[static_cast<size_t>(above.height - 1) * chromaWidth] };
+                }
+                if (farLine >= chromaLines) {
+                    return { near, lower ? lower->getComponent(index).buffer.data() : near };
+                }
+                return { near, &plane.buffer[static_cast<size_t>(farLine) * chromaWidth] };
+            };
+            const auto [cbNear, cbFar] = chromaRows(1);
+            const auto [crNear, crFar] = chromaRows(2);
+
+            getRowConverters().ycbcr420Fancy(
+                &y.buffer[static_cast<size_t>(line) * y.width], cbNear, cbFar, crNear, crFar,
+                chromaWidth, left, width, &dst[row * dstStride], outputFormat, isNonTemporal
+            );
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    JpegDecoder::JpegDecoder(std::string_view fileName)
+        : m_Parser(fileName)
+        , m_OwnedContext(std::make_unique<JpegDecoderContext>())
+        , m_Context(m_OwnedContext.get())
+    {
+    }
+
+    JpegDecoder::JpegDecoder(std::span<const uint8_t> data)
+        : m_Parser(data)
+        , m_OwnedContext(std::make_unique<JpegDecoderContext>())
+        , m_Context(m_OwnedContext.get())
+    {
+    }
+
+    JpegDecoder::JpegDecoder(std::string_view fileName, JpegDecoderContext& context)
+        : m_Parser(fileName)
+        , m_Context(&context)
+    {
+    }
+
+    JpegDecoder::JpegDecoder(std::span<const uint8_t> data, JpegDecoderContext& context)
+        : m_Parser(data)
+        , m_Context(&context)
+    {
+    }
+
+    JpegDecoder::~JpegDecoder()
+    {
+    }
+
+    void JpegDecoder::decode(DecodeResult& result, const DecodeOptions& options)
+    {
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, options)) {
+            return;
+        }
+
+        const auto [width, height] = context.getOutputSize();
+        const size_t stride = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> pixels(stride * height);
+        if (!decodeScan(context, options, pixels, stride, nullptr)) {
+            return;
+        }
+
+        result = { .width = width, .height = height, .pixels = std::move(pixels) };
+    }
+
+    void JpegDecoder::decode(DecodeResult& result, const DecodeRegion& region, const DecodeOptions& options)
+    {
+        ScanContext context{};
+        if (!prepareScan(context, region, options)) {
+            return;
+        }
+
+        const auto [width, height] = context.getOutputSize();
+        const size_t stride = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> pixels(stride * height);
+        if (!decodeScan(context, options, pixels, stride, nullptr)) {
+            return;
+        }
+
+        result = { .width = width, .height = height, .pixels = std::move(pixels) };
+    }
+
+    bool JpegDecoder::decode(const RowCallback& callback, const DecodeOptions& options)
+    {
+        assert(callback);
+
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, options)) {
+            return false;
+        }
+        // 上の行から順に渡すので、回転はしない
+        context.orientation = {};
+        return decodeScan(context, options, {}, 0, callback);
+    }
+
+    bool JpegDecoder::decode(std::span<uint8_t> dst, size_t stride, PixelFormat format, const DecodeOptions& options)
+    {
+        if (!isRGBFormat(format) && format != PixelFormat::R8_UINT) {
+            return false;
+        }
+
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, options, format)) {
+            return false;
+        }
+
+        // 最後の行は stride に満たなくてもよい
+        const auto [width, height] = context.getOutputSize();
+        const size_t rowSize = static_cast<size_t>(width) * context.bytesPerPixel;
+        if (stride < rowSize || dst.size() < stride * (height - 1) + rowSize) {
+            return false;
+        }
+        return decodeScan(context, options, dst, stride, nullptr);
+    }
+
+    bool JpegDecoder::decode(const PlanarBuffer& dst, PixelFormat format, const DecodeOptions& options)
+    {
+        if (!isPlanarFormat(format)) {
+            return false;
+        }
+
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, options, format)) {
+            return false;
+        }
+
+        // 各プレーンの大きさを確かめる (最後の行は stride に満たなくてもよい)
+        const int chromaShift = format == PixelFormat::YCBCR420_UINT ? 1 : 0;
+        for (size_t i = 0; i < dst.planes.size(); ++i) {
+            const int shift = i == 0 ? 0 : chromaShift;
+            const size_t width = static_cast<size_t>((context.width + (1 << shift) - 1) >> shift);
+            const size_t height = static_cast<size_t>((context.height + (1 << shift) - 1) >> shift);
+            if (dst.strides[i] < width || dst.planes[i].size() < dst.strides[i] * (height - 1) + width) {
+                return false;
+            }
+        }
+
+        context.planes = dst;
+        return decodeScan(context, options, {}, 0, nullptr);
+    }
+
+    bool JpegDecoder::decodeCoefficients(CoefficientImage& result)
+    {
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, {})) {
+            return false;
+        }
+
+        // ベースラインの1スキャンも、 decodeProgressiveScan でブロックごとに decodeBlock で復号すれば画像全体の係数になる
+        // result に渡すので、 JpegDecoderContext のバッファは使わない
+        std::vector<CoefficientPlane> planes;
+        createCoefficientPlanes(context, planes);
+        for (const auto& scan : m_Parser.getIndex().scans) {
+            if (!decodeProgressiveScan(context, scan, planes)) {
+                return false;
+            }
+        }
+
+        result = {
+            .sof0 = context.sof0,
+            .quantTables = context.quantTables,
+            .mcuHorizontalCount = context.mcuHorizontalCount,
+            .mcuVerticalCount = context.mcuVerticalCount,
+            .planes = std::move(planes),
+            .orientation = ExifReader(m_Parser.getExif()).getOrientation().value_or(1),
+            .metadataSegments = m_Parser.getMetadataSegments(),
+        };
+        return true;
+    }
+
+    std::optional<std::tuple<int, int>> JpegDecoder::getOutputSize(const DecodeOptions& options)
+    {
+        ScanContext context{};
+        if (!prepareScan(context, std::nullopt, options)) {
+            return std::nullopt;
+        }
+        return context.getOutputSize();
+    }
+
+    const std::vector<DamagedMCURange>& JpegDecoder::getDamagedMCURanges() const noexcept
+    {
+        return m_DamagedMCURanges;
+    }
+
+    bool JpegDecoder::parse()
+    {
+        if (!m_IsParsed) {
+            m_IsParseSucceeded = m_Parser.parse();
+            m_IsParsed = true;
+        }
+        return m_IsParseSucceeded;
+    }
+
+    bool JpegDecoder::prepareScan(
+        ScanContext& context,
+        const std::optional<DecodeRegion>& region,
+        const DecodeOptions& options,
+        PixelFormat format
+    )
+    {
+        if (!parse()) {
+            return false;
+        }
+
+        //debugging::dumpSummary(m_Parser.getMarkers(), m_Parser.getSegments());
+
+        // 必須セグメント
+        const auto& index = m_Parser.getIndex();
+        if (!index.sof || !index.sos) {
+            return false;
+        }
+        const auto* sof0 = &*index.sof;
+        const bool isProgressive = sof0->marker == Marker::SOF2;
+
+        // 12 ビット精度 (SOF1, SOF2) には対応しない
+        if (sof0->precision != 8) {
+            return false;
+        }
+
+        if (auto colorSpace = getColorSpace(*sof0); colorSpace != ColorSpace::YCbCr && colorSpace != ColorSpace::GRAYSCALE) {
+            //std::println("Unsupported color space: {}", NAMEOF_ENUM(colorSpace));
+            return false;
+        }
+
+        // B.2.2 サンプリングファクタは 1～4、インターリーブした MCU のブロック数は 10 まで
+        int blocksPerMCU = 0;
+        for (const auto& component : sof0->components) {
+            const int h = component.horizonalSamplingFactor;
+            const int v = component.verticalSamplingFactor;
+            if (h < 1 || h > 4 || v < 1 || v > 4) {
+                return false;
+            }
+            blocksPerMCU += h * v;
+        }
+        if (sof0->components.size() > 1 && blocksPerMCU > 10) {
+            return false;
+        }
+
+        // 各成分が参照する量子化テーブルが揃っていること
+        for (const auto& component : sof0->components) {
+            const auto id = std::to_underlying(component.tableID);
+            if (id >= index.dqts.size() || !index.dqts[id]) {
+                return false;
+            }
+        }
+
+        // ベースラインで最初のスキャンに全ての成分が含まれていなければ、成分ごとにスキャンが分かれている
+        const auto& sos = *index.sos;
+        const bool isMultiScan = !isProgressive && std::ranges::any_of(sof0->components, [&](const auto& component) {
+            return std::ranges::find(sos.components, component.id, &SOS::Component::componentSelector) == sos.components.end();
+        });
+
+        if (!isProgressive && !isMultiScan) {
+            // ハフマンテーブルは SOS の Tdj, Taj で成分ごとに選ぶ
+            for (size_t i = 0; i < sof0->components.size(); ++i) {
+                auto it = std::ranges::find(sos.components, sof0->components[i].id, &SOS::Component::componentSelector);
+                const auto dcID = std::to_underlying(it->dcSelector);
+                const auto acID = std::to_underlying(it->acSelector);
+                if (!index.findHuffmanTable(index.dcTables, dcID) || !index.findHuffmanTable(index.acTables, acID)) {
+                    return false;
+                }
+                context.dcSelectors[i] = dcID;
+                context.acSelectors[i] = acID;
+            }
+        }
+        else if (index.scans.empty()) {
+            // スキャンごとのハフマンテーブルは decodeProgressiveScan で確かめる
+            return false;
+        }
+
+        context.sof0 = *sof0;
+        if (context.sof0.components.size() == 1) {
+            // A.2.2 1成分だけのスキャンでは、サンプリングファクタによらず1ブロックが1 MCU
+            context.sof0.components[0].horizonalSamplingFactor = 1;
+            context.sof0.components[0].verticalSamplingFactor = 1;
+        }
+
+        // グレースケール出力は Y をそのまま使うので、 Y が最も細かくサンプリングされていること
+        const auto [hMaxFactor, vMaxFactor] = getMaxSamplingFactor(context.sof0);
+        if (format == PixelFormat::R8_UINT) {
+            const auto& y = context.sof0.components[0];
+            if (y.horizonalSamplingFactor != hMaxFactor || y.verticalSamplingFactor != vMaxFactor) {
+                return false;
+            }
+        }
+
+        // 平面 YUV はサンプル値をそのまま書き込むので、サンプリングが一致していること
+        if (format == PixelFormat::YCBCR444_UINT && getYUVFormat(context.sof0) != YUVFormat::YUV444) {
+            return false;
+        }
+        if (format == PixelFormat::YCBCR420_UINT && getYUVFormat(context.sof0) != YUVFormat::YUV420) {
+            return false;
+        }
+
+        context.isProgressive = isProgressive;
+        context.isMultiScan = isMultiScan;
+        context.outputFormat = format;
+        context.bytesPerPixel = getBytesPerPixel(format);
+        context.useFancyUpsampling = options.chromaUpsampling == ChromaUpsampling::Fancy
+            && isRGBFormat(format)
+            && getYUVFormat(context.sof0) == YUVFormat::YUV420;
+        for (size_t id = 0; id < index.dqts.size(); ++id) {
+            if (const auto& dqt = index.dqts[id]) {
+                context.quantTables[id] = createQuantTable(*dqt);
+            }
+        }
+        if (!isProgressive && !isMultiScan) {
+            for (size_t id = 0; id < index.dcTables.size(); ++id) {
+                if (const auto* dht = index.findHuffmanTable(index.dcTables, id)) {
+                    context.dcTables[id] = { getHuffmanTable(*dht), dht };
+                }
+            }
+            for (size_t id = 0; id < index.acTables.size(); ++id) {
+                if (const auto* dht = index.findHuffmanTable(index.acTables, id)) {
+                    context.acTables[id] = { getHuffmanTable(*dht), dht };
+                }
+            }
+        }
+
+        context.mcuHorizontalCount = (sof0->width + hMaxFactor * 8 - 1) / (hMaxFactor * 8);
+        context.mcuVerticalCount = (sof0->height + vMaxFactor * 8 - 1) / (vMaxFactor * 8);
+        context.blocksPerMCU = 0;
+        for (const auto& component : context.sof0.components) {
+            context.blocksPerMCU += component.horizonalSamplingFactor * component.verticalSamplingFactor;
+        }
+        context.blockSize = getBlockSize(options.scale);
+        context.width = (sof0->width * context.blockSize + 7) / 8;
+        context.height = (sof0->height * context.blockSize + 7) / 8;
+        context.mcuWidth = hMaxFactor * context.blockSize;
+        context.mcuHeight = vMaxFactor * context.blockSize;
+        context.restartInterval = index.dri ? index.dri->restartInterval : 0;
+
+        // EXIF の向きは RGB かグレースケールで出力する場合だけ反映する
+        if (options.applyExifOrientation && (isRGBFormat(format) || format == PixelFormat::R8_UINT)) {
+            context.orientation = getOrientation(ExifReader(m_Parser.getExif()).getOrientation().value_or(1));
+        }
+        context.errorConcealment = options.errorConcealment;
+
+        context.region = { 0, 0, context.width, context.height };
+        if (region) {
+            // 回転後の画像の範囲に切り詰める
+            const auto [orientedWidth, orientedHeight] = getOrientedSize(context.width, context.height, context.orientation);
+            const int left = std::clamp(region->x, 0, orientedWidth);
+            const int top = std::clamp(region->y, 0, orientedHeight);
+            const int right = std::clamp(region->x + region->width, left, orientedWidth);
+            const int bottom = std::clamp(region->y + region->height, top, orientedHeight);
+            if (left == right || top == bottom) {
+                return false;
+            }
+
+            // 回転前の座標に戻す (反転を戻してから転置を戻す)
+            const auto& orientation = context.orientation;
+            const int x = orientation.flipX ? orientedWidth - right : left;
+            const int y = orientation.flipY ? orientedHeight - bottom : top;
+            context.region = orientation.transpose
+                ? DecodeRegion{ y, x, bottom - top, right - left }
+                : DecodeRegion{ x, y, right - left, bottom - top };
+        }
+
+        return context.width > 0 && context.height > 0;
+    }
+
+    std::tuple<int, int> JpegDecoder::getMCURowRange(const ScanContext& context)
+    {
+        const auto& region = context.region;
+        const int firstMCURow = region.y / context.mcuHeight;
+        const int lastMCURow = (region.y + region.height - 1) / context.mcuHeight;
+        if (context.useFancyUpsampling) {
+            return { std::max(firstMCURow - 1, 0), std::min(lastMCURow + 1, context.mcuVerticalCount - 1) };
+        }
+        return { firstMCURow, lastMCURow };
+    }
+
+    bool JpegDecoder::decodeScan(
+        const ScanContext& context,
+        const DecodeOptions& options,
+        std::span<uint8_t> dst,
+        size_t stride,
+        const RowCallback& callback
+    )
+    {
+        m_DamagedMCURanges.clear();
+        if (context.isProgressive || context.isMultiScan) {
+            return decodeProgressive(context, options, dst, stride, callback);
+        }
+
+        const auto& region = context.region;
+        const bool isWholeImage = region.x == 0 && region.y == 0 && region.width == context.width && region.height == context.height;
+        const int mcuCount = context.mcuHorizontalCount * context.mcuVerticalCount;
+        const int restartInterval = context.restartInterval;
+        const auto ecs = m_Parser.getECS();
+
+        // スレッドプールのワーカーから呼ばれた場合、 parallelFor は順に実行するだけなので、下の1回で読み切る方で復号する
+        const bool canUseThreadPool = options.useMultiThreading && !Common::ThreadPool::shared().isWorkerThread();
+        if (!callback && isWholeImage && !context.useFancyUpsampling && canUseThreadPool && restartInterval > 0 && restartInterval < mcuCount) {
+            if (decodeRestartIntervalsInParallel(ecs, context, dst, stride)) {
+                return true;
+            }
+        }
+        if (context.errorConcealment != ErrorConcealment::None) {
+            return decodeScanWithConcealment(context, options, dst, stride, callback);
+        }
+
+        // リスタートマーカーがあれば、出力に必要な最初の MCU を含むリスタート区間から読み始める
+        const int regionFirstMCU = std::get<0>(getMCURowRange(context)) * context.mcuHorizontalCount;
+        int startMCU = 0;
+        auto scanData = ecs;
+        if (regionFirstMCU > 0 && restartInterval > 0) {
+            const int intervalCount = (mcuCount + restartInterval - 1) / restartInterval;
+            auto intervals = findRestartIntervals(ecs);
+            if (const int index = regionFirstMCU / restartInterval; index > 0 && intervals.size() == static_cast<size_t>(intervalCount)) {
+                // 区間の直前のリスタートマーカーから読ませて、 decodeMCUCoefs にマーカーを読ませる
+                startMCU = index * restartInterval;
+                scanData = ecs.subspan(intervals[index].data() - ecs.data() - 2);
+            }
+        }
+
+        BitStreamReader reader(scanData);
+        // リスタートマーカーが無い場合、スキャン全体を通して更新し続ける
+        std::array<int, 4> dcPred = {};
+
+        // 出力に必要な MCU 行より上の MCU は、エントロピー復号だけして読み捨てる
+        if (startMCU < regionFirstMCU) {
+            const size_t blockCount = static_cast<size_t>(context.mcuHorizontalCount * context.blocksPerMCU);
+            std::vector<MCUBlock8x8> coefs(blockCount);
+            std::vector<uint8_t> lastIndices(blockCount);
+            for (int mcu = startMCU; mcu < regionFirstMCU; mcu += context.mcuHorizontalCount) {
+                const int count = std::min(context.mcuHorizontalCount, regionFirstMCU - mcu);
+                if (!decodeMCUCoefs(reader, context, mcu, count, restartInterval, dcPred, coefs, lastIndices)) {
+                    return false;
+                }
+            }
+        }
+
+        auto source = [&](int firstMCU, int mcuCount, std::span<MCUBlock8x8> coefs, std::span<uint8_t> lastIndices) {
+            return decodeMCUCoefs(reader, context, firstMCU, mcuCount, restartInterval, dcPred, coefs, lastIndices);
+        };
+        return decodeMCURows(source, context, dst, stride, callback, options.useMultiThreading);
+    }
+
+    bool JpegDecoder::decodeScanWithConcealment(
+        const ScanContext& context,
+        const DecodeOptions& options,
+        std::span<uint8_t> dst,
+        size_t stride,
+        const RowCallback& callback
+    )
+    {
+        const int mcuHorizontalCount = context.mcuHorizontalCount;
+        const int mcuCount = mcuHorizontalCount * context.mcuVerticalCount;
+        const size_t blocksPerMCU = static_cast<size_t>(context.blocksPerMCU);
+        const auto ecs = m_Parser.getECS();
+
+        // リスタートマーカーが無ければ、スキャン全体を1つの区間として扱う
+        const int intervalLength = context.restartInterval > 0 ? std::min(context.restartInterval, mcuCount) : mcuCount;
+        const int intervalCount = (mcuCount + intervalLength - 1) / intervalLength;
+        const auto intervals = intervalCount > 1 ? findRestartIntervals(ecs, intervalCount) : std::vector{ ecs };
+
+        BitStreamReader reader(std::span<const uint8_t>{});
+        int intervalIndex = -1;
+        std::array<int, 4> dcPred = {};
+        // 今の区間で壊れたデータを見つけた (区間の残りは読まずに埋める)
+        bool isDamaged = false;
+
+        // 前に decodeMCURows から渡された MCU 行の係数
+        // decodeMCURows は MCU 行バッファを順に使い回すので、次の MCU 行を要求している間は1つ前の MCU 行のバッファは書き換えられない
+        static_assert(MCU_ROW_BUFFER_COUNT >= 2);
+        std::span<const MCUBlock8x8> previousCoefs;
+        std::span<const uint8_t> previousLastIndices;
+        int previousFirstMCU = -1;
+
+        auto decodeCoefs = [&](int firstMCU, int count, std::span<MCUBlock8x8> coefs, std::span<uint8_t> lastIndices) {
+            const bool hasPreviousRow = previousFirstMCU >= 0 && previousFirstMCU == firstMCU - mcuHorizontalCount;
+
+            for (int i = 0; i < count; ++i) {
+                const int mcu = firstMCU + i;
+                if (mcu / intervalLength != intervalIndex) {
+                    // 区間ごとに読み直すので、前の区間が壊れていてもここから復帰できる
+                    intervalIndex = mcu / intervalLength;
+                    reader = BitStreamReader(intervals[intervalIndex]);
+                    dcPred = {};
+                    isDamaged = false;
+                }
+
+                const size_t firstBlock = static_cast<size_t>(i) * blocksPerMCU;
+                auto mcuCoefs = coefs.subspan(firstBlock, blocksPerMCU);
+                auto mcuLastIndices = lastIndices.subspan(firstBlock, blocksPerMCU);
+                if (!isDamaged) {
+                    isDamaged = !reader.hasMore()
+                        || !decodeMCUCoefs(reader, context, mcu, 1, 0, dcPred, mcuCoefs, mcuLastIndices)
+                        || reader.isCorrupted();
+                    if (!isDamaged) {
+                        continue;
+                    }
+
+                    // 壊れたデータを見つけた MCU から区間の終わりまでを埋める
+                    const int intervalEnd = std::min((intervalIndex + 1) * intervalLength, mcuCount);
+                    if (!m_DamagedMCURanges.empty() && m_DamagedMCURanges.back().firstMCU + m_DamagedMCURanges.back().mcuCount == mcu) {
+                        m_DamagedMCURanges.back().mcuCount += intervalEnd - mcu;
+                    }
+                    else {
+                        m_DamagedMCURanges.push_back({ mcu, intervalEnd - mcu });
+                    }
+                }
+
+                if (context.errorConcealment == ErrorConcealment::PreviousRow && hasPreviousRow) {
+                    std::ranges::copy(previousCoefs.subspan(firstBlock, blocksPerMCU), mcuCoefs.begin());
+                    std::ranges::copy(previousLastIndices.subspan(firstBlock, blocksPerMCU), mcuLastIndices.begin());
+                }
+                else {
+                    // 係数が全て 0 のブロックは、レベルシフトの 128 (灰色) になる
+                    std::ranges::fill(mcuCoefs, MCUBlock8x8{});
+                    std::ranges::fill(mcuLastIndices, 0);
+                }
+            }
+
+            previousCoefs = coefs;
+            previousLastIndices = lastIndices;
+            previousFirstMCU = firstMCU;
+            return true;
+        };
+
+        // 出力に必要な MCU 行より上の MCU は、出力に必要な最初の MCU を含む区間から復号して読み捨てる
+        const int regionFirstMCU = std::get<0>(getMCURowRange(context)) * mcuHorizontalCount;
+        if (const int startMCU = regionFirstMCU / intervalLength * intervalLength; startMCU < regionFirstMCU) {
+            const size_t blockCount = static_cast<size_t>(mcuHorizontalCount) * blocksPerMCU;
+            std::vector<MCUBlock8x8> coefs(blockCount);
+            std::vector<uint8_t> lastIndices(blockCount);
+            for (int mcu = startMCU; mcu < regionFirstMCU; mcu += mcuHorizontalCount) {
+                decodeCoefs(mcu, std::min(mcuHorizontalCount, regionFirstMCU - mcu), coefs, lastIndices);
+            }
+            // coefs はここで解放されるので、上の行として使わない
+            previousFirstMCU = -1;
+        }
+
+        return decodeMCURows(decodeCoefs, context, dst, stride, callback, options.useMultiThreading);
+    }
+
+    bool JpegDecoder::decodeMCUCoefs(
+        BitStreamReader& reader,
+        const ScanContext& context,
+        int firstMCU,
+        int mcuCount,
+        int restartInterval,
+        std::array<int, 4>& dcPred,
+        std::span<MCUBlock8x8> coefs,
+        std::span<uint8_t> lastIndices
+    )
+    {
+        const auto& sof0 = context.sof0;
+        auto block = coefs.begin();
+        auto lastIndex = lastIndices.begin();
+
+        for (int mcu = firstMCU; mcu < firstMCU + mcuCount; ++mcu) {
+            if (!reader.hasMore()) {
+                // データが途中で終わっている場合は、残りのブロックを 0 で埋めて失敗にする
+                // MCU 行バッファは使い回すので、埋めないと前に復号した MCU 行の係数が残ってしまう
+                const size_t blockCount = static_cast<size_t>(mcuCount) * context.blocksPerMCU;
+                std::fill(block, coefs.begin() + blockCount, MCUBlock8x8{});
+                std::fill(lastIndex, lastIndices.begin() + blockCount, 0);
+                std::println("Unexpected end of scan data");
+                return false;
+            }
+
+            // DRI で指定された間隔でリスタートマーカーがある場合、 dcPred をリセット
+            if (restartInterval > 0 && mcu != 0 && mcu % restartInterval == 0) {
+                uint8_t marker = reader.readMarker();
+                if (marker == 0) {
+                    std::println("Restart marker not found");
+                    return false;
+                }
+                if (marker < 0xD0 || marker > 0xD7) {
+                    std::println("Invalid restart marker: 0xFF{:02X}", marker);
+                    return false;
+                }
+                dcPred = {};
+            }
+
+            for (auto&& component : sof0.components) {
+                auto componentIndex = std::distance(sof0.components.data(), &component);
+                const auto& [dcTable, dcDHT] = context.dcTables[context.dcSelectors[componentIndex]];
+                const auto& [acTable, acDHT] = context.acTables[context.acSelectors[componentIndex]];
+
+                // 4:4:4 の場合、1 MCU Y  8 x  8, Cb 8 x 8, Cr 8 x 8 で処理
+                // 4:2:0 の場合、1 MCU Y 16 x 16, Cb 8 x 8, Cr 8 x 8 となるため、Y は 2 ブロック分の処理が必要
+                const int blockCount = component.horizonalSamplingFactor * component.verticalSamplingFactor;
+
+                for (int i = 0; i < blockCount; ++i) {
+                    block->fill(0);
+                    *lastIndex++ = static_cast<uint8_t>(decodeBlock(reader, *dcTable, *dcDHT, *acTable, *acDHT, *block, dcPred[componentIndex]));
+                    ++block;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void JpegDecoder::reconstructMCUs(
+        const ScanContext& context,
+        std::span<const MCUBlock8x8> coefs,
+        std::span<const uint8_t> lastIndices,
+        int firstMCU,
+        int mcuCount,
+        YCbCrComponents& ycc,
+        int firstMCURow,
+        int firstMCUColumn
+    )
+    {
+        const auto& sof0 = context.sof0;
+        const size_t blockSize = context.blockSize;
+        auto coef = coefs.begin();
+        auto lastIndex = lastIndices.begin();
+
+        // 復元したブロックをプレーンに書き込む
+        // 画像の右端・下端にかかるブロックは、プレーンからはみ出す部分を捨てる
+        auto storeBlock = [&](const MCUBlock8x8& block, ComponentInfo& info, size_t dstBlockX, size_t dstBlockY) {
+            const size_t width = info.width;
+            const size_t rows = std::min<size_t>(blockSize, info.height - dstBlockY);
+            const size_t cols = std::min<size_t>(blockSize, width - dstBlockX);
+
+            for (size_t y = 0; y < rows; ++y) {
+                size_t offset = (dstBlockY + y) * width + dstBlockX;
+                if (cols == 8) {
+                    __m128i data = _mm_load_si128(reinterpret_cast<const __m128i*>(&block[y * 8]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(&info.buffer[offset]), data);
+                }
+                else {
+                    std::memcpy(&info.buffer[offset], &block[y * 8], cols * sizeof(int16_t));
+                }
+            }
+        };
+
+        // 2 ブロックをまとめて IDCT できる場合は、 1 つ目のブロックを次のブロックまで待たせる
+        const auto idctPair = blockSize == 8 ? Math::IDCT::getKernels().idctPair : nullptr;
+        struct PendingBlock
+        {
+            const MCUBlock8x8* coefs;
+            int lastIndex;
+            const Math::IDCT::QuantTable* quant;
+            ComponentInfo* info;
+            size_t x;
+            size_t y;
+        };
+        std::optional<PendingBlock> pending;
+
+        for (int mcu = firstMCU; mcu < firstMCU + mcuCount; ++mcu) {
+            const size_t mcuRow = mcu / context.mcuHorizontalCount - firstMCURow;
+            const size_t mcuCol = mcu % context.mcuHorizontalCount - firstMCUColumn;
+
+            for (size_t componentIndex = 0; componentIndex < sof0.components.size(); ++componentIndex) {
+                const auto& component = sof0.components[componentIndex];
+                const int blockCount = component.horizonalSamplingFactor * component.verticalSamplingFactor;
+
+                // グレースケールで出力する場合、色差は使わないので IDCT もしない
+                if (componentIndex > 0 && context.outputFormat == PixelFormat::R8_UINT) {
+                    coef += blockCount;
+                    lastIndex += blockCount;
+                    continue;
+                }
+
+                const auto& quant = context.quantTables[std::to_underlying(component.tableID)];
+                auto& info = ycc.getComponent(componentIndex);
+
+                for (size_t blockRow = 0; blockRow < component.verticalSamplingFactor; ++blockRow) {
+                    for (size_t blockCol = 0; blockCol < component.horizonalSamplingFactor; ++blockCol) {
+                        size_t dstBlockX = (mcuCol * component.horizonalSamplingFactor + blockCol) * blockSize;
+                        size_t dstBlockY = (mcuRow * component.verticalSamplingFactor + blockRow) * blockSize;
+                        const MCUBlock8x8& current = *coef++;
+                        const int currentLastIndex = *lastIndex++;
+
+                        // プレーンの外側のブロックは書き込まないので、復元もしない
+                        if (dstBlockX >= static_cast<size_t>(info.width) || dstBlockY >= static_cast<size_t>(info.height)) {
+                            continue;
+                        }
+
+                        if (idctPair && currentLastIndex > 0) {
+                            if (!pending) {
+                                pending = PendingBlock{ &current, currentLastIndex, &quant, &info, dstBlockX, dstBlockY };
+                                continue;
+                            }
+                            alignas(32) MCUBlock8x8 first;
+                            alignas(32) MCUBlock8x8 second;
+                            idctPair(*pending->coefs, *pending->quant, first, current, quant, second, ZIGZAG_ORDER);
+                            storeBlock(first, *pending->info, pending->x, pending->y);
+                            storeBlock(second, info, dstBlockX, dstBlockY);
+                            pending.reset();
+                            continue;
+                        }
+
+                        alignas(32) MCUBlock8x8 block = current;
+                        reconstructBlock(block, currentLastIndex, quant, blockSize);
+                        storeBlock(block, info, dstBlockX, dstBlockY);
+                    }
+                }
+            }
+        }
+
+        // 相手のいないブロックは 1 つだけで復元する
+        if (pending) {
+            alignas(32) MCUBlock8x8 block = *pending->coefs;
+            reconstructBlock(block, pending->lastIndex, *pending->quant, blockSize);
+            storeBlock(block, *pending->info, pending->x, pending->y);
+        }
+    }
+
+    bool JpegDecoder::decodeMCURows(
+        const CoefficientSource& source,
+        const ScanContext& context,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        const RowCallback& callback,
+        bool useMultiThreading
+    )
+    {
+        const auto& sof0 = context.sof0;
+        const auto& region = context.region;
+        const int mcuHorizontalCount = context.mcuHorizontalCount;
+        const int mcuWidth = context.mcuWidth;
+        const int mcuHeight = context.mcuHeight;
+        const bool isFancy = context.useFancyUpsampling;
+        // スレッドプールのワーカーから呼ばれた場合は、下の freeBuffers と remainingRows でワーカーを待たせると
+        // 他のワーカーも同じように待っていてキューのタスクが実行されなくなることがあるので、このスレッドだけで処理する
+        const bool isParallel = useMultiThreading && !Common::ThreadPool::shared().isWorkerThread();
+
+        // デコードする MCU の範囲
+        // 三角フィルタで色差を拡大する場合は、出力範囲の上下左右の MCU も隣の色差として使う
+        const auto [firstMCURow, lastMCURow] = getMCURowRange(context);
+        const int margin = isFancy ? 1 : 0;
+        const int firstMCUColumn = std::max(region.x / mcuWidth - margin, 0);
+        const int lastMCUColumn = std::min((region.x + region.width - 1) / mcuWidth + margin, mcuHorizontalCount - 1);
+        const int mcuColumnCount = lastMCUColumn - firstMCUColumn + 1;
+        const int mcuRowCount = lastMCURow - firstMCURow + 1;
+
+        // IDCT するのは出力範囲と重なる MCU の列だけなので、その幅の帯に書き込む
+        const int bandX = firstMCUColumn * mcuWidth;
+        const int bandWidth = std::min(mcuColumnCount * mcuWidth, context.width - bandX);
+        // コールバックに渡す行のバイト数
+        const size_t rowStride = static_cast<size_t>(region.width) * context.bytesPerPixel;
+        // 回転する場合は、 MCU 行バッファの行に色変換してから dst の回転後の位置に書き込む
+        const bool isOriented = !callback && !context.orientation.isIdentity();
+
+        // MCU 行バッファは JpegDecoderContext に残して、次の画像でも確保し直さずに使う
+        auto& buffers = m_Context->m_RowBuffers;
+        for (int i = 0; i < MCU_ROW_BUFFER_COUNT; ++i) {
+            const size_t blockCount = static_cast<size_t>(mcuHorizontalCount * context.blocksPerMCU);
+            if (buffers.size() <= static_cast<size_t>(i)) {
+                buffers.emplace_back(
+                    std::vector<MCUBlock8x8>(blockCount),
+                    std::vector<uint8_t>(blockCount),
+                    YCbCrComponents(sof0, 1, context.blockSize, bandWidth),
+                    std::vector<uint8_t>(callback || isOriented ? rowStride * mcuHeight : 0)
+                );
+                continue;
+            }
+            auto& buffer = buffers[i];
+            buffer.coefs.resize(blockCount);
+            buffer.lastIndices.resize(blockCount);
+            buffer.samples.reset(sof0, 1, context.blockSize, bandWidth);
+            buffer.rows.resize(callback || isOriented ? rowStride * mcuHeight : 0);
+        }
+
+        // 空いている MCU 行バッファの数
+        std::counting_semaphore<MCU_ROW_BUFFER_COUNT> freeBuffers(MCU_ROW_BUFFER_COUNT);
+        // 色変換まで終わっていない MCU 行の数
+        std::latch remainingRows(mcuRowCount);
+
+        // 次にコールバックに渡す MCU 行 (三角フィルタの場合は、次に色変換する MCU 行)
+        // 三角フィルタの場合、最初の MCU 行の IDCT が終わるまでは firstMCURow - 1 にしておく
+        std::atomic<int> nextCallbackRow = isFancy ? firstMCURow - 1 : firstMCURow;
+        bool isSucceeded = true;
+
+        // MCU 行 mcuRow のうち出力範囲に含まれる行を色変換して、 dst か MCU 行バッファに書き込む
+        // 三角フィルタ用に上下に余分にデコードした MCU 行は、何もせずに lineCount = 0 を返す
+        // hasLowerRow が false なら、三角フィルタで下の MCU 行を使わない (画像の下端と同じ扱いにする)
+        auto convertRow = [&](int mcuRow, bool hasLowerRow) -> DecodedRows {
+            const int rowTop = mcuRow * mcuHeight;
+            const int firstLine = std::max(rowTop, region.y);
+            const int endLine = std::min(rowTop + mcuHeight, region.y + region.height);
+            const int lineCount = endLine - firstLine;
+            if (lineCount <= 0) {
+                return { .width = region.width, .height = region.height, .firstLine = 0, .lineCount = 0, .pixels = {} };
+            }
+
+            // 出力先は呼び出し元のバッファか、コールバックに渡す (回転する) 行バッファ
+            // 出力範囲の切り出しも色変換で行うので、中間バッファは使わない
+            // 呼び出し元のバッファは読み返さないので、キャッシュを経由せずに書き込む
+            const bool isDirect = !callback && !isOriented;
+            auto& buffer = buffers[mcuRow % MCU_ROW_BUFFER_COUNT];
+            if (isPlanarFormat(context.outputFormat)) {
+                // 平面 YUV は画像全体を呼び出し元のバッファに書き込む場合だけ
+                convertSamplesToPlanes(
+                    buffer.samples,
+                    region.x - bandX, firstLine - rowTop, region.width, lineCount,
+                    context.planes, region.x, firstLine, true
+                );
+                return { .width = region.width, .height = region.height, .firstLine = firstLine - region.y, .lineCount = lineCount, .pixels = {} };
+            }
+            auto rows = isDirect
+                ? dst.subspan((firstLine - region.y) * dstStride)
+                : std::span{ buffer.rows }.first(lineCount * rowStride);
+            if (isFancy) {
+                const int chromaLines = std::min(context.blockSize, (context.height + 1) / 2 - mcuRow * context.blockSize);
+                convertSamplesFancy(
+                    mcuRow > 0 ? &buffers[(mcuRow - 1) % MCU_ROW_BUFFER_COUNT].samples : nullptr,
+                    buffer.samples,
+                    hasLowerRow && mcuRow < context.mcuVerticalCount - 1 ? &buffers[(mcuRow + 1) % MCU_ROW_BUFFER_COUNT].samples : nullptr,
+                    chromaLines,
+                    context.outputFormat,
+                    region.x - bandX, firstLine - rowTop, region.width, lineCount,
+                    rows, isDirect ? dstStride : rowStride, isDirect
+                );
+            }
+            else {
+                convertSamples(
+                    sof0, buffer.samples, context.outputFormat,
+                    region.x - bandX, firstLine - rowTop, region.width, lineCount,
+                    rows, isDirect ? dstStride : rowStride, buffer.upsampledRow, isDirect
+                );
+            }
+            if (isOriented) {
+                storeOriented(
+                    context.orientation, context.bytesPerPixel,
+                    rows.data(), rowStride, 0, firstLine - region.y, region.width, lineCount,
+                    region.width, region.height, dst.data(), dstStride
+                );
+            }
+
+            return {
+                .width = region.width,
+                .height = region.height,
+                .firstLine = firstLine - region.y,
+                .lineCount = lineCount,
+                .pixels = rows
+            };
+        };
+
+        // MCU 行 mcuRow の前の行の処理が終わるまで待つ
+        auto waitForRow = [&](int mcuRow) {
+            for (int row = nextCallbackRow.load(); row != mcuRow; row = nextCallbackRow.load()) {
+                nextCallbackRow.wait(row);
+            }
+        };
+        auto finishRow = [&](int mcuRow) {
+            nextCallbackRow.store(mcuRow + 1);
+            nextCallbackRow.notify_all();
+        };
+
+        for (int mcuRow = firstMCURow; mcuRow <= lastMCURow; ++mcuRow) {
+            // MCU 行 mcuRow の係数の用意 (エントロピー復号) はこのスレッドで行い、
+            // その間に前の MCU 行の IDCT と色変換を他のスレッドで行う
+            freeBuffers.acquire();
+            auto& buffer = buffers[mcuRow % MCU_ROW_BUFFER_COUNT];
+            const int firstMCU = mcuRow * mcuHorizontalCount;
+
+            isSucceeded = source(firstMCU, mcuHorizontalCount, buffer.coefs, buffer.lastIndices);
+            if (!isSucceeded) {
+                // 係数を用意できなかった MCU 行は、 IDCT も色変換もせず、コールバックにも渡さない
+                // 三角フィルタの場合、1つ上の MCU 行はこの MCU 行を待っているので、下の MCU 行が無いものとして色変換する
+                if (isFancy && mcuRow > firstMCURow) {
+                    waitForRow(mcuRow - 1);
+                    if (const auto rows = convertRow(mcuRow - 1, false); callback && rows.lineCount > 0) {
+                        callback(rows);
+                    }
+                    finishRow(mcuRow - 1);
+                }
+                remainingRows.count_down(lastMCURow - mcuRow + 1);
+                break;
+            }
+            const bool isLastRow = mcuRow == lastMCURow;
+
+            auto reconstructRow = [&, mcuRow, firstMCU, isLastRow] {
+                const size_t firstBlock = static_cast<size_t>(firstMCUColumn * context.blocksPerMCU);
+                reconstructMCUs(
+                    context,
+                    std::span{ buffer.coefs }.subspan(firstBlock),
+                    std::span{ buffer.lastIndices }.subspan(firstBlock),
+                    firstMCU + firstMCUColumn,
+                    mcuColumnCount,
+                    buffer.samples,
+                    mcuRow,
+                    firstMCUColumn
+                );
+
+                if (isFancy) {
+                    // 1つ上の MCU 行は、この MCU 行のサンプル値が揃ってから上の行から順に色変換する
+                    // 色変換が終われば、2つ上の MCU 行のサンプル値はもう参照しない
+                    if (mcuRow > firstMCURow) {
+                        waitForRow(mcuRow - 1);
+                        if (const auto rows = convertRow(mcuRow - 1, true); callback && rows.lineCount > 0) {
+                            callback(rows);
+                        }
+                        if (mcuRow - 2 >= firstMCURow) {
+                            freeBuffers.release();
+                        }
+                        finishRow(mcuRow - 1);
+                    }
+                    else {
+                        // 最初の MCU 行は、サンプル値が揃ったことを次の MCU 行に知らせる
+                        finishRow(firstMCURow - 1);
+                    }
+                    // 最後の MCU 行は下の行を待たずに色変換して、残りのバッファを返す
+                    if (isLastRow) {
+                        if (const auto rows = convertRow(mcuRow, false); callback && rows.lineCount > 0) {
+                            callback(rows);
+                        }
+                        freeBuffers.release(std::min(mcuRow - firstMCURow + 1, 2));
+                        finishRow(mcuRow);
+                    }
+                }
+                else {
+                    const auto rows = convertRow(mcuRow, false);
+                    if (callback) {
+                        // IDCT と色変換は並行して行うが、コールバックは上の行から順に呼ぶ
+                        waitForRow(mcuRow);
+                        callback(rows);
+                        finishRow(mcuRow);
+                    }
+                    freeBuffers.release();
+                }
+
+                remainingRows.count_down();
+            };
+
+            if (isParallel) {
+                Common::ThreadPool::shared().enqueue(reconstructRow);
+            }
+            else {
+                reconstructRow();
+            }
+        }
+
+        remainingRows.wait();
+        return isSucceeded;
+    }
+
+    bool JpegDecoder::decodeRestartIntervalsInParallel(
+        std::span<const uint8_t> ecs,
+        const ScanContext& context,
+        std::span<uint8_t> dst,
+        size_t dstStride
+    )
+    {
+        const int mcuHorizontalCount = context.mcuHorizontalCount;
+        const int mcuCount = mcuHorizontalCount * context.mcuVerticalCount;
+        const int restartInterval = context.restartInterval;
+        const int intervalCount = (mcuCount + restartInterval - 1) / restartInterval;
+
+        auto intervals = findRestartIntervals(ecs);
+        if (intervals.size() != static_cast<size_t>(intervalCount)) {
+            return false;
+        }
+
+        std::atomic<bool> isSucceeded = true;
+
+        Common::ThreadPool::shared().parallelFor(intervals.size(), [&](size_t i) {
+            BitStreamReader reader(intervals[i]);
+            const int firstMCU = static_cast<int>(i) * restartInterval;
+            const int count = std::min(restartInterval, mcuCount - firstMCU);
+
+            // 区間ごとに DC の予測値はリセットされる
+            std::array<int, 4> dcPred = {};
+            std::vector<MCUBlock8x8> coefs(static_cast<size_t>(count * context.blocksPerMCU));
+            std::vector<uint8_t> lastIndices(coefs.size());
+
+            // 壊れた区間 (区間のデータを越えて読んだか、読み残した) があれば失敗にして、呼び出し元の順に復号する方に任せる
+            // ErrorConcealment::None ならそちらでリスタートマーカーが見つからずに失敗し、それ以外は壊れた MCU を埋める
+            if (!decodeMCUCoefs(reader, context, firstMCU, count, 0, dcPred, coefs, lastIndices)
+                || reader.isCorrupted()
+                || !reader.isEndReached()) {
+                isSucceeded = false;
+                return;
+            }
+
+            // 区間が掛かる MCU 行の分だけサンプル値を持つ
+            const int firstMCURow = firstMCU / mcuHorizontalCount;
+            const int lastMCURow = (firstMCU + count - 1) / mcuHorizontalCount;
+            YCbCrComponents ycc(context.sof0, lastMCURow - firstMCURow + 1, context.blockSize, context.width);
+            reconstructMCUs(context, coefs, lastIndices, firstMCU, count, ycc, firstMCURow, 0);
+
+            // 回転する場合は、 MCU 行ごとに色変換してから dst の回転後の位置に書き込む
+            const bool isOriented = !context.orientation.isIdentity();
+            const size_t rowStride = static_cast<size_t>(std::min(count * context.mcuWidth, context.width)) * context.bytesPerPixel;
+            std::vector<uint8_t> rows(isOriented ? rowStride * context.mcuHeight : 0);
+            std::vector<int16_t> upsampledRow;
+
+            // MCU 行ごとに、この区間の MCU の範囲だけ色変換する
+            // MCU の境界は色差のサンプルの境界と揃っているので、隣の区間の担当部分は参照しない
+            for (int mcuRow = firstMCURow; mcuRow <= lastMCURow; ++mcuRow) {
+                const int firstColumn = std::max(firstMCU, mcuRow * mcuHorizontalCount) - mcuRow * mcuHorizontalCount;
+                const int endColumn = std::min(firstMCU + count, (mcuRow + 1) * mcuHorizontalCount) - mcuRow * mcuHorizontalCount;
+                const int left = firstColumn * context.mcuWidth;
+                const int right = std::min(endColumn * context.mcuWidth, context.width);
+                const int top = mcuRow * context.mcuHeight;
+                const int bottom = std::min(top + context.mcuHeight, context.height);
+
+                if (isPlanarFormat(context.outputFormat)) {
+                    convertSamplesToPlanes(
+                        ycc, left, top - firstMCURow * context.mcuHeight, right - left, bottom - top,
+                        context.planes, left, top, false
+                    );
+                    continue;
+                }
+                if (isOriented) {
+                    convertSamples(
+                        context.sof0, ycc, context.outputFormat,
+                        left, top - firstMCURow * context.mcuHeight, right - left, bottom - top,
+                        rows, rowStride, upsampledRow
+                    );
+                    storeOriented(
+                        context.orientation, context.bytesPerPixel,
+                        rows.data(), rowStride, left, top, right - left, bottom - top,
+                        context.width, context.height, dst.data(), dstStride
+                    );
+                    continue;
+                }
+                convertSamples(
+                    context.sof0, ycc, context.outputFormat,
+                    left, top - firstMCURow * context.mcuHeight, right - left, bottom - top,
+                    dst.subspan(top * dstStride + left * context.bytesPerPixel), dstStride, upsampledRow
+                );
+            }
+        });
+
+        return isSucceeded;
+    }
+
+    bool JpegDecoder::decodeProgressive(
+        const ScanContext& context,
+        const DecodeOptions& options,
+        std::span<uint8_t> dst,
+        size_t stride,
+        const RowCallback& callback
+    )
+    {
+        const auto& scans = m_Parser.getIndex().scans;
+
+        // 係数はスキャンごとに少しずつ埋まっていくので、画像全体の分を 0 で初期化しておく
+        auto& planes = m_Context->m_CoefficientPlanes;
+        createCoefficientPlanes(context, planes);
+
+        auto source = [&](int firstMCU, int mcuCount, std::span<MCUBlock8x8> coefs, std::span<uint8_t> lastIndices) {
+            gatherMCUCoefs(context, planes, firstMCU, mcuCount, coefs, lastIndices);
+            return true;
+        };
+
+        // 途中経過は出力範囲 (回転後) の大きさで作る
+        const auto [previewWidth, previewHeight] = context.getOutputSize();
+        const size_t previewStride = static_cast<size_t>(previewWidth) * context.bytesPerPixel;
+        std::vector<uint8_t> preview;
+
+        for (size_t i = 0; i < scans.size(); ++i) {
+            if (!decodeProgressiveScan(context, scans[i], planes)) {
+                return false;
+            }
+
+            if (options.previewCallback && !isPlanarFormat(context.outputFormat) && i + 1 < scans.size()) {
+                preview.resize(previewStride * previewHeight);
+                if (!decodeMCURows(source, context, preview, previewStride, nullptr, options.useMultiThreading)) {
+                    return false;
+                }
+                options.previewCallback({
+                    .scanCount = static_cast<int>(i + 1),
+                    .totalScanCount = static_cast<int>(scans.size()),
+                    .width = previewWidth,
+                    .height = previewHeight,
+                    .pixels = preview
+                });
+            }
+        }
+
+        return decodeMCURows(source, context, dst, stride, callback, options.useMultiThreading);
+    }
+
+    void JpegDecoder::createCoefficientPlanes(const ScanContext& context, std::vector<CoefficientPlane>& planes)
+    {
+        planes.resize(context.sof0.components.size());
+        for (size_t i = 0; i < planes.size(); ++i) {
+            const auto& component = context.sof0.components[i];
+            auto& plane = planes[i];
+            plane.blocksPerLine = context.mcuHorizontalCount * component.horizonalSamplingFactor;
+            plane.blockLines = context.mcuVerticalCount * component.verticalSamplingFactor;
+            const size_t blockCount = static_cast<size_t>(plane.blocksPerLine) * plane.blockLines;
+            plane.blocks.assign(blockCount, MCUBlock8x8{});
+            plane.lastIndices.assign(blockCount, 0);
+        }
+    }
+
+    bool JpegDecoder::decodeProgressiveScan(
+        const ScanContext& context,
+        const SegmentIndex::Scan& scan,
+        std::vector<CoefficientPlane>& planes
+    )
+    {
+        const auto& sof0 = context.sof0;
+        const auto& sos = scan.sos;
+        const int ss = sos.spectralSelectionStart;
+        const int se = sos.spectralSelectionEnd;
+        const int ah = sos.successiveApproximation >> 4;
+        const int al = sos.successiveApproximation & 0x0F;
+
+        // ベースラインのスキャンは DC と AC をまとめて符号化する
+        const bool isSequential = !context.isProgressive;
+        if (sos.components.empty()) {
+            return false;
+        }
+        if (isSequential) {
+            if (ss != 0 || se != 63 || ah != 0 || al != 0) {
+                std::println("Invalid sequential scan: Ss={}, Se={}, Ah={}, Al={}", ss, se, ah, al);
+                return false;
+            }
+        }
+        // G.1.1.1.1 DC と AC は別のスキャンで符号化され、 AC のスキャンは1成分だけを含む
+        else if (ss > se || se > 63 || (ss == 0 && se != 0) || (ss > 0 && sos.components.size() != 1) || al > 13) {
+            std::println("Invalid progressive scan: Ss={}, Se={}, Ah={}, Al={}", ss, se, ah, al);
+            return false;
+        }
+
+        const bool isDC = ss == 0 && !isSequential;
+        const bool isFirst = ah == 0;
+
+        // スキャンに含まれる成分 (sof0.components での位置) と、使うハフマンテーブル
+        // プログレッシブでは DC か AC の一方だけ使うので、 table に入れる (ベースラインは table が DC、 acTable が AC)
+        struct ScanComponent
+        {
+            size_t index = 0;
+            std::shared_ptr<const HuffmanTable> table;
+            const DHT* dht = nullptr;
+            std::shared_ptr<const HuffmanTable> acTable;
+            const DHT* acDHT = nullptr;
+        };
+        std::vector<ScanComponent> components;
+        components.reserve(sos.components.size());
+
+        for (const auto& scanComponent : sos.components) {
+            auto it = std::ranges::find(sof0.components, scanComponent.componentSelector, &SOF0::Component::id);
+            if (it == sof0.components.end()) {
+                return false;
+            }
+
+            ScanComponent component{};
+            component.index = static_cast<size_t>(std::distance(sof0.components.begin(), it));
+
+            auto findTable = [&](const SegmentIndex::TableIndices& tables, uint8_t id) -> const DHT* {
+                const auto* dht = m_Parser.getIndex().findHuffmanTable(tables, id);
+                if (dht == nullptr) {
+                    std::println("Huffman table not found: {}", id);
+                }
+                return dht;
+            };
+
+            // DC の2回目以降のスキャンは補正ビットだけなので、ハフマンテーブルを使わない
+            if (!isDC || isFirst) {
+                const bool useDCTable = isDC || isSequential;
+                component.dht = useDCTable
+                    ? findTable(scan.dcTables, std::to_underlying(scanComponent.dcSelector))
+                    : findTable(scan.acTables, std::to_underlying(scanComponent.acSelector));
+                if (component.dht == nullptr) {
+                    return false;
+                }
+                component.table = getHuffmanTable(*component.dht);
+            }
+            if (isSequential) {
+                component.acDHT = findTable(scan.acTables, std::to_underlying(scanComponent.acSelector));
+                if (component.acDHT == nullptr) {
+                    return false;
+                }
+                component.acTable = getHuffmanTable(*component.acDHT);
+            }
+            components.push_back(std::move(component));
+        }
+
+        // 複数の成分を含むスキャンは MCU 単位で符号化する
+        // 1成分だけのスキャンは1ブロックが1 MCU で、成分の実際の大きさ (MCU の倍数に切り上げない) の範囲だけ符号化する
+        const bool isInterleaved = components.size() > 1;
+        int blocksPerLine = 0;
+        int mcuCount = context.mcuHorizontalCount * context.mcuVerticalCount;
+        if (!isInterleaved) {
+            const auto [hMaxFactor, vMaxFactor] = getMaxSamplingFactor(sof0);
+            const auto& component = sof0.components[components[0].index];
+            const int componentWidth = (sof0.width * component.horizonalSamplingFactor + hMaxFactor - 1) / hMaxFactor;
+            const int componentHeight = (sof0.height * component.verticalSamplingFactor + vMaxFactor - 1) / vMaxFactor;
+            blocksPerLine = (componentWidth + 7) / 8;
+            mcuCount = blocksPerLine * ((componentHeight + 7) / 8);
+        }
+
+        BitStreamReader reader(scan.ecs);
+        std::array<int, 4> dcPred = {};
+        int eobRun = 0;
+
+        auto decodeBlockInScan = [&](const ScanComponent& component, int blockX, int blockY) {
+            auto& plane = planes[component.index];
+            const size_t i = static_cast<size_t>(blockY) * plane.blocksPerLine + blockX;
+            auto& block = plane.blocks[i];
+
+            if (isSequential) {
+                plane.lastIndices[i] = static_cast<uint8_t>(
+                    decodeBlock(reader, *component.table, *component.dht, *component.acTable, *component.acDHT, block, dcPred[component.index])
+                );
+                return;
+            }
+
+            if (isDC) {
+                if (isFirst) {
+                    decodeDCFirst(reader, *component.table, component.dht->symbols, block, dcPred[component.index], al);
+                }
+                else {
+                    decodeDCRefine(reader, block, al);
+                }
+                return;
+            }
+
+            const int lastIndex = isFirst
+                ? decodeACFirst(reader, *component.table, component.dht->symbols, block, ss, se, al, eobRun)
+                : decodeACRefine(reader, *component.table, component.dht->symbols, block, ss, se, al, eobRun);
+            plane.lastIndices[i] = std::max(plane.lastIndices[i], static_cast<uint8_t>(lastIndex));
+        };
+
+        for (int mcu = 0; mcu < mcuCount; ++mcu) {
+            if (!reader.hasMore()) {
+                break;
+            }
+
+            // リスタートマーカーで DC の予測値と EOBRUN をリセット
+            if (scan.restartInterval > 0 && mcu != 0 && mcu % scan.restartInterval == 0) {
+                uint8_t marker = reader.readMarker();
+                if (marker < 0xD0 || marker > 0xD7) {
+                    std::println("Invalid restart marker: 0xFF{:02X}", marker);
+                    return false;
+                }
+                dcPred = {};
+                eobRun = 0;
+            }
+
+            if (!isInterleaved) {
+                decodeBlockInScan(components[0], mcu % blocksPerLine, mcu / blocksPerLine);
+                continue;
+            }
+
+            const int mcuX = mcu % context.mcuHorizontalCount;
+            const int mcuY = mcu / context.mcuHorizontalCount;
+            for (const auto& component : components) {
+                const auto& frameComponent = sof0.components[component.index];
+                const int h = frameComponent.horizonalSamplingFactor;
+                const int v = frameComponent.verticalSamplingFactor;
+                for (int blockRow = 0; blockRow < v; ++blockRow) {
+                    for (int blockCol = 0; blockCol < h; ++blockCol) {
+                        decodeBlockInScan(component, mcuX * h + blockCol, mcuY * v + blockRow);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void JpegDecoder::decodeDCFirst(
+        BitStreamReader& reader,
+        const HuffmanTable& table,
+        const std::vector<uint8_t>& symbols,
+        MCUBlock8x8& block,
+        int& pred,
+        int al
+    )
+    {
+        // 差分の符号化はベースラインと同じで、最後に Al ビットずらす
+        block[0] = static_cast<int16_t>(decodeDCCoef(reader, table, symbols, pred) * (1 << al));
+    }
+
+    void JpegDecoder::decodeDCRefine(BitStreamReader& reader, MCUBlock8x8& block, int al)
+    {
+        if (reader.getBits(1) != 0) {
+            block[0] = static_cast<int16_t>(block[0] | (1 << al));
+        }
+    }
+
+    int JpegDecoder::decodeACFirst(
+        BitStreamReader& reader,
+        const HuffmanTable& table,
+        const std::vector<uint8_t>& symbols,
+        MCUBlock8x8& block,
+        int ss,
+        int se,
+        int al,
+        int& eobRun
+    )
+    {
+        if (eobRun > 0) {
+            --eobRun;
+            return 0;
+        }
+
+        int lastIndex = 0;
+        for (int k = ss; k <= se; ++k) {
+            // 符号と付加ビットが先読みの範囲に収まっていれば、表引きだけで係数が求まる
+            // (EOBRUN の符号は付加ビットが無い扱いなので、先読みテーブルには登録されていない)
+            int look = reader.peekBits(HuffmanTable::LOOKAHEAD_BITS);
+            if (const auto& entry = table.acLookup[look]; entry.length != 0) {
+                reader.skipBits(entry.length);
+                k += entry.run;
+                if (k > se) {
+                    break;
+                }
+                lastIndex = k;
+                block[k] = static_cast<int16_t>(entry.value * (1 << al));
+                continue;
+            }
+
+            int symbol = decodeHuffmanSymbol(reader, table, symbols);
+            int rrrr = symbol >> 4;
+            int ssss = symbol & 0x0F;
+
+            if (ssss == 0) {
+                if (rrrr == 15) {
+                    k += 15; // ZRL (16個目のゼロは for の ++k)
+                    continue;
+                }
+                // G.1.2.2 EOBn: このブロックの残りと、続く 2^r - 1 + 付加ビット個のブロックは全て 0
+                eobRun = (1 << rrrr) - 1;
+                if (rrrr > 0) {
+                    eobRun += static_cast<int>(reader.getBits(rrrr));
+                }
+                break;
+            }
+
+            k += rrrr;
+            if (k > se) {
+                break;
+            }
+            lastIndex = k;
+            block[k] = static_cast<int16_t>(decodeZZ(reader, ssss) * (1 << al));
+        }
+
+        return lastIndex;
+    }
+
+    int JpegDecoder::decodeACRefine(
+        BitStreamReader& reader,
+        const HuffmanTable& table,
+        const std::vector<uint8_t>& symbols,
+        MCUBlock8x8& block,
+        int ss,
+        int se,
+        int al,
+        int& eobRun
+    )
+    {
+        const int p1 = 1 << al;
+
+        // 既に非ゼロの係数は、補正ビットが 1 なら絶対値に 1 << al を足す
+        auto refine = [&](int16_t& coef) {
+            if (reader.getBits(1) != 0 && (coef & p1) == 0) {
+                coef = static_cast<int16_t>(coef + (coef >= 0 ? p1 : -p1));
+            }
+        };
+
+        int k = ss;
+        int lastIndex = 0;
+
+        if (eobRun == 0) {
+            for (; k <= se; ++k) {
+                int symbol = decodeHuffmanSymbol(reader, table, symbols);
+                int rrrr = symbol >> 4;
+                int ssss = symbol & 0x0F;
+                int value = 0;
+
+                if (ssss != 0) {
+                    // 新たに非ゼロになる係数は大きさが 1 << al に決まっているので、符号の1ビットだけ続く
+                    value = reader.getBits(1) != 0 ? p1 : -p1;
+                }
+                else if (rrrr != 15) {
+                    // EOBn: 残りの係数は補正ビットだけ (下の eobRun の処理で読む)
+                    eobRun = 1 << rrrr;
+                    if (rrrr > 0) {
+                        eobRun += static_cast<int>(reader.getBits(rrrr));
+                    }
+                    break;
+                }
+
+                // ゼロの係数を rrrr 個飛ばして、その次のゼロの係数の位置まで進める
+                // 途中の非ゼロの係数は数えずに、補正ビットを読む (ZRL なら 16 個目のゼロで止まる)
+                for (; k <= se; ++k) {
+                    auto& coef = block[k];
+                    if (coef != 0) {
+                        refine(coef);
+                    }
+                    else {
+                        if (rrrr == 0) {
+                            break;
+                        }
+                        --rrrr;
+                    }
+                }
+
+                if (value != 0 && k <= se) {
+                    lastIndex = k;
+                    block[k] = static_cast<int16_t>(value);
+                }
+            }
+        }
+
+        if (eobRun > 0) {
+            for (; k <= se; ++k) {
+                if (auto& coef = block[k]; coef != 0) {
+                    refine(coef);
+                }
+            }
+            --eobRun;
+        }
+
+        return lastIndex;
+    }
+
+    void JpegDecoder::gatherMCUCoefs(
+        const ScanContext& context,
+        const std::vector<CoefficientPlane>& planes,
+        int firstMCU,
+        int mcuCount,
+        std::span<MCUBlock8x8> coefs,
+        std::span<uint8_t> lastIndices
+    )
+    {
+        const auto& sof0 = context.sof0;
+        auto coef = coefs.begin();
+        auto lastIndex = lastIndices.begin();
+
+        for (int mcu = firstMCU; mcu < firstMCU + mcuCount; ++mcu) {
+            const int mcuX = mcu % context.mcuHorizontalCount;
+            const int mcuY = mcu / context.mcuHorizontalCount;
+
+            for (size_t i = 0; i < sof0.components.size(); ++i) {
+                const auto& component = sof0.components[i];
+                const auto& plane = planes[i];
+                const int h = component.horizonalSamplingFactor;
+                const int v = component.verticalSamplingFactor;
+
+                for (int blockRow = 0; blockRow < v; ++blockRow) {
+                    const size_t first = static_cast<size_t>(mcuY * v + blockRow) * plane.blocksPerLine + mcuX * h;
+                    coef = std::copy_n(plane.blocks.begin() + first, h, coef);
+                    lastIndex = std::copy_n(plane.lastIndices.begin() + first, h, lastIndex);
+                }
+            }
+        }
+    }
+
+    int JpegDecoder::createHuffSize(const std::array<uint8_t, 16>& counts, HuffmanCodeArray& huffSize)
+    {
+        int k = 0;
+        for (int bits = 1; bits <= static_cast<int>(counts.size()); ++bits) {
+            if (k + counts[bits - 1] > MAX_HUFFMAN_CODE_COUNT) {
+                return -1;
+            }
+            for (int count = 0; count < counts[bits - 1]; ++count) {
+                huffSize[k++] = bits;
+            }
+        }
+        return k;
+    }
+
+    void JpegDecoder::createHuffCode(std::span<const int> huffSize, HuffmanCodeArray& huffCode)
+    {
+        assert(!huffSize.empty());
+
+        int code = 0;
+        int si = huffSize[0];
+
+        for (size_t i = 0; i < huffSize.size(); ++i) {
+            int bits = huffSize[i];
+
+            if (bits == 0) {
+                break;
+            }
+
+            if (bits != si) {
+                code <<= (bits - si);
+                si = bits;
+            }
+
+            huffCode[i] = code;
+            code++;
+        }
+    }
+
+    HuffmanTable JpegDecoder::createHuffmanTable(const std::array<uint8_t, 16>& counts, const std::vector<uint8_t>& symbols)
+    {
+        // テーブルを作るたびにヒープを確保しないように、符号の数の上限の固定長配列を使う
+        HuffmanCodeArray huffSize;
+        HuffmanCodeArray huffCode;
+        const int codeCount = createHuffSize(counts, huffSize);
+        if (codeCount <= 0) {
+            // 符号が無いか多すぎる壊れたテーブル (どの符号にも一致しない)
+            return {};
+        }
+        createHuffCode(std::span{ huffSize }.first(codeCount), huffCode);
+
+        HuffmanTable table{};
+
+        int j = 0;
+        for (size_t i = 0; i < 16; ++i) {
+            auto bit = counts[i];
+            if (bit == 0) {
+                continue;
+            }
+            table.valPtr[i] = j;
+            table.minCode[i] = huffCode[j];
+            j += bit - 1;
+            table.maxCode[i] = huffCode[j];
+            ++j;
+        }
+
+        // 先読みテーブル
+        // 符号長 LOOKAHEAD_BITS 以下の符号について、符号を上位ビットに置いた全ての組み合わせに同じ値を登録する
+        constexpr int lookaheadBits = HuffmanTable::LOOKAHEAD_BITS;
+
+        for (size_t k = 0; k < static_cast<size_t>(codeCount) && k < symbols.size(); ++k) {
+            int size = huffSize[k];
+            if (size > lookaheadBits) {
+                break;
+            }
+
+            uint8_t symbol = symbols[k];
+            int shift = lookaheadBits - size;
+            int first = huffCode[k] << shift;
+            int last = first | ((1 << shift) - 1);
+
+            for (int look = first; look <= last; ++look) {
+                table.lookupLength[look] = static_cast<uint8_t>(size);
+                table.lookupSymbol[look] = symbol;
+
+                // AC 係数の場合は付加ビットまで先読みの範囲に収まれば、係数値まで求めておく
+                int rrrr = symbol >> 4;
+                int ssss = symbol & 0x0F;
+                if (ssss == 0 || size + ssss > lookaheadBits) {
+                    continue;
+                }
+                int extraBits = (look >> (shift - ssss)) & ((1 << ssss) - 1);
+                auto& entry = table.acLookup[look];
+                entry.value = static_cast<int16_t>(extend(extraBits, ssss));
+                entry.run = static_cast<uint8_t>(rrrr);
+                entry.length = static_cast<uint8_t>(size + ssss);
+            }
+        }
+
+        return table;
+    }
+
+    std::shared_ptr<const HuffmanTable> JpegDecoder::getHuffmanTable(const DHT& dht)
+    {
+        if (auto table = m_Context->findHuffmanTable(dht)) {
+            return table;
+        }
+        auto table = std::make_shared<const HuffmanTable>(createHuffmanTable(dht.counts, dht.symbols));
+        m_Context->addHuffmanTable(dht, table);
+        return table;
+    }
+
+    int JpegDecoder::decodeHuffmanSymbol(BitStreamReader& reader, const HuffmanTable& table, const std::vector<uint8_t>& symbols)
+    {
+        constexpr int lookaheadBits = HuffmanTable::LOOKAHEAD_BITS;
+
+        int look = reader.peekBits(lookaheadBits);
+        if (int size = table.lookupLength[look]; size != 0) {
+            reader.skipBits(size);
+            return table.lookupSymbol[look];
+        }
+
+        // 先読みテーブルに無い長い符号は、LOOKAHEAD_BITS ビットより先を 1ビットずつ辿る
+        reader.skipBits(lookaheadBits);
+        int code = look;
+        int i = lookaheadBits;
+
+        for (; i < 16; ++i) {
+            code = (code << 1) | reader.nextBit();
+            if (code <= table.maxCode[i]) {
+                break;
+            }
+        }
+
+        if (i >= 16) {
+            // どの符号にも一致しない (壊れたデータ)
+            reader.setCorrupted();
+            return 0;
+        }
+
+        int j = table.valPtr[i];
+        j = j + code - table.minCode[i];
+        int value = symbols[j];
+        return value;
+    }
+
+    inline int JpegDecoder::decodeZZ(BitStreamReader& reader, int ssss)
+    {
+        int value = reader.receive(ssss);
+        return extend(value, ssss);
+    }
+
+    int JpegDecoder::decodeACCoefs(
+        BitStreamReader& reader,
+        const HuffmanTable& table,
+        const std::vector<uint8_t>& symbols,
+        MCUBlock8x8& block
+    )
+    {
+        int k = 1; // DC係数は既にデコード済みなので、kを1から開始
+        int lastIndex = 0;
+
+        while (k < 64) {
+            // 符号と付加ビットが先読みの範囲に収まっていれば、表引きだけで係数が求まる
+            int look = reader.peekBits(HuffmanTable::LOOKAHEAD_BITS);
+            if (const auto& entry = table.acLookup[look]; entry.length != 0) {
+                reader.skipBits(entry.length);
+                k += entry.run;
+                if (k >= 64) {
+                    // ブロックの外まで続くランレングス (壊れたデータ)
+                    reader.setCorrupted();
+                    break;
+                }
+                lastIndex = k;
+                block[k++] = entry.value;
+                continue;
+            }
+
+            int symbol = decodeHuffmanSymbol(reader, table, symbols);
+            if (symbol == 0) {
+                break; // EOBマーカー
+            }
+
+            int rrrr = symbol >> 4;   // ランレングス（連続するゼロの個数）
+            int ssss = symbol & 0x0F; // 非ゼロ係数のビット長
+
+            if (ssss == 0) {
+                if (rrrr == 15) {
+                    k += 16; // ZRL（16個のゼロ）
+                }
+                else {
+                    break; // 他に非ゼロ係数はない
+                }
+            }
+            else {
+                k += rrrr; // ランレングス分インデックスを進める
+                if (k >= 64) {
+                    reader.setCorrupted();
+                    break;
+                }
+                // decodeZZ や receive 時点で int16_t にしてもいいかもしれない
+                lastIndex = k;
+                block[k++] = static_cast<int16_t>(decodeZZ(reader, ssss));
+            }
+        }
+
+        return lastIndex;
+    }
+
+    int JpegDecoder::decodeDCCoef(BitStreamReader& reader, const HuffmanTable& table, const std::vector<uint8_t>& symbols, int& pred)
+    {
+        int symbol = decodeHuffmanSymbol(reader, table, symbols);
+        if (symbol > 11) {
+            // 8 ビット精度の DC の差分は 11 ビットまで (壊れたデータか、壊れたテーブル)
+            reader.setCorrupted();
+            symbol = 0;
+        }
+        int diff = (symbol == 0) ? 0 : extend(reader.receive(symbol), symbol);
+        int dcCoef = pred + diff;
+        pred = dcCoef;
+        return dcCoef;
+    }
+
+    int JpegDecoder::decodeBlock(
+        BitStreamReader& reader,
+        const HuffmanTable& dcTable,
+        const DHT& dcDHT,
+        const HuffmanTable& acTable,
+        const DHT& acDHT,
+        MCUBlock8x8& block,
+        int& dcPred
+    )
+    {
+        // TODO: すごく雑に int -> int16_t にしているので、全体的にどうするか考える
+        block[0] = static_cast<int16_t>(decodeDCCoef(reader, dcTable, dcDHT.symbols, dcPred));
+        return decodeACCoefs(reader, acTable, acDHT.symbols, block);
+    }
+} // namespace RagiMagick2::Image::Jpeg
@@ -1,88 +1,501 @@
-﻿#pragma once
-#include <array>
-#include <cstdint>
-#include <memory>
-#include <string_view>
-#include <vector>
-#include "Image/Jpeg/BitStreamReader.h"
-#include "Image/Jpeg/Syntax/Segment.h"
-#include "Image/Jpeg/Parser/JpegParser.h"
-#include "Image/Jpeg/Decoder/Common.h"
-
-namespace RagiMagick2::Image::Jpeg
-{
-    struct DecodeResult
-    {
-        int width;
-        int height;
-        std::vector<uint8_t> pixels;
-    };
-
-    class JpegDecoder final
-    {
-    public:
-        JpegDecoder(std::string_view fileName);
-        ~JpegDecoder();
-
-        void decode(DecodeResult& result);
-
-    private:
-        struct HuffmanTable
-        {
-            std::array<int, 16> minCode{};
-            std::array<int, 16> maxCode{};
-            std::array<int, 16> valPtr{};
-
-            HuffmanTable()
-            {
-                maxCode.fill(-1);
-            }
-        };
-
-        // Figure C.1 – Generation of table of Huffman code sizes
-        // counts (BITS) には、各ビット長(1～16)のハフマン符号の数が格納されている。
-        // 例えば、 counts[] = { 0, 5, 1, 1 } の場合、
-        // ハフマン符号のビット長は 1ビットが5つ、2ビットが1つ、3ビットが1つとなる。
-        // input: counts[0] = 0, counts[1] = 5, counts[2] = 1, counts[3] = 1
-        // output: { 1, 1, 1, 1, 1, 2, 3 }
-        std::vector<int> createHuffSize(const std::array<uint8_t, 16>& counts);
-
-        // Figure C.2 – Generation of table of Huffman codes
-        // ハフマン符号のビット長からハフマン符号を生成する。
-        // 例えば、 huffSize[] = { 2, 2, 3, 3, 3, 5 } の場合、
-        // ハフマン符号は { 00, 01, 100, 101, 110, 11111 } となる。
-        std::vector<int> createHuffCode(const std::vector<int>& huffSize);
-
-        HuffmanTable createHuffmanTable(const std::array<uint8_t, 16>& counts);
-
-        // Figure F.16 – Procedure for DECODE
-        int decodeHuffmanSymbol(HuffmanTable& table, const std::vector<uint8_t>& symbols);
-
-        // Figure F.14 – Decoding a non-zero AC coefficient
-        inline int decodeZZ(int ssss);
-
-        // Figure F.13 – Huffman decoding procedure for AC coefficients
-        void decodeACCoefs(
-            HuffmanTable& table,
-            const std::vector<uint8_t>& symbols,
-            MCUBlock8x8& block
-        );
-
-        // F.2.2.1 Huffman decoding of DC coefficients
-        int decodeDCCoef(HuffmanTable& table, const std::vector<uint8_t>& symbols, int& pred);
-
-        void decodeBlock(
-            HuffmanTable& dcTable,
-            std::shared_ptr<Syntax::DHT> dcDHT,
-            HuffmanTable& acTable,
-            std::shared_ptr<Syntax::DHT> acDHT,
-            std::shared_ptr<Syntax::DQT> dqt,
-            MCUBlock8x8& block,
-            int& dcPred
-        );
-    private:
-        JpegParser m_Parser;
-        std::unique_ptr<BitStreamReader> m_BitStreamReader;
-    };
-
-} // namespace RagiMagick2::Image::Jpeg
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "Image/Jpeg/BitStreamReader.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+#include "Image/Jpeg/Parser/JpegParser.h"
+#include "Image/Jpeg/Decoder/Common.h"
+#include "Image/Jpeg/Decoder/JpegDecoderContext.h"
+#include "Image/Jpeg/Decoder/YCbCrComponents.h"
+#include "Image/Math/IDCT.h"
+#include "Image/Pixel/PixelFormat.h"
+#include "Image/Pixel/PixelOrientation.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    struct DecodeResult
+    {
+        int width;
+        int height;
+        std::vector<uint8_t> pixels;
+    };
+
+    // 縮小デコードの倍率
+    enum class DecodeScale
+    {
+        Full,       // 1/1
+        Half,       // 1/2
+        Quarter,    // 1/4
+        Eighth,     // 1/8 (DC 係数のみ)
+    };
+
+    // 4:2:0 の色差の拡大方法
+    enum class ChromaUpsampling
+    {
+        Nearest,    // 最近傍 (色差を 2x2 に複製する)
+        Fancy,      // libjpeg の fancy upsampling と同じ三角フィルタ (縦横とも 3:1 で近い方の色差と混ぜる)
+    };
+
+    // 壊れたデータを見つけた場合の扱い
+    enum class ErrorConcealment
+    {
+        None,           // 何もしない (リスタートマーカーが見つからなければデコードを中止する)
+        Gray,           // 壊れた MCU からリスタート区間の終わりまでを灰色で埋めて、次のリスタートマーカーから続ける
+        PreviousRow,    // Gray と同じだが、1つ上の MCU 行の係数で埋める (上の行が無ければ灰色)
+    };
+
+    // エラー耐性のあるデコードで、壊れていたので埋めた MCU の範囲
+    // MCU の番号はスキャン先頭からのラスター順 (1 MCU 行の MCU の数は、幅を MCU の幅で割って切り上げたもの)
+    struct DamagedMCURange
+    {
+        int firstMCU;
+        int mcuCount;
+    };
+
+    // プログレッシブ JPEG の途中経過
+    struct ProgressivePreview
+    {
+        // デコードし終わったスキャンの数と、全スキャンの数
+        int scanCount;
+        int totalScanCount;
+        // 出力画像のサイズ
+        int width;
+        int height;
+        // width * height の出力と同じピクセル形式 (パディング無し)
+        // コールバックから戻った後は書き換えられるので、必要ならコピーすること
+        std::span<const uint8_t> pixels;
+    };
+
+    using PreviewCallback = std::function<void(const ProgressivePreview& preview)>;
+
+    struct DecodeOptions
+    {
+        // リスタートマーカーがある場合、リスタート区間ごとに並列にデコードする
+        // Common::ThreadPool::shared() のタスクの中でデコードする場合は、ワーカーを待たせないように false と同じく呼び出し元のスレッドだけで処理する
+        bool useMultiThreading = true;
+        // 縮小 IDCT で出力サイズを小さくする (サイズは切り上げ)
+        DecodeScale scale = DecodeScale::Full;
+        // プログレッシブ JPEG の場合、最後以外のスキャンをデコードするたびに、その時点の画像を渡す
+        // 係数から画像全体を作り直すので、指定するとその分遅くなる
+        // 平面 YUV で出力する場合は呼ばない
+        PreviewCallback previewCallback{};
+        // 4:2:0 を BGRA32 で出力する場合の色差の拡大方法 (それ以外のサンプリングや出力形式では最近傍)
+        // Fancy の場合は上下の MCU 行も必要なので、リスタート区間ごとの並列デコードは行わない
+        ChromaUpsampling chromaUpsampling = ChromaUpsampling::Nearest;
+        // true なら EXIF の Orientation に従って、表示の向きに回転・反転して出力する
+        // 色変換した MCU 行を、出力先の回転後の位置にタイルごとに書き込むので、画像全体を回転し直す処理やバッファは要らない
+        // 出力サイズと region は回転後の座標になる (行ごとに渡す decode と平面 YUV の decode では無視する)
+        bool applyExifOrientation = false;
+        // None 以外なら、壊れたデータを見つけてもデコードを続ける (埋めた範囲は getDamagedMCURanges で分かる)
+        // 壊れたリスタート区間は、次のリスタートマーカー (RSTn の番号で区間の位置を合わせ直す) から読み直す
+        // リスタートマーカーが無い画像は、壊れた MCU から最後までを埋める
+        // 壊れていないデータは、 None と同じ経路 (リスタート区間ごとの並列デコードを含む) でデコードする
+        // ベースラインで1スキャンの画像だけに対応し、プログレッシブ JPEG では何もしない
+        ErrorConcealment errorConcealment = ErrorConcealment::None;
+    };
+
+    // デコードする範囲 (出力画像の座標、縮小デコードの場合は縮小後の座標)
+    struct DecodeRegion
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // ストリーミングデコードで、コールバックに渡される行
+    struct DecodedRows
+    {
+        // 出力画像全体のサイズ
+        int width;
+        int height;
+        // pixels の先頭の行が何行目か
+        int firstLine;
+        int lineCount;
+        // lineCount 行分の BGRA32 (1行 width * 4 バイト、パディング無し)
+        // コールバックから戻った後は書き換えられるので、必要ならコピーすること
+        std::span<const uint8_t> pixels;
+    };
+
+    // 平面 YUV の出力先 (planes[0] が Y、 planes[1], planes[2] が Cb, Cr)
+    // n 行目は planes[i][n * strides[i]] から始まる
+    // 4:2:0 の場合、 Cb, Cr のプレーンの大きさは Y の幅・高さの半分を切り上げたもの
+    struct PlanarBuffer
+    {
+        std::array<std::span<uint8_t>, 3> planes;
+        std::array<size_t, 3> strides;
+    };
+
+    // 上の行から順に1回ずつ、同時に複数呼ばれることはない
+    // useMultiThreading が true の場合、スレッドプールのスレッドから呼ばれることがある
+    using RowCallback = std::function<void(const DecodedRows& rows)>;
+
+    // IDCT する前の、エントロピー復号しただけの画像 (ロスレス変換で使う)
+    struct CoefficientImage
+    {
+        // SOF のコピー (1成分だけの画像は、サンプリングファクタを 1x1 に直したもの)
+        Syntax::SOF0 sof0{};
+        // DQT の量子化テーブル (自然順、 sof0 の各成分の tableID で引く)
+        std::array<Math::IDCT::QuantTable, 4> quantTables{};
+        int mcuHorizontalCount = 0;
+        int mcuVerticalCount = 0;
+        // sof0.components の順
+        std::vector<CoefficientPlane> planes;
+        // EXIF の Orientation (1～8、 EXIF が無ければ 1)
+        int orientation = 1;
+        // JpegParser::getMetadataSegments (デコーダのデータをそのまま指すので、デコーダを使い終わるまで有効)
+        std::vector<std::span<const uint8_t>> metadataSegments;
+    };
+
+    class JpegDecoder final
+    {
+    public:
+        JpegDecoder(std::string_view fileName);
+        // メモリ上の JPEG をコピーせずにデコードする (data はデコーダを使い終わるまで有効であること)
+        JpegDecoder(std::span<const uint8_t> data);
+        // 複数の画像を続けてデコードする場合は、同じ context を渡すとテーブルとバッファを使い回す
+        // context はデコーダを使い終わるまで有効であること
+        JpegDecoder(std::string_view fileName, JpegDecoderContext& context);
+        JpegDecoder(std::span<const uint8_t> data, JpegDecoderContext& context);
+        ~JpegDecoder();
+
+        void decode(DecodeResult& result, const DecodeOptions& options = {});
+
+        // region と重なる MCU だけ IDCT と色変換を行い、 region の範囲を切り出して返す
+        // region は画像の範囲に切り詰める
+        // エントロピー復号は region より前の MCU も必要だが、リスタートマーカーがあれば region を含む区間から始める
+        void decode(DecodeResult& result, const DecodeRegion& region, const DecodeOptions& options = {});
+
+        // 画像全体のバッファを確保せずに、 MCU 行ごとにデコードできた行を callback に渡す
+        // 使うメモリは MCU 行数行分で、最後までデコードできた場合は true を返す
+        bool decode(const RowCallback& callback, const DecodeOptions& options = {});
+
+        // 呼び出し元が確保したバッファ dst に直接デコードする (画像全体の中間バッファは確保しない)
+        // n 行目は dst[n * stride] から始まるので、 stride を揃えればアライメントされた行にも書き込める
+        // stride は幅 * 1ピクセルのバイト数以上、 dst は stride * (高さ - 1) + 1行のバイト数以上必要 (サイズは getOutputSize で分かる)
+        // format は B8G8R8A8_UINT, R8G8B8A8_UINT, R8G8B8_UINT, B8G8R8_UINT と R8_UINT に対応
+        // R8_UINT の場合は色変換せずに Y をそのまま書き込む (カラー画像の場合、色差の IDCT も省く)
+        bool decode(std::span<uint8_t> dst, size_t stride, Pixel::PixelFormat format, const DecodeOptions& options = {});
+
+        // 色変換せずに、 8bit の平面 YUV で dst に直接デコードする
+        // format は YCBCR444_UINT か YCBCR420_UINT で、画像のサンプリングと一致していること (拡大・縮小はしない)
+        // 各プレーンの stride はそのプレーンの幅以上で、 Y のプレーンの大きさは getOutputSize で分かる
+        bool decode(const PlanarBuffer& dst, Pixel::PixelFormat format, const DecodeOptions& options = {});
+
+        // IDCT と色変換をせずに、全てのスキャンを画像全体の係数に復号する
+        // プログレッシブ JPEG も、全てのスキャンを足し込んだ最終的な係数になる
+        bool decodeCoefficients(CoefficientImage& result);
+
+        // options でデコードした場合の出力画像のサイズ (幅, 高さ) を返す
+        // applyExifOrientation が true で、 EXIF で 90 度回転する画像なら幅と高さが入れ替わる
+        // 対応していない画像の場合は std::nullopt
+        std::optional<std::tuple<int, int>> getOutputSize(const DecodeOptions& options = {});
+
+        // 直前のデコードで、 errorConcealment に従って埋めた MCU の範囲 (壊れていなければ空)
+        const std::vector<DamagedMCURange>& getDamagedMCURanges() const noexcept;
+
+    private:
+        // DHT は JpegParser の SegmentIndex を指す
+        // テーブルは JpegDecoderContext のキャッシュと共有する
+        using TableInfo = std::tuple<std::shared_ptr<const HuffmanTable>, const Syntax::DHT*>;
+
+        // スキャンのデコード中に参照するテーブル類
+        // 複数スレッドから同時に参照されるので、デコード中は変更しないこと
+        struct ScanContext
+        {
+            // SOF のコピー
+            // 1成分だけの画像は MCU が1ブロックなので、サンプリングファクタを 1x1 に直しておく
+            Syntax::SOF0 sof0{};
+            // DQT から作った逆量子化テーブル (自然順)
+            std::array<Math::IDCT::QuantTable, 4> quantTables{};
+            std::array<TableInfo, 4> dcTables{};
+            std::array<TableInfo, 4> acTables{};
+            int mcuHorizontalCount = 0;
+            int mcuVerticalCount = 0;
+            // IDCT で出力する1ブロックの一辺 (縮小デコードの場合は 4, 2, 1)
+            int blockSize = 8;
+            // 出力する画像のサイズ
+            int width = 0;
+            int height = 0;
+            // 出力画像での 1 MCU のサイズ
+            int mcuWidth = 0;
+            int mcuHeight = 0;
+            // 出力する範囲 (指定が無ければ画像全体)
+            DecodeRegion region{};
+            // 1 MCU あたりのブロック数 (4:2:0 なら 6, 4:4:4 なら 3)
+            int blocksPerMCU = 0;
+            // DRI のリスタート間隔 (DRI が無ければ 0)
+            int restartInterval = 0;
+            // sof0.components の順に、最初の SOS で指定された DC, AC のハフマンテーブル ID
+            std::array<uint8_t, 4> dcSelectors{};
+            std::array<uint8_t, 4> acSelectors{};
+            // SOF2 なら true (テーブルはスキャンごとに作るので、 dcTables, acTables は使わない)
+            bool isProgressive = false;
+            // ベースラインで成分ごとにスキャンが分かれている場合は true (プログレッシブと同じく画像全体の係数に復号する)
+            bool isMultiScan = false;
+            // 出力するピクセル形式 (isRGBFormat か R8_UINT、平面 YUV の場合は YCBCR444_UINT か YCBCR420_UINT)
+            Pixel::PixelFormat outputFormat = Pixel::PixelFormat::B8G8R8A8_UINT;
+            int bytesPerPixel = 4;
+            // 平面 YUV で出力する場合の出力先 (dst の代わりに使う)
+            PlanarBuffer planes{};
+            // 4:2:0 の色差を三角フィルタで拡大する場合は true
+            bool useFancyUpsampling = false;
+            // 出力するときの向き (region は回転前の座標で、出力先は region を回転した大きさ)
+            Pixel::Orientation orientation{};
+            // 壊れたデータを見つけた場合の扱い
+            ErrorConcealment errorConcealment = ErrorConcealment::None;
+
+            // 出力する範囲を回転した後のサイズ (幅, 高さ)
+            std::tuple<int, int> getOutputSize() const noexcept
+            {
+                return Pixel::getOrientedSize(region.width, region.height, orientation);
+            }
+        };
+
+        // パイプラインで使う MCU 行バッファの数
+        static constexpr int MCU_ROW_BUFFER_COUNT = 4;
+
+        // MCU 行の係数を用意する関数
+        // firstMCU 番目から mcuCount 個の MCU の係数と最後の非ゼロ係数の位置を、
+        // decodeMCUCoefs と同じ並びで coefs と lastIndices に書き込む
+        using CoefficientSource = std::function<bool(int firstMCU, int mcuCount, std::span<MCUBlock8x8> coefs, std::span<uint8_t> lastIndices)>;
+
+        // ファイルを解析する (2回目以降は最初の結果を返す)
+        bool parse();
+
+        // デコードに必要なテーブルと出力サイズを求めて context に設定する
+        // region が指定されていれば、画像の範囲に切り詰めて context.region に設定する
+        // 対応していない画像や、 region が画像と重ならない場合は false を返す
+        bool prepareScan(
+            ScanContext& context,
+            const std::optional<DecodeRegion>& region,
+            const DecodeOptions& options,
+            Pixel::PixelFormat format = Pixel::PixelFormat::B8G8R8A8_UINT
+        );
+
+        // context.region の出力に必要な MCU 行の範囲 (最初の行, 最後の行)
+        // 色差を三角フィルタで拡大する場合は、出力範囲の上下の MCU 行も含める
+        std::tuple<int, int> getMCURowRange(const ScanContext& context);
+
+        // context.region の範囲をデコードして、 dst (1行 stride バイト) に書き込むか callback に渡す
+        bool decodeScan(
+            const ScanContext& context,
+            const DecodeOptions& options,
+            std::span<uint8_t> dst,
+            size_t stride,
+            const RowCallback& callback
+        );
+
+        // 1つのハフマンテーブルに含まれる符号の最大数 (シンボルは 8 ビットなので 256 個まで)
+        static constexpr int MAX_HUFFMAN_CODE_COUNT = 256;
+        using HuffmanCodeArray = std::array<int, MAX_HUFFMAN_CODE_COUNT>;
+
+        // Figure C.1 – Generation of table of Huffman code sizes
+        // counts (BITS) には、各ビット長(1～16)のハフマン符号の数が格納されている。
+        // 例えば、 counts[] = { 0, 5, 1, 1 } の場合、
+        // ハフマン符号のビット長は 1ビットが5つ、2ビットが1つ、3ビットが1つとなる。
+        // input: counts[0] = 0, counts[1] = 5, counts[2] = 1, counts[3] = 1
+        // output: { 1, 1, 1, 1, 1, 2, 3 }
+        // huffSize に書き込んだ符号の数を返す (MAX_HUFFMAN_CODE_COUNT を超える場合は -1)
+        int createHuffSize(const std::array<uint8_t, 16>& counts, HuffmanCodeArray& huffSize);
+
+        // Figure C.2 – Generation of table of Huffman codes
+        // ハフマン符号のビット長からハフマン符号を生成する。
+        // 例えば、 huffSize[] = { 2, 2, 3, 3, 3, 5 } の場合、
+        // ハフマン符号は { 00, 01, 100, 101, 110, 11111 } となる。
+        void createHuffCode(std::span<const int> huffSize, HuffmanCodeArray& huffCode);
+
+        // F.2.2.3 の MAXCODE, MINCODE, VALPTR に加えて、先読みテーブルを作る
+        HuffmanTable createHuffmanTable(const std::array<uint8_t, 16>& counts, const std::vector<uint8_t>& symbols);
+
+        // dht のテーブルを JpegDecoderContext のキャッシュから探して、無ければ作って登録する
+        std::shared_ptr<const HuffmanTable> getHuffmanTable(const Syntax::DHT& dht);
+
+        // Figure F.16 – Procedure for DECODE
+        int decodeHuffmanSymbol(BitStreamReader& reader, const HuffmanTable& table, const std::vector<uint8_t>& symbols);
+
+        // Figure F.14 – Decoding a non-zero AC coefficient
+        inline int decodeZZ(BitStreamReader& reader, int ssss);
+
+        // Figure F.13 – Huffman decoding procedure for AC coefficients
+        // 最後の非ゼロ係数の位置 (ジグザグ順、 AC 係数が全て 0 なら 0) を返す
+        int decodeACCoefs(
+            BitStreamReader& reader,
+            const HuffmanTable& table,
+            const std::vector<uint8_t>& symbols,
+            MCUBlock8x8& block
+        );
+
+        // F.2.2.1 Huffman decoding of DC coefficients
+        int decodeDCCoef(BitStreamReader& reader, const HuffmanTable& table, const std::vector<uint8_t>& symbols, int& pred);
+
+        // 1ブロック分の係数をエントロピー復号する (block はジグザグ順のまま)
+        // 最後の非ゼロ係数の位置を返す
+        int decodeBlock(
+            BitStreamReader& reader,
+            const HuffmanTable& dcTable,
+            const Syntax::DHT& dcDHT,
+            const HuffmanTable& acTable,
+            const Syntax::DHT& acDHT,
+            MCUBlock8x8& block,
+            int& dcPred
+        );
+
+        // スキャン先頭から数えて firstMCU 番目から mcuCount 個の MCU の係数をエントロピー復号して coefs に書き込む
+        // coefs には MCU 順、成分順に mcuCount * blocksPerMCU 個のブロックが並ぶ
+        // lastIndices には各ブロックの最後の非ゼロ係数の位置を書き込む
+        // restartInterval が 0 でなければ、その間隔でリスタートマーカーを読んで DC の予測値をリセットする
+        // データが途中で終わっている場合は、復号できなかったブロックを 0 にして false を返す
+        bool decodeMCUCoefs(
+            BitStreamReader& reader,
+            const ScanContext& context,
+            int firstMCU,
+            int mcuCount,
+            int restartInterval,
+            std::array<int, 4>& dcPred,
+            std::span<MCUBlock8x8> coefs,
+            std::span<uint8_t> lastIndices
+        );
+
+        // decodeMCUCoefs で復号した係数から IDCT でサンプル値を復元して ycc に書き込む
+        // ycc が firstMCURow 行目、 firstMCUColumn 列目の MCU から始まる場合は、その分ずらして書き込む
+        void reconstructMCUs(
+            const ScanContext& context,
+            std::span<const MCUBlock8x8> coefs,
+            std::span<const uint8_t> lastIndices,
+            int firstMCU,
+            int mcuCount,
+            YCbCrComponents& ycc,
+            int firstMCURow,
+            int firstMCUColumn
+        );
+
+        // MCU 行単位でデコードして、 context.region の範囲を dst (context.outputFormat、1行 dstStride バイト) に書き込む
+        // callback が空でなければ、 dst は使わずに行ごとに callback に渡す
+        // source には getMCURowRange の範囲の MCU 行を上から順に1行ずつ要求する
+        // source (エントロピー復号) は呼び出し元のスレッドで順に呼び、
+        // IDCT と色変換は useMultiThreading が true ならスレッドプールで並行して行う (スレッドプールのワーカーから呼ばれた場合を除く)
+        // 色差を三角フィルタで拡大する場合は、下の MCU 行の IDCT が終わってから色変換する
+        bool decodeMCURows(
+            const CoefficientSource& source,
+            const ScanContext& context,
+            std::span<uint8_t> dst,
+            size_t dstStride,
+            const RowCallback& callback,
+            bool useMultiThreading
+        );
+
+        // errorConcealment が None でない場合の decodeScan
+        // リスタート区間ごとに読み直して、壊れたデータを見つけたら区間の残りの MCU を埋めて m_DamagedMCURanges に記録する
+        bool decodeScanWithConcealment(
+            const ScanContext& context,
+            const DecodeOptions& options,
+            std::span<uint8_t> dst,
+            size_t stride,
+            const RowCallback& callback
+        );
+
+        // リスタート区間ごとに並列にデコードして、画像全体を dst (context.outputFormat、1行 dstStride バイト) に書き込む
+        // 各区間は自分の MCU 行分のサンプル値だけ持ち、自分の MCU の範囲を直接 dst に色変換する
+        // ECS 中のリスタートマーカーの数が合わない場合は false を返す (何もデコードしない)
+        // errorConcealment が None でなければ、壊れた区間がある場合も false を返す (書き込んだ dst は decodeScanWithConcealment で全て書き直す)
+        bool decodeRestartIntervalsInParallel(
+            std::span<const uint8_t> ecs,
+            const ScanContext& context,
+            std::span<uint8_t> dst,
+            size_t dstStride
+        );
+
+        // プログレッシブ JPEG (SOF2) や、成分ごとにスキャンが分かれたベースラインの全スキャンを画像全体の係数に復号してから、
+        // decodeMCURows で context.region の範囲を dst に書き込むか callback に渡す
+        bool decodeProgressive(
+            const ScanContext& context,
+            const DecodeOptions& options,
+            std::span<uint8_t> dst,
+            size_t stride,
+            const RowCallback& callback
+        );
+
+        // context の成分ごとに、画像全体の係数を 0 で初期化した CoefficientPlane を planes に用意する
+        // planes に前の画像のバッファが残っていれば、確保し直さずに再利用する
+        void createCoefficientPlanes(const ScanContext& context, std::vector<CoefficientPlane>& planes);
+
+        // G.1.2 Progressive encoding of DCT coefficients
+        // スキャン1つ分を復号して、 planes の係数に足し込む
+        // ベースラインのスキャンは、 Ss = 0, Se = 63 のスキャン1回で全ての係数を復号する
+        bool decodeProgressiveScan(
+            const ScanContext& context,
+            const SegmentIndex::Scan& scan,
+            std::vector<CoefficientPlane>& planes
+        );
+
+        // G.1.2.1 DC の最初のスキャン (Ah = 0)
+        void decodeDCFirst(
+            BitStreamReader& reader,
+            const HuffmanTable& table,
+            const std::vector<uint8_t>& symbols,
+            MCUBlock8x8& block,
+            int& pred,
+            int al
+        );
+
+        // G.1.2.1 DC の2回目以降のスキャン (Ah > 0)、1ビットずつ精度を上げる
+        void decodeDCRefine(BitStreamReader& reader, MCUBlock8x8& block, int al);
+
+        // G.1.2.2 AC の最初のスキャン (Ah = 0)
+        // eobRun は EOBRUN (残りのブロック数) で、 0 でなければ係数は全て 0 としてブロックを飛ばす
+        // 最後の非ゼロ係数の位置 (無ければ 0) を返す
+        int decodeACFirst(
+            BitStreamReader& reader,
+            const HuffmanTable& table,
+            const std::vector<uint8_t>& symbols,
+            MCUBlock8x8& block,
+            int ss,
+            int se,
+            int al,
+            int& eobRun
+        );
+
+        // G.1.2.3 AC の2回目以降のスキャン (Ah > 0)
+        // 既に非ゼロの係数には補正ビットを足し、新たに非ゼロになる係数 (大きさ 1 << al) を置く
+        // 新たに置いた最後の係数の位置 (無ければ 0) を返す
+        int decodeACRefine(
+            BitStreamReader& reader,
+            const HuffmanTable& table,
+            const std::vector<uint8_t>& symbols,
+            MCUBlock8x8& block,
+            int ss,
+            int se,
+            int al,
+            int& eobRun
+        );
+
+        // planes から firstMCU 番目から mcuCount 個の MCU の係数を、 decodeMCUCoefs と同じ並びで集める
+        void gatherMCUCoefs(
+            const ScanContext& context,
+            const std::vector<CoefficientPlane>& planes,
+            int firstMCU,
+            int mcuCount,
+            std::span<MCUBlock8x8> coefs,
+            std::span<uint8_t> lastIndices
+        );
+
+    private:
+        JpegParser m_Parser;
+        bool m_IsParsed = false;
+        bool m_IsParseSucceeded = false;
+        // context を渡されなかった場合は、このデコーダ専用のものを作る
+        std::unique_ptr<JpegDecoderContext> m_OwnedContext;
+        JpegDecoderContext* m_Context = nullptr;
+        // 直前のデコードで埋めた MCU の範囲
+        std::vector<DamagedMCURange> m_DamagedMCURanges;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,87 @@
+﻿#include "JpegDecoderContext.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Image/Jpeg/Syntax/Segment.h"
+
+namespace
+{
+    // FNV-1a (64 ビット)
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    inline uint64_t hash(uint64_t value, const uint8_t* data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; ++i) {
+            value ^= data[i];
+            value *= FNV_PRIME;
+        }
+        return value;
+    }
+
+    // DHT の BITS と HUFFVAL のハッシュ (Tc, Th はテーブルの中身に関係しないので含めない)
+    uint64_t getHash(const RagiMagick2::Image::Jpeg::Syntax::DHT& dht) noexcept
+    {
+        uint64_t value = hash(FNV_OFFSET_BASIS, dht.counts.data(), dht.counts.size());
+        return hash(value, dht.symbols.data(), dht.symbols.size());
+    }
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    JpegDecoderContext::JpegDecoderContext()
+    {
+    }
+
+    JpegDecoderContext::~JpegDecoderContext()
+    {
+    }
+
+    void JpegDecoderContext::reset()
+    {
+        m_RowBuffers.clear();
+        m_RowBuffers.shrink_to_fit();
+        m_CoefficientPlanes.clear();
+        m_CoefficientPlanes.shrink_to_fit();
+    }
+
+    void JpegDecoderContext::clear()
+    {
+        reset();
+        m_HuffmanTables.clear();
+        m_HuffmanTableCount = 0;
+    }
+
+    size_t JpegDecoderContext::getHuffmanTableCount() const noexcept
+    {
+        return m_HuffmanTableCount;
+    }
+
+    std::shared_ptr<const HuffmanTable> JpegDecoderContext::findHuffmanTable(const Syntax::DHT& dht) const
+    {
+        const auto it = m_HuffmanTables.find(getHash(dht));
+        if (it == m_HuffmanTables.end()) {
+            return nullptr;
+        }
+        for (const auto& entry : it->second) {
+            if (entry.counts == dht.counts && entry.symbols == dht.symbols) {
+                return entry.table;
+            }
+        }
+        return nullptr;
+    }
+
+    void JpegDecoderContext::addHuffmanTable(const Syntax::DHT& dht, std::shared_ptr<const HuffmanTable> table)
+    {
+        if (m_HuffmanTableCount >= MAX_HUFFMAN_TABLE_COUNT) {
+            // デコード中のテーブルは shared_ptr で持っているので、捨てても使っている間は残る
+            m_HuffmanTables.clear();
+            m_HuffmanTableCount = 0;
+        }
+        m_HuffmanTables[getHash(dht)].emplace_back(dht.counts, dht.symbols, std::move(table));
+        ++m_HuffmanTableCount;
+    }
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,129 @@
+﻿#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Image/Jpeg/Decoder/Common.h"
+#include "Image/Jpeg/Decoder/YCbCrComponents.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // F.2.2.3 の MAXCODE, MINCODE, VALPTR と、先読みテーブル
+    struct HuffmanTable
+    {
+        // 先読みするビット数
+        // ほとんどの符号はこのビット数に収まるので、1回の表引きでデコードできる
+        static constexpr int LOOKAHEAD_BITS = 9;
+        static constexpr int LOOKAHEAD_SIZE = 1 << LOOKAHEAD_BITS;
+
+        // AC 係数用の先読みテーブルの要素
+        // ハフマン符号と後続の付加ビットを合わせて LOOKAHEAD_BITS に収まる場合に使う
+        struct ACLookupEntry
+        {
+            // 係数値 (EXTEND 済み)
+            int16_t value = 0;
+            // ランレングス (RRRR)
+            uint8_t run = 0;
+            // ハフマン符号長 + 付加ビット長 (0 なら未登録)
+            uint8_t length = 0;
+        };
+
+        std::array<int, 16> minCode{};
+        std::array<int, 16> maxCode{};
+        std::array<int, 16> valPtr{};
+
+        // 先読みした LOOKAHEAD_BITS ビットで引く、符号長 (0 なら未登録) とシンボル
+        std::array<uint8_t, LOOKAHEAD_SIZE> lookupLength{};
+        std::array<uint8_t, LOOKAHEAD_SIZE> lookupSymbol{};
+        std::array<ACLookupEntry, LOOKAHEAD_SIZE> acLookup{};
+
+        HuffmanTable()
+        {
+            maxCode.fill(-1);
+        }
+    };
+
+    // 1 MCU 行分の係数とサンプル値
+    struct MCURowBuffer
+    {
+        std::vector<MCUBlock8x8> coefs;
+        // 各ブロックの最後の非ゼロ係数の位置 (ジグザグ順)
+        std::vector<uint8_t> lastIndices;
+        YCbCrComponents samples;
+        // コールバックに渡す行 (ストリーミングデコードの場合だけ使う)
+        std::vector<uint8_t> rows;
+        // 4:2:2 などの色差を拡大した1行分 (convertYCbCr の作業用)
+        std::vector<int16_t> upsampledRow;
+    };
+
+    // 画像全体の量子化された係数 (1成分分)
+    // MCU の倍数に切り上げた範囲のブロックをラスター順に並べる (係数はジグザグ順)
+    // 1ブロック 128 バイトなので、 4:2:0 の 4K 画像でも 25MB 程度で収まる
+    struct CoefficientPlane
+    {
+        int blocksPerLine = 0;
+        int blockLines = 0;
+        std::vector<MCUBlock8x8> blocks;
+        // 各ブロックの最後の非ゼロ係数の位置 (ジグザグ順)
+        std::vector<uint8_t> lastIndices;
+    };
+
+    class JpegDecoder;
+
+    // 複数の JPEG を続けてデコードする場合に、デコーダの間で使い回すテーブルとバッファ
+    // JpegDecoder に渡すと、 DHT の内容が同じハフマンテーブルは最初の1回だけ作り、
+    // MCU 行バッファやプログレッシブ JPEG の係数のバッファは前の画像で確保したものを再利用する。
+    // Annex K のテーブルを使う画像が続く場合、2枚目からはテーブルを作る処理が無くなる。
+    // 同時に複数のデコーダで使わないこと (並列にデコードする場合はスレッドごとに用意する)
+    // Common::ThreadPool::shared() のタスクの中でデコードする場合、そのデコードは呼び出し元のスレッドだけで行う
+    class JpegDecoderContext final
+    {
+    public:
+        JpegDecoderContext();
+        ~JpegDecoderContext();
+
+        JpegDecoderContext(const JpegDecoderContext&) = delete;
+        JpegDecoderContext& operator=(const JpegDecoderContext&) = delete;
+
+        // 再利用するバッファを解放する (ハフマンテーブルのキャッシュは残す)
+        // 大きな画像の後でメモリを返したい場合に呼ぶ
+        void reset();
+
+        // キャッシュしたハフマンテーブルも含めて全て解放する
+        void clear();
+
+        // キャッシュしているハフマンテーブルの数
+        size_t getHuffmanTableCount() const noexcept;
+
+    private:
+        friend class JpegDecoder;
+
+        // DHT の内容 (BITS と HUFFVAL) が同じテーブルを探す (無ければ nullptr)
+        std::shared_ptr<const HuffmanTable> findHuffmanTable(const Syntax::DHT& dht) const;
+        void addHuffmanTable(const Syntax::DHT& dht, std::shared_ptr<const HuffmanTable> table);
+
+    private:
+        struct HuffmanTableEntry
+        {
+            std::array<uint8_t, 16> counts{};
+            std::vector<uint8_t> symbols;
+            std::shared_ptr<const HuffmanTable> table;
+        };
+
+        // キャッシュするハフマンテーブルの上限 (画像ごとに最適化したテーブルが続いても増え続けないように、超えたら捨てる)
+        static constexpr size_t MAX_HUFFMAN_TABLE_COUNT = 64;
+
+        // DHT の内容のハッシュごとのテーブル (ハッシュが衝突した場合は内容で区別する)
+        std::unordered_map<uint64_t, std::vector<HuffmanTableEntry>> m_HuffmanTables;
+        size_t m_HuffmanTableCount = 0;
+
+        // JpegDecoder::decodeMCURows の MCU 行バッファ
+        std::vector<MCURowBuffer> m_RowBuffers;
+        // JpegDecoder::decodeProgressive の画像全体の係数
+        std::vector<CoefficientPlane> m_CoefficientPlanes;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -1,49 +1,51 @@
-﻿#pragma once
-#include "YCbCrComponents.h"
-#include <cassert>
-#include <vector>
-#include "ComponentInfo.h"
-#include "Image/Jpeg/Syntax/Segment.h"
-
-namespace RagiMagick2::Image::Jpeg
-{
-    YCbCrComponents::YCbCrComponents(const Syntax::SOF0& sof0)
-    {
-        sampleWidth = sof0.width;
-        sampleHeight = sof0.height;
-
-        auto componentSelector = [&](Syntax::ComponentID id) -> ComponentInfo& {
-            switch (id) {
-            case Syntax::ComponentID::Y:
-                return y;
-            case Syntax::ComponentID::Cb:
-                return cb;
-            case Syntax::ComponentID::Cr:
-                return cr;
-            default:
-                assert(false);
-                return y; // dummy
-            }
-        };
-
-        for (const auto& component : sof0.components) {
-            assert(
-                component.id == Syntax::ComponentID::Y  ||
-                component.id == Syntax::ComponentID::Cb ||
-                component.id == Syntax::ComponentID::Cr
-            );
-            auto& info = componentSelector(component.id);
-            info.horizontalSamplingFactor = component.horizonalSamplingFactor;
-            info.verticalSamplingFactor = component.verticalSamplingFactor;
-        }
-
-        for (const auto& component : sof0.components) {
-            auto& info = componentSelector(component.id);
-            const auto hMaxFactor = getMaxHorizontalSamplingFactor();
-            const auto vMaxFactor = getMaxVerticalSamplingFactor();
-            info.width = (sof0.width * info.horizontalSamplingFactor + hMaxFactor - 1) / hMaxFactor;
-            info.height = (sof0.height * info.verticalSamplingFactor + vMaxFactor - 1) / vMaxFactor;
-            info.buffer.resize(static_cast<size_t>(info.width * info.height), 0);
-        }
-    }
-} // namespace RagiMagick2::Image::Jpeg
+﻿#include "YCbCrComponents.h"
+#include <algorithm>
+#include <vector>
+#include "ComponentInfo.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    YCbCrComponents::YCbCrComponents(const Syntax::SOF0& sof0, int mcuRowCount, int blockSize, int width)
+    {
+        reset(sof0, mcuRowCount, blockSize, width);
+    }
+
+    void YCbCrComponents::reset(const Syntax::SOF0& sof0, int mcuRowCount, int blockSize, int width)
+    {
+        this->blockSize = blockSize;
+        maxHorizontalSamplingFactor = 1;
+        maxVerticalSamplingFactor = 1;
+
+        // 縮小デコードの場合、出力サイズは切り上げ
+        sampleWidth = static_cast<uint16_t>((sof0.width * blockSize + 7) / 8);
+        sampleHeight = static_cast<uint16_t>((sof0.height * blockSize + 7) / 8);
+
+        // 成分の buffer は作り直さずに残す
+        components.resize(sof0.components.size());
+        for (size_t i = 0; i < sof0.components.size(); ++i) {
+            const auto& component = sof0.components[i];
+            auto& info = components[i];
+            info.id = component.id;
+            info.horizontalSamplingFactor = component.horizonalSamplingFactor;
+            info.verticalSamplingFactor = component.verticalSamplingFactor;
+            maxHorizontalSamplingFactor = std::max(maxHorizontalSamplingFactor, info.horizontalSamplingFactor);
+            maxVerticalSamplingFactor = std::max(maxVerticalSamplingFactor, info.verticalSamplingFactor);
+        }
+
+        if (mcuRowCount > 0) {
+            sampleHeight = static_cast<uint16_t>(mcuRowCount * getMCUHeight());
+        }
+        if (width > 0) {
+            sampleWidth = static_cast<uint16_t>(width);
+        }
+
+        for (auto& info : components) {
+            const auto hMaxFactor = getMaxHorizontalSamplingFactor();
+            const auto vMaxFactor = getMaxVerticalSamplingFactor();
+            info.width = (sampleWidth * info.horizontalSamplingFactor + hMaxFactor - 1) / hMaxFactor;
+            info.height = (sampleHeight * info.verticalSamplingFactor + vMaxFactor - 1) / vMaxFactor;
+            info.buffer.assign(static_cast<size_t>(info.width * info.height), 0);
+        }
+    }
+} // namespace RagiMagick2::Image::Jpeg
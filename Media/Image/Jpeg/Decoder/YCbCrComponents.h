@@ -1,100 +1,79 @@
-﻿#pragma once
-#include <cassert>
-#include <cstdint>
-#include "Image/Jpeg/Syntax/Segment.h"
-#include "ComponentInfo.h"
-
-namespace RagiMagick2::Image::Jpeg
-{
-    class YCbCrComponents final
-    {
-    public:
-        YCbCrComponents(const Syntax::SOF0& sof0);
-
-        inline int getMaxHorizontalSamplingFactor() const
-        {
-            return std::max({ y.horizontalSamplingFactor, cb.horizontalSamplingFactor, cr.horizontalSamplingFactor });
-        }
-
-        inline int getMaxVerticalSamplingFactor() const
-        {
-            return std::max({ y.verticalSamplingFactor, cb.verticalSamplingFactor, cr.verticalSamplingFactor });
-        }
-
-        inline int getMCUWidth() const
-        {
-            return getMaxHorizontalSamplingFactor() * 8;
-        }
-
-        inline int getMCUHeight() const
-        {
-            return getMaxVerticalSamplingFactor() * 8;
-        }
-
-        inline int getMCUHorizontalCount() const
-        {
-            return (sampleWidth + getMCUWidth() - 1) / getMCUWidth();
-        }
-
-        inline int getMCUVerticalCount() const
-        {
-            return (sampleHeight + getMCUHeight() - 1) / getMCUHeight();
-        }
-
-        inline double getCbHorizontalSamplingFactor() const
-        {
-            return static_cast<double>(cb.horizontalSamplingFactor) / static_cast<double>(y.horizontalSamplingFactor);
-        }
-
-        inline double getCbVerticalSamplingFactor() const
-        {
-            return static_cast<double>(cb.verticalSamplingFactor) / static_cast<double>(y.verticalSamplingFactor);
-        }
-
-        inline double getCrHorizontalSamplingFactor() const
-        {
-            return static_cast<double>(cr.horizontalSamplingFactor) / static_cast<double>(y.horizontalSamplingFactor);
-        }
-
-        inline double getCrVerticalSamplingFactor() const
-        {
-            return static_cast<double>(cr.verticalSamplingFactor) / static_cast<double>(y.verticalSamplingFactor);
-        }
-
-        inline const ComponentInfo& getComponent(Syntax::ComponentID id) const
-        {
-            switch (id) {
-            case Syntax::ComponentID::Y:
-                return y;
-            case Syntax::ComponentID::Cb:
-                return cb;
-            case Syntax::ComponentID::Cr:
-                return cr;
-            default:
-                assert(false);
-                return y; // dummy
-            }
-        }
-
-        inline ComponentInfo& getComponent(Syntax::ComponentID id)
-        {
-            switch (id) {
-            case Syntax::ComponentID::Y:
-                return y;
-            case Syntax::ComponentID::Cb:
-                return cb;
-            case Syntax::ComponentID::Cr:
-                return cr;
-            default:
-                assert(false);
-                return y; // dummy
-            }
-        }
-    private:
-        uint16_t sampleWidth = 0;
-        uint16_t sampleHeight = 0;
-        ComponentInfo y{};
-        ComponentInfo cb{};
-        ComponentInfo cr{};
-    };
-} // namespace RagiMagick2::Image::Jpeg
+﻿#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Image/Jpeg/Syntax/Segment.h"
+#include "ComponentInfo.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // 成分ごとのサンプル値 (SOF の成分の順、グレースケールなら Y のみ)
+    // サンプリングファクタは成分ごとに任意で、各成分のプレーンは最大のサンプリングファクタとの比で縮小した大きさになる
+    class YCbCrComponents final
+    {
+    public:
+        // mcuRowCount が 0 なら画像全体、それ以外は MCU 行 mcuRowCount 行分のバッファを確保する
+        // blockSize は IDCT で出力する1ブロックの一辺 (縮小デコードの場合は 4, 2, 1)
+        // width が 0 なら画像全体の幅、それ以外は (出力画像での) 幅 width のバッファを確保する
+        YCbCrComponents(const Syntax::SOF0& sof0, int mcuRowCount = 0, int blockSize = 8, int width = 0);
+
+        // コンストラクタと同じ引数で作り直す (確保済みのバッファは再利用して、 0 で埋める)
+        void reset(const Syntax::SOF0& sof0, int mcuRowCount = 0, int blockSize = 8, int width = 0);
+
+        inline int getMaxHorizontalSamplingFactor() const
+        {
+            return maxHorizontalSamplingFactor;
+        }
+
+        inline int getMaxVerticalSamplingFactor() const
+        {
+            return maxVerticalSamplingFactor;
+        }
+
+        inline int getMCUWidth() const
+        {
+            return getMaxHorizontalSamplingFactor() * blockSize;
+        }
+
+        inline int getMCUHeight() const
+        {
+            return getMaxVerticalSamplingFactor() * blockSize;
+        }
+
+        inline int getMCUHorizontalCount() const
+        {
+            return (sampleWidth + getMCUWidth() - 1) / getMCUWidth();
+        }
+
+        inline int getMCUVerticalCount() const
+        {
+            return (sampleHeight + getMCUHeight() - 1) / getMCUHeight();
+        }
+
+        inline size_t getComponentCount() const
+        {
+            return components.size();
+        }
+
+        // index は SOF の成分の順番
+        inline const ComponentInfo& getComponent(size_t index) const
+        {
+            assert(index < components.size());
+            return components[index];
+        }
+
+        inline ComponentInfo& getComponent(size_t index)
+        {
+            assert(index < components.size());
+            return components[index];
+        }
+    private:
+        uint16_t sampleWidth = 0;
+        uint16_t sampleHeight = 0;
+        int blockSize = 8;
+        int maxHorizontalSamplingFactor = 1;
+        int maxVerticalSamplingFactor = 1;
+        std::vector<ComponentInfo> components{};
+    };
+} // namespace RagiMagick2::Image::Jpeg
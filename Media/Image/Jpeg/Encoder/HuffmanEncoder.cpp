@@ -0,0 +1,320 @@
+﻿#include "HuffmanEncoder.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace RagiMagick2::Image::Jpeg;
+using namespace RagiMagick2::Image::Jpeg::Syntax;
+
+namespace
+{
+    struct HuffmanSpec
+    {
+        std::array<uint8_t, 16> counts;
+        std::vector<uint8_t> symbols;
+    };
+
+    // Table K.3 – Table for luminance DC coefficient differences
+    const HuffmanSpec LUMINANCE_DC = {
+        { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 },
+    };
+
+    // Table K.4 – Table for chrominance DC coefficient differences
+    const HuffmanSpec CHROMINANCE_DC = {
+        { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 },
+    };
+
+    // Table K.5 – Table for luminance AC coefficients
+    const HuffmanSpec LUMINANCE_AC = {
+        { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D },
+        {
+            0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12,
+            0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+            0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08,
+            0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+            0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16,
+            0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+            0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+            0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+            0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+            0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+            0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+            0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+            0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98,
+            0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+            0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6,
+            0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+            0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4,
+            0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+            0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA,
+            0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+            0xF9, 0xFA,
+        },
+    };
+
+    // Table K.6 – Table for chrominance AC coefficients
+    const HuffmanSpec CHROMINANCE_AC = {
+        { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 },
+        {
+            0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21,
+            0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+            0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+            0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+            0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34,
+            0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+            0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38,
+            0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+            0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+            0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+            0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
+            0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+            0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96,
+            0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+            0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4,
+            0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+            0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2,
+            0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+            0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9,
+            0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+            0xF9, 0xFA,
+        },
+    };
+
+    DHT createDHT(const std::array<uint8_t, 16>& counts, std::vector<uint8_t> symbols, DHT::TableClass tableClass, HuffmanTableID tableID)
+    {
+        DHT dht{};
+        dht.marker = Marker::DHT;
+        // Lh = 2 + 1 (Tc, Th) + 16 (Li) + 符号の数
+        dht.length = static_cast<uint16_t>(2 + 1 + 16 + symbols.size());
+        dht.tableClass = tableClass;
+        dht.tableID = tableID;
+        dht.counts = counts;
+        dht.symbols = std::move(symbols);
+        return dht;
+    }
+
+    // F.1.2.1.1 係数の値から SSSS (値を表すのに必要なビット数) と付加ビットを求める
+    // 負の値の付加ビットは、値 - 1 の下位 SSSS ビット (1 の補数)
+    inline std::tuple<int, uint32_t> categorize(int value) noexcept
+    {
+        const int ssss = std::bit_width(static_cast<uint32_t>(std::abs(value)));
+        const uint32_t bits = static_cast<uint32_t>(value < 0 ? value - 1 : value);
+        return { ssss, bits };
+    }
+
+    inline void putSymbol(BitStreamWriter& writer, const HuffmanCodeTable& table, int symbol)
+    {
+        writer.putBits(table.codes[symbol], table.lengths[symbol]);
+    }
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    DHT createStandardDHT(DHT::TableClass tableClass, HuffmanTableID tableID)
+    {
+        const bool isLuminance = tableID == HuffmanTableID::LUMINANCE;
+        const HuffmanSpec& spec = tableClass == DHT::TableClass::DC_OR_LOSSLESS
+            ? (isLuminance ? LUMINANCE_DC : CHROMINANCE_DC)
+            : (isLuminance ? LUMINANCE_AC : CHROMINANCE_AC);
+        return createDHT(spec.counts, spec.symbols, tableClass, tableID);
+    }
+
+    DHT createOptimalDHT(const SymbolFrequencies& frequencies, DHT::TableClass tableClass, HuffmanTableID tableID)
+    {
+        // 符号長の上限 (調整前)
+        constexpr int MAX_CODE_LENGTH = 32;
+        // シンボル 256 は予約 (出現回数 1)
+        // 全て 1 の符号 (K.2 の手順では最長の符号の最後のもの) がこのシンボルに割り当てられるので、実際のシンボルには使われない
+        std::array<int64_t, 257> freq{};
+        std::copy(frequencies.begin(), frequencies.end(), freq.begin());
+        freq[256] = 1;
+        // 1つも使われていない場合でも、シンボル 0 だけの有効なテーブルにする
+        if (std::all_of(frequencies.begin(), frequencies.end(), [](auto count) { return count == 0; })) {
+            freq[0] = 1;
+        }
+
+        // Figure K.1 – Procedure to find Huffman code sizes
+        std::array<int, 257> codeSize{};
+        std::array<int, 257> others{};
+        others.fill(-1);
+
+        for (;;) {
+            // 出現回数が最も少ないもの (c1) と次に少ないもの (c2) を探す (同じなら後ろのもの)
+            int c1 = -1;
+            int64_t v = INT64_MAX;
+            for (int i = 0; i < 257; ++i) {
+                if (freq[i] > 0 && freq[i] <= v) {
+                    v = freq[i];
+                    c1 = i;
+                }
+            }
+            int c2 = -1;
+            v = INT64_MAX;
+            for (int i = 0; i < 257; ++i) {
+                if (freq[i] > 0 && freq[i] <= v && i != c1) {
+                    v = freq[i];
+                    c2 = i;
+                }
+            }
+
+            // 1つにまとまったら終わり
+            if (c2 < 0) {
+                break;
+            }
+
+            freq[c1] += freq[c2];
+            freq[c2] = 0;
+
+            ++codeSize[c1];
+            while (others[c1] >= 0) {
+                c1 = others[c1];
+                ++codeSize[c1];
+            }
+            others[c1] = c2;
+
+            ++codeSize[c2];
+            while (others[c2] >= 0) {
+                c2 = others[c2];
+                ++codeSize[c2];
+            }
+        }
+
+        // Figure K.2 – Procedure to find the number of codes of each size
+        std::array<int, MAX_CODE_LENGTH + 1> bits{};
+        for (int i = 0; i < 257; ++i) {
+            if (codeSize[i] > 0) {
+                ++bits[std::min(codeSize[i], MAX_CODE_LENGTH)];
+            }
+        }
+
+        // Figure K.3 – Procedure for limiting code lengths to 16 bits
+        for (int i = MAX_CODE_LENGTH; i > 16; --i) {
+            while (bits[i] > 0) {
+                int j = i - 2;
+                while (bits[j] == 0) {
+                    --j;
+                }
+                bits[i] -= 2;
+                ++bits[i - 1];
+                bits[j + 1] += 2;
+                --bits[j];
+            }
+        }
+
+        // 予約したシンボルの分 (最長の符号の1つ) を取り除く
+        int longest = 16;
+        while (longest > 1 && bits[longest] == 0) {
+            --longest;
+        }
+        --bits[longest];
+
+        std::array<uint8_t, 16> counts{};
+        for (int i = 1; i <= 16; ++i) {
+            counts[i - 1] = static_cast<uint8_t>(bits[i]);
+        }
+
+        // Figure K.4 – Sorting of input values according to code size
+        std::vector<uint8_t> symbols;
+        for (int size = 1; size <= MAX_CODE_LENGTH; ++size) {
+            for (int i = 0; i < 256; ++i) {
+                if (codeSize[i] == size) {
+                    symbols.push_back(static_cast<uint8_t>(i));
+                }
+            }
+        }
+
+        return createDHT(counts, std::move(symbols), tableClass, tableID);
+    }
+
+    HuffmanCodeTable createHuffmanCodeTable(const DHT& dht)
+    {
+        HuffmanCodeTable table{};
+
+        // Figure C.1 と C.2 で符号長の順に符号を割り当て、 Figure C.3 でシンボル順に並べ替える
+        size_t k = 0;
+        uint32_t code = 0;
+        for (int length = 1; length <= 16; ++length) {
+            for (int i = 0; i < dht.counts[length - 1] && k < dht.symbols.size(); ++i, ++k) {
+                const uint8_t symbol = dht.symbols[k];
+                table.codes[symbol] = static_cast<uint16_t>(code);
+                table.lengths[symbol] = static_cast<uint8_t>(length);
+                ++code;
+            }
+            code <<= 1;
+        }
+        return table;
+    }
+
+    void encodeBlock(
+        BitStreamWriter& writer,
+        const MCUBlock8x8& block,
+        int& dcPred,
+        const HuffmanCodeTable& dcTable,
+        const HuffmanCodeTable& acTable
+    )
+    {
+        // F.1.2.1 Huffman encoding of DC coefficients
+        const int diff = block[0] - dcPred;
+        dcPred = block[0];
+        const auto [dcSize, dcBits] = categorize(diff);
+        putSymbol(writer, dcTable, dcSize);
+        writer.putBits(dcBits, dcSize);
+
+        // Figure F.2 – Procedure for sequential encoding of AC coefficients
+        int run = 0;
+        for (int k = 1; k < BLOCK_SIZE; ++k) {
+            const int value = block[k];
+            if (value == 0) {
+                ++run;
+                continue;
+            }
+            // ZRL (16 個の 0)
+            while (run > 15) {
+                putSymbol(writer, acTable, 0xF0);
+                run -= 16;
+            }
+            const auto [size, bits] = categorize(value);
+            putSymbol(writer, acTable, (run << 4) | size);
+            writer.putBits(bits, size);
+            run = 0;
+        }
+
+        // EOB
+        if (run > 0) {
+            putSymbol(writer, acTable, 0x00);
+        }
+    }
+
+    void countBlockSymbols(const MCUBlock8x8& block, int& dcPred, SymbolFrequencies& dcFrequencies, SymbolFrequencies& acFrequencies)
+    {
+        const int diff = block[0] - dcPred;
+        dcPred = block[0];
+        ++dcFrequencies[std::get<0>(categorize(diff))];
+
+        int run = 0;
+        for (int k = 1; k < BLOCK_SIZE; ++k) {
+            const int value = block[k];
+            if (value == 0) {
+                ++run;
+                continue;
+            }
+            while (run > 15) {
+                ++acFrequencies[0xF0];
+                run -= 16;
+            }
+            ++acFrequencies[(run << 4) | std::get<0>(categorize(value))];
+            run = 0;
+        }
+
+        if (run > 0) {
+            ++acFrequencies[0x00];
+        }
+    }
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include "Image/Jpeg/BitStreamWriter.h"
+#include "Image/Jpeg/Decoder/Common.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // C.3 のハフマン符号表 (EHUFCO, EHUFSI)
+    // シンボルをインデックスにして、符号と符号長を引く (符号長 0 は未登録のシンボル)
+    struct HuffmanCodeTable
+    {
+        std::array<uint16_t, 256> codes{};
+        std::array<uint8_t, 256> lengths{};
+    };
+
+    // シンボルごとの出現回数 (最適なハフマンテーブルを作るのに使う)
+    using SymbolFrequencies = std::array<uint32_t, 256>;
+
+    // K.3.3 の標準ハフマンテーブル (Table K.3 ～ K.6)
+    // tableID が LUMINANCE なら輝度用、それ以外は色差用
+    Syntax::DHT createStandardDHT(Syntax::DHT::TableClass tableClass, Syntax::HuffmanTableID tableID);
+
+    // K.2 A procedure for generating the lists which specify a Huffman code table
+    // 出現回数から、符号長が 16 ビット以下で全て 1 の符号を含まないハフマンテーブルを作る (libjpeg の jpeg_gen_optimal_table と同じ手順)
+    Syntax::DHT createOptimalDHT(const SymbolFrequencies& frequencies, Syntax::DHT::TableClass tableClass, Syntax::HuffmanTableID tableID);
+
+    // Figure C.1 ～ C.3 で BITS と HUFFVAL から符号表を作る
+    HuffmanCodeTable createHuffmanCodeTable(const Syntax::DHT& dht);
+
+    // F.1.2 Baseline Huffman encoding procedures
+    // 1ブロック分の量子化済みの係数 (ジグザグ順) を符号化する
+    // dcPred は同じ成分の直前のブロックの DC 係数で、このブロックの DC 係数に更新する
+    void encodeBlock(
+        BitStreamWriter& writer,
+        const MCUBlock8x8& block,
+        int& dcPred,
+        const HuffmanCodeTable& dcTable,
+        const HuffmanCodeTable& acTable
+    );
+
+    // encodeBlock で符号化するシンボルを、符号化せずに数える
+    void countBlockSymbols(const MCUBlock8x8& block, int& dcPred, SymbolFrequencies& dcFrequencies, SymbolFrequencies& acFrequencies);
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,506 @@
+﻿#include "JpegEncoder.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "Image/Jpeg/Encoder/SegmentWriter.h"
+#include "Image/Jpeg/Syntax/Marker.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+#include "Image/Pixel/PixelFormatConverters.h"
+
+using namespace RagiMagick2::Image::Jpeg::Syntax;
+
+namespace
+{
+    using QuantTable = std::array<uint16_t, RagiMagick2::Image::Jpeg::BLOCK_SIZE>;
+
+    // Table K.1 – Luminance quantization table (自然順)
+    constexpr QuantTable LUMINANCE_QUANT_TABLE = {
+        16, 11, 10, 16,  24,  40,  51,  61,
+        12, 12, 14, 19,  26,  58,  60,  55,
+        14, 13, 16, 24,  40,  57,  69,  56,
+        14, 17, 22, 29,  51,  87,  80,  62,
+        18, 22, 37, 56,  68, 109, 103,  77,
+        24, 35, 55, 64,  81, 104, 113,  92,
+        49, 64, 78, 87, 103, 121, 120, 101,
+        72, 92, 95, 98, 112, 100, 103,  99
+    };
+
+    // Table K.2 – Chrominance quantization table (自然順)
+    constexpr QuantTable CHROMINANCE_QUANT_TABLE = {
+        17, 18, 24, 47, 99, 99, 99, 99,
+        18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99,
+        47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99
+    };
+
+    // IJG (libjpeg の jpeg_quality_scaling) と同じ尺度で、品質から量子化テーブルを作る
+    // ベースラインなので値は 1～255 に収める
+    constexpr QuantTable scaleQuantTable(const QuantTable& base, int quality)
+    {
+        quality = std::clamp(quality, 1, 100);
+        const int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+
+        QuantTable table{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = static_cast<uint16_t>(std::clamp((base[i] * scale + 50) / 100, 1, 255));
+        }
+        return table;
+    }
+    static_assert(scaleQuantTable(LUMINANCE_QUANT_TABLE, 50) == LUMINANCE_QUANT_TABLE);
+    static_assert(scaleQuantTable(LUMINANCE_QUANT_TABLE, 100)[63] == 1);
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    JpegEncoder::JpegEncoder(std::string_view fileName)
+        : m_FileName(fileName)
+        , m_Output(m_Buffer)
+        , m_Writer(m_Output)
+    {
+    }
+
+    JpegEncoder::JpegEncoder(std::vector<uint8_t>& output)
+        : m_Output(output)
+        , m_Writer(m_Output)
+    {
+    }
+
+    JpegEncoder::~JpegEncoder()
+    {
+    }
+
+    bool JpegEncoder::begin(int width, int height, Pixel::PixelFormat format, const EncodeOptions& options)
+    {
+        using namespace Pixel;
+
+        if (m_IsStarted) {
+            return false;
+        }
+        if (width <= 0 || height <= 0 || width > UINT16_MAX || height > UINT16_MAX) {
+            return false;
+        }
+        if (!isRGBFormat(format) && format != PixelFormat::R8_UINT) {
+            return false;
+        }
+        if (options.restartInterval < 0 || options.restartInterval > UINT16_MAX) {
+            return false;
+        }
+
+        if (!m_FileName.empty()) {
+            m_File.open(m_FileName, std::ios::binary);
+            if (!m_File) {
+                return false;
+            }
+        }
+
+        m_Width = width;
+        m_Height = height;
+        m_Format = format;
+        m_BytesPerPixel = getBytesPerPixel(format);
+        m_Options = options;
+
+        // 成分とサンプリングファクタ
+        m_Components.clear();
+        if (format == PixelFormat::R8_UINT) {
+            m_Components.push_back({ 1, 1, 0 });
+        }
+        else {
+            const int factor = options.chromaSubsampling == ChromaSubsampling::YUV420 ? 2 : 1;
+            m_Components.push_back({ factor, factor, 0 });
+            m_Components.push_back({ 1, 1, 1 });
+            m_Components.push_back({ 1, 1, 1 });
+        }
+        m_MCUWidth = m_Components[0].horizontalSamplingFactor * BLOCK_WIDTH;
+        m_MCUHeight = m_Components[0].verticalSamplingFactor * BLOCK_HEIGHT;
+        m_MCUHorizontalCount = (width + m_MCUWidth - 1) / m_MCUWidth;
+        m_MCUVerticalCount = (height + m_MCUHeight - 1) / m_MCUHeight;
+        m_PlaneWidth = m_MCUHorizontalCount * m_MCUWidth;
+
+        // 量子化テーブルとハフマンテーブル
+        m_QuantTables[0] = scaleQuantTable(LUMINANCE_QUANT_TABLE, options.quality);
+        m_QuantTables[1] = scaleQuantTable(CHROMINANCE_QUANT_TABLE, options.quality);
+        for (size_t i = 0; i < m_QuantTables.size(); ++i) {
+            m_Divisors[i] = Math::FDCT::createDivisors(m_QuantTables[i]);
+        }
+        if (!options.optimizeHuffmanTables) {
+            for (size_t i = 0; i < m_DCTables.size(); ++i) {
+                const auto tableID = static_cast<HuffmanTableID>(i);
+                m_DCTables[i] = createStandardDHT(DHT::TableClass::DC_OR_LOSSLESS, tableID);
+                m_ACTables[i] = createStandardDHT(DHT::TableClass::AC, tableID);
+                m_DCCodes[i] = createHuffmanCodeTable(m_DCTables[i]);
+                m_ACCodes[i] = createHuffmanCodeTable(m_ACTables[i]);
+            }
+        }
+
+        m_Planes.assign(m_Components.size(), std::vector<uint8_t>(static_cast<size_t>(m_PlaneWidth) * m_MCUHeight));
+        m_BufferedLines = 0;
+        m_ReceivedLines = 0;
+        m_EncodedMCUCount = 0;
+        m_Coefs.clear();
+        if (options.optimizeHuffmanTables) {
+            size_t blocksPerMCU = 0;
+            for (const auto& component : m_Components) {
+                blocksPerMCU += static_cast<size_t>(component.horizontalSamplingFactor) * component.verticalSamplingFactor;
+            }
+            m_Coefs.reserve(blocksPerMCU * m_MCUHorizontalCount * m_MCUVerticalCount);
+        }
+
+        writeHeaders();
+        if (!options.optimizeHuffmanTables) {
+            writeHuffmanTables();
+            writeScanHeader();
+        }
+        flushOutput();
+
+        m_IsStarted = true;
+        return true;
+    }
+
+    bool JpegEncoder::writeRows(std::span<const uint8_t> pixels, size_t stride, int rowCount)
+    {
+        if (!m_IsStarted) {
+            return false;
+        }
+
+        rowCount = std::min(rowCount, m_Height - m_ReceivedLines);
+        if (rowCount <= 0) {
+            return true;
+        }
+        if (pixels.size() < stride * (rowCount - 1) + static_cast<size_t>(m_Width) * m_BytesPerPixel) {
+            return false;
+        }
+
+        for (int row = 0; row < rowCount; ++row) {
+            convertRow(&pixels[row * stride], m_BufferedLines);
+            ++m_BufferedLines;
+            ++m_ReceivedLines;
+
+            if (m_BufferedLines == m_MCUHeight) {
+                encodeMCURow();
+                m_BufferedLines = 0;
+                flushOutput();
+            }
+        }
+        return true;
+    }
+
+    bool JpegEncoder::finish()
+    {
+        if (!m_IsStarted || m_ReceivedLines < m_Height) {
+            return false;
+        }
+        m_IsStarted = false;
+
+        // 最後の MCU 行の足りない行は、最後の行を複製する
+        if (m_BufferedLines > 0) {
+            for (auto& plane : m_Planes) {
+                const auto last = plane.begin() + static_cast<ptrdiff_t>(m_BufferedLines - 1) * m_PlaneWidth;
+                for (int line = m_BufferedLines; line < m_MCUHeight; ++line) {
+                    std::copy(last, last + m_PlaneWidth, plane.begin() + static_cast<ptrdiff_t>(line) * m_PlaneWidth);
+                }
+            }
+            encodeMCURow();
+            m_BufferedLines = 0;
+        }
+
+        if (m_Options.optimizeHuffmanTables) {
+            writeOptimizedScan();
+        }
+
+        m_Writer.writeMarker(getMarkerCode(Marker::EOI));
+        flushOutput();
+
+        if (m_File.is_open()) {
+            m_File.close();
+            return !m_File.fail();
+        }
+        return true;
+    }
+
+    bool JpegEncoder::encode(
+        std::span<const uint8_t> pixels,
+        size_t stride,
+        int width,
+        int height,
+        Pixel::PixelFormat format,
+        const EncodeOptions& options
+    )
+    {
+        return begin(width, height, format, options)
+            && writeRows(pixels, stride, height)
+            && finish();
+    }
+
+    void JpegEncoder::convertRow(const uint8_t* src, int line)
+    {
+        const size_t offset = static_cast<size_t>(line) * m_PlaneWidth;
+
+        if (m_Format == Pixel::PixelFormat::R8_UINT) {
+            uint8_t* y = &m_Planes[0][offset];
+            std::copy(src, src + m_Width, y);
+            std::fill(y + m_Width, y + m_PlaneWidth, y[m_Width - 1]);
+            return;
+        }
+
+        uint8_t* y = &m_Planes[0][offset];
+        uint8_t* cb = &m_Planes[1][offset];
+        uint8_t* cr = &m_Planes[2][offset];
+        for (int x = 0; x < m_Width; ++x) {
+            const auto [r, g, b] = Pixel::loadRGB(m_Format, src + x * m_BytesPerPixel);
+            std::tie(y[x], cb[x], cr[x]) = Pixel::rgbToYCbCr(r, g, b);
+        }
+        // 右端を MCU の幅まで複製する (A.2.4 の補完と同じく端の値を繰り返す)
+        std::fill(y + m_Width, y + m_PlaneWidth, y[m_Width - 1]);
+        std::fill(cb + m_Width, cb + m_PlaneWidth, cb[m_Width - 1]);
+        std::fill(cr + m_Width, cr + m_PlaneWidth, cr[m_Width - 1]);
+    }
+
+    void JpegEncoder::loadBlock(const std::vector<uint8_t>& plane, int x, int y, bool isSubsampled, Math::FDCT::Block& block) const
+    {
+        if (!isSubsampled) {
+            for (int row = 0; row < BLOCK_HEIGHT; ++row) {
+                const uint8_t* src = &plane[static_cast<size_t>(y + row) * m_PlaneWidth + x];
+                std::copy(src, src + BLOCK_WIDTH, &block[row * BLOCK_WIDTH]);
+            }
+            return;
+        }
+
+        // libjpeg の h2v2_downsample と同じく、丸めの値を 1, 2 と交互に変えて偏りを無くす
+        for (int row = 0; row < BLOCK_HEIGHT; ++row) {
+            const uint8_t* src0 = &plane[static_cast<size_t>(y + row * 2) * m_PlaneWidth + x];
+            const uint8_t* src1 = src0 + m_PlaneWidth;
+            for (int col = 0; col < BLOCK_WIDTH; ++col) {
+                const int bias = col % 2 == 0 ? 1 : 2;
+                const int sum = src0[col * 2] + src0[col * 2 + 1] + src1[col * 2] + src1[col * 2 + 1];
+                block[row * BLOCK_WIDTH + col] = static_cast<int16_t>((sum + bias) >> 2);
+            }
+        }
+    }
+
+    void JpegEncoder::encodeMCURow()
+    {
+        const auto& kernels = Math::FDCT::getKernels();
+        alignas(32) Math::FDCT::Block samples{};
+        alignas(32) Math::FDCT::Block coefs{};
+        MCUBlock8x8 block{};
+        // MCU 内のブロックの DC 係数 (サンプリングファクタは最大 2x2)
+        std::array<int16_t, 4> blockDCs{};
+
+        // 間引かない成分のブロックの数 (これより右と下は、 MCU を埋めるためだけのブロック)
+        const int blockColumns = (m_Width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+        const int blockRows = (m_Height + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT;
+        const int mcuY = m_EncodedMCUCount / m_MCUHorizontalCount;
+
+        for (int mcuX = 0; mcuX < m_MCUHorizontalCount; ++mcuX) {
+            handleRestart(m_EncodedMCUCount);
+
+            for (size_t c = 0; c < m_Components.size(); ++c) {
+                auto& component = m_Components[c];
+                const int hSamp = component.horizontalSamplingFactor;
+                const int vSamp = component.verticalSamplingFactor;
+                // 間引く成分は、 MCU 全体 (輝度のブロック数分) を1ブロックに縮める
+                const bool isSubsampled = hSamp < m_Components[0].horizontalSamplingFactor;
+
+                for (int v = 0; v < vSamp; ++v) {
+                    for (int h = 0; h < hSamp; ++h) {
+                        const bool isRightPadding = !isSubsampled && mcuX * hSamp + h >= blockColumns;
+                        const bool isBottomPadding = !isSubsampled && mcuY * vSamp + v >= blockRows;
+                        if (isRightPadding || isBottomPadding) {
+                            // 画像の外のブロックは libjpeg と同じく AC を全て 0 にして、 DC は右端なら左の、下端なら上の行の最後のブロックと同じにする
+                            // (複製した画素を DCT するより符号が短くなる)
+                            block.fill(0);
+                            block[0] = isRightPadding ? blockDCs[v * hSamp + h - 1] : blockDCs[(v - 1) * hSamp + hSamp - 1];
+                        }
+                        else {
+                            const int x = mcuX * m_MCUWidth + h * BLOCK_WIDTH;
+                            const int y = v * BLOCK_HEIGHT;
+                            loadBlock(m_Planes[c], x, y, isSubsampled, samples);
+                            kernels.fdctQuantize(samples, m_Divisors[component.tableIndex], coefs);
+
+                            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                                block[ZIGZAG[i]] = coefs[i];
+                            }
+                        }
+                        blockDCs[v * hSamp + h] = block[0];
+
+                        if (m_Options.optimizeHuffmanTables) {
+                            m_Coefs.push_back(block);
+                        }
+                        else {
+                            encodeBlock(m_Writer, block, component.dcPred, m_DCCodes[component.tableIndex], m_ACCodes[component.tableIndex]);
+                        }
+                    }
+                }
+            }
+            ++m_EncodedMCUCount;
+        }
+    }
+
+    void JpegEncoder::handleRestart(int mcuIndex)
+    {
+        const int interval = m_Options.restartInterval;
+        if (interval == 0 || mcuIndex == 0 || mcuIndex % interval != 0) {
+            return;
+        }
+
+        // 係数を保持するだけの場合は、書き込むときに writeOptimizedScan で入れる
+        if (!m_Options.optimizeHuffmanTables) {
+            const int restartIndex = (mcuIndex / interval - 1) % 8;
+            m_Writer.writeMarker(static_cast<uint8_t>(getMarkerCode(Marker::RST0) + restartIndex));
+        }
+        for (auto& component : m_Components) {
+            component.dcPred = 0;
+        }
+    }
+
+    void JpegEncoder::writeOptimizedScan()
+    {
+        const int mcuCount = m_MCUHorizontalCount * m_MCUVerticalCount;
+        const int interval = m_Options.restartInterval;
+        auto isRestart = [&](int mcuIndex) {
+            return interval != 0 && mcuIndex != 0 && mcuIndex % interval == 0;
+        };
+
+        // 符号化するときと同じ順番で DC 係数の差分を取りながらシンボルを数える
+        std::array<SymbolFrequencies, 2> dcFrequencies{};
+        std::array<SymbolFrequencies, 2> acFrequencies{};
+        for (auto& component : m_Components) {
+            component.dcPred = 0;
+        }
+        size_t blockIndex = 0;
+        for (int mcuIndex = 0; mcuIndex < mcuCount; ++mcuIndex) {
+            if (isRestart(mcuIndex)) {
+                for (auto& component : m_Components) {
+                    component.dcPred = 0;
+                }
+            }
+            for (auto& component : m_Components) {
+                const int blockCount = component.horizontalSamplingFactor * component.verticalSamplingFactor;
+                for (int i = 0; i < blockCount; ++i) {
+                    countBlockSymbols(m_Coefs[blockIndex++], component.dcPred, dcFrequencies[component.tableIndex], acFrequencies[component.tableIndex]);
+                }
+            }
+        }
+
+        // グレースケールは輝度のテーブルだけを使う (色差のシンボルは1つも無いので作らない)
+        for (size_t i = 0; i < getHuffmanTableCount(); ++i) {
+            const auto tableID = static_cast<HuffmanTableID>(i);
+            m_DCTables[i] = createOptimalDHT(dcFrequencies[i], DHT::TableClass::DC_OR_LOSSLESS, tableID);
+            m_ACTables[i] = createOptimalDHT(acFrequencies[i], DHT::TableClass::AC, tableID);
+            m_DCCodes[i] = createHuffmanCodeTable(m_DCTables[i]);
+            m_ACCodes[i] = createHuffmanCodeTable(m_ACTables[i]);
+        }
+
+        writeHuffmanTables();
+        writeScanHeader();
+
+        for (auto& component : m_Components) {
+            component.dcPred = 0;
+        }
+        blockIndex = 0;
+        for (int mcuIndex = 0; mcuIndex < mcuCount; ++mcuIndex) {
+            if (isRestart(mcuIndex)) {
+                const int restartIndex = (mcuIndex / interval - 1) % 8;
+                m_Writer.writeMarker(static_cast<uint8_t>(getMarkerCode(Marker::RST0) + restartIndex));
+                for (auto& component : m_Components) {
+                    component.dcPred = 0;
+                }
+            }
+            for (auto& component : m_Components) {
+                const int blockCount = component.horizontalSamplingFactor * component.verticalSamplingFactor;
+                for (int i = 0; i < blockCount; ++i) {
+                    encodeBlock(m_Writer, m_Coefs[blockIndex++], component.dcPred, m_DCCodes[component.tableIndex], m_ACCodes[component.tableIndex]);
+                }
+            }
+            // ファイルに書き出す場合は、ある程度溜まったら書き出す
+            if (m_Buffer.size() >= 1024 * 1024) {
+                flushOutput();
+            }
+        }
+
+        m_Coefs.clear();
+        m_Coefs.shrink_to_fit();
+    }
+
+    void JpegEncoder::writeHeaders()
+    {
+        m_Writer.writeMarker(getMarkerCode(Marker::SOI));
+        writeAPP0(m_Writer);
+
+        const bool isGrayscale = m_Components.size() == 1;
+        writeDQT(m_Writer, QuantizationTableID::LUMINANCE, m_QuantTables[0]);
+        if (!isGrayscale) {
+            writeDQT(m_Writer, QuantizationTableID::CHROMINANCE, m_QuantTables[1]);
+        }
+
+        SOF0 sof{};
+        sof.marker = Marker::SOF0;
+        sof.precision = 8;
+        sof.width = static_cast<uint16_t>(m_Width);
+        sof.height = static_cast<uint16_t>(m_Height);
+        sof.numComponents = static_cast<uint8_t>(m_Components.size());
+        for (size_t i = 0; i < m_Components.size(); ++i) {
+            SOF0::Component component{};
+            component.id = static_cast<ComponentID>(i + 1);
+            component.horizonalSamplingFactor = static_cast<uint8_t>(m_Components[i].horizontalSamplingFactor);
+            component.verticalSamplingFactor = static_cast<uint8_t>(m_Components[i].verticalSamplingFactor);
+            component.tableID = static_cast<QuantizationTableID>(m_Components[i].tableIndex);
+            sof.components.push_back(component);
+        }
+        writeSOF(m_Writer, sof);
+
+        if (m_Options.restartInterval > 0) {
+            writeDRI(m_Writer, static_cast<uint16_t>(m_Options.restartInterval));
+        }
+    }
+
+    size_t JpegEncoder::getHuffmanTableCount() const noexcept
+    {
+        return m_Components.size() == 1 ? 1 : 2;
+    }
+
+    void JpegEncoder::writeHuffmanTables()
+    {
+        for (size_t i = 0; i < getHuffmanTableCount(); ++i) {
+            writeDHT(m_Writer, m_DCTables[i]);
+            writeDHT(m_Writer, m_ACTables[i]);
+        }
+    }
+
+    void JpegEncoder::writeScanHeader()
+    {
+        // 全ての成分をインターリーブした1つのスキャン (Ss = 0, Se = 63, Ah = Al = 0)
+        SOS sos{};
+        sos.marker = Marker::SOS;
+        sos.numComponents = static_cast<uint8_t>(m_Components.size());
+        for (size_t i = 0; i < m_Components.size(); ++i) {
+            SOS::Component component{};
+            component.componentSelector = static_cast<ComponentID>(i + 1);
+            component.dcSelector = static_cast<HuffmanTableID>(m_Components[i].tableIndex);
+            component.acSelector = static_cast<HuffmanTableID>(m_Components[i].tableIndex);
+            sos.components.push_back(component);
+        }
+        sos.spectralSelectionStart = 0;
+        sos.spectralSelectionEnd = 63;
+        sos.successiveApproximation = 0;
+        writeSOS(m_Writer, sos);
+    }
+
+    void JpegEncoder::flushOutput()
+    {
+        if (!m_File.is_open() || m_Buffer.empty()) {
+            return;
+        }
+        m_File.write(reinterpret_cast<const char*>(m_Buffer.data()), static_cast<std::streamsize>(m_Buffer.size()));
+        m_Buffer.clear();
+    }
+} // namespace RagiMagick2::Image::Jpeg
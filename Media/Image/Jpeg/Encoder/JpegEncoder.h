@@ -0,0 +1,159 @@
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Image/Jpeg/BitStreamWriter.h"
+#include "Image/Jpeg/Decoder/Common.h"
+#include "Image/Jpeg/Encoder/HuffmanEncoder.h"
+#include "Image/Math/FDCT.h"
+#include "Image/Pixel/PixelFormat.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // 色差のサンプリング
+    enum class ChromaSubsampling
+    {
+        YUV444,     // 間引かない (MCU は 8x8)
+        YUV420,     // 縦横とも 1/2 (MCU は 16x16)
+    };
+
+    struct EncodeOptions
+    {
+        // 1～100 (IJG と同じ尺度で、 50 のときに Annex K の量子化テーブルをそのまま使う)
+        int quality = 75;
+        // R8_UINT の入力は1成分 (グレースケール) なので使わない
+        ChromaSubsampling chromaSubsampling = ChromaSubsampling::YUV420;
+        // true なら画像に合わせたハフマンテーブル (K.2) を使う
+        // 全ての係数を数え終わるまでエントロピー符号化できないので、量子化した係数を画像全体分保持する
+        bool optimizeHuffmanTables = false;
+        // 0 以外なら、この MCU 数ごとにリスタートマーカーを入れる (1～65535)
+        int restartInterval = 0;
+    };
+
+    // ベースライン JPEG (SOF0、ハフマン符号化) のエンコーダ
+    // begin で画像のサイズと形式を指定して、上の行から順に writeRows で渡し、 finish で書き終える。
+    // 画像全体のバッファは持たずに、 MCU 行ごとに色変換・DCT・エントロピー符号化するので、
+    // フィルタの出力やストリーミングデコードの行をそのまま渡せる。
+    class JpegEncoder final
+    {
+    public:
+        // finish までに符号化したデータを MCU 行ごとに fileName に書き出す
+        JpegEncoder(std::string_view fileName);
+        // output の末尾に JPEG を追記する (output はエンコーダを使い終わるまで有効であること)
+        JpegEncoder(std::vector<uint8_t>& output);
+        ~JpegEncoder();
+
+        // format は B8G8R8A8_UINT, R8G8B8A8_UINT, R8G8B8_UINT, B8G8R8_UINT と R8_UINT に対応
+        // R8_UINT の場合はグレースケール (1成分) の JPEG になる
+        // 対応していない形式やサイズ、ファイルを開けない場合は false を返す
+        bool begin(int width, int height, Pixel::PixelFormat format, const EncodeOptions& options = {});
+
+        // 続きの rowCount 行 (n 行目は pixels[n * stride] から) を渡す
+        // 高さを超える分は無視する
+        bool writeRows(std::span<const uint8_t> pixels, size_t stride, int rowCount);
+
+        // 残りの MCU 行を符号化して EOI まで書き込む
+        // begin で指定した高さの行が全て渡されていなければ false を返す
+        bool finish();
+
+        // begin, writeRows, finish をまとめて行う
+        bool encode(
+            std::span<const uint8_t> pixels,
+            size_t stride,
+            int width,
+            int height,
+            Pixel::PixelFormat format,
+            const EncodeOptions& options = {}
+        );
+
+    private:
+        // 成分ごとの情報 (Y, Cb, Cr の順)
+        struct ComponentState
+        {
+            // サンプリングファクタ (4:2:0 の Y なら 2x2、それ以外は 1x1)
+            int horizontalSamplingFactor = 1;
+            int verticalSamplingFactor = 1;
+            // 使う量子化テーブルとハフマンテーブル (0: 輝度、 1: 色差)
+            int tableIndex = 0;
+            // DC 係数の予測値
+            int dcPred = 0;
+        };
+
+        // 入力の1行を Y, Cb, Cr に変換して、 MCU 行バッファの line 行目に書き込む (右端は MCU の幅まで複製する)
+        void convertRow(const uint8_t* src, int line);
+
+        // MCU 行バッファの1行分 (mcuHeight 行) を DCT して量子化して、符号化するか係数を保持する
+        void encodeMCURow();
+
+        // サンプル値の plane (1行 m_PlaneWidth) の (x, y) から 8x8 を block に取り出す
+        // 間引く成分 (4:2:0 の Cb, Cr) は 2x2 の平均を取る
+        void loadBlock(const std::vector<uint8_t>& plane, int x, int y, bool isSubsampled, Math::FDCT::Block& block) const;
+
+        // リスタート間隔ごとに RSTn を書き込んで DC の予測値を戻す
+        // mcuIndex 番目の MCU を符号化する前に呼ぶ
+        void handleRestart(int mcuIndex);
+
+        // 最適化したハフマンテーブルの場合、保持していた係数から DHT を作って、 SOS 以降を書き込む
+        void writeOptimizedScan();
+
+        // フレームで使うハフマンテーブルの数 (グレースケールは輝度の1つ、カラーは輝度と色差の2つ)
+        size_t getHuffmanTableCount() const noexcept;
+
+        // ヘッダ (SOI から DRI まで)
+        void writeHeaders();
+        void writeHuffmanTables();
+        void writeScanHeader();
+
+        // ファイルに書き出す場合、溜まったデータを書き出す
+        void flushOutput();
+
+    private:
+        // ファイルに書き出す場合は m_Buffer に溜めて、 MCU 行ごとに書き出す
+        std::string m_FileName;
+        std::ofstream m_File;
+        std::vector<uint8_t> m_Buffer;
+        std::vector<uint8_t>& m_Output;
+        BitStreamWriter m_Writer;
+
+        bool m_IsStarted = false;
+        int m_Width = 0;
+        int m_Height = 0;
+        Pixel::PixelFormat m_Format = Pixel::PixelFormat::B8G8R8A8_UINT;
+        int m_BytesPerPixel = 4;
+        EncodeOptions m_Options{};
+
+        std::vector<ComponentState> m_Components;
+        int m_MCUWidth = 8;
+        int m_MCUHeight = 8;
+        int m_MCUHorizontalCount = 0;
+        int m_MCUVerticalCount = 0;
+        // MCU の倍数に切り上げた幅 (MCU 行バッファの1行の長さ)
+        int m_PlaneWidth = 0;
+
+        // 自然順の量子化テーブルと、それを逆数にしたもの (0: 輝度、 1: 色差)
+        std::array<std::array<uint16_t, BLOCK_SIZE>, 2> m_QuantTables{};
+        std::array<Math::FDCT::Divisors, 2> m_Divisors{};
+        std::array<Syntax::DHT, 2> m_DCTables{};
+        std::array<Syntax::DHT, 2> m_ACTables{};
+        std::array<HuffmanCodeTable, 2> m_DCCodes{};
+        std::array<HuffmanCodeTable, 2> m_ACCodes{};
+
+        // 1 MCU 行分のサンプル値 (成分ごとに m_PlaneWidth * m_MCUHeight、間引く前)
+        std::vector<std::vector<uint8_t>> m_Planes;
+        // m_Planes に書き込んだ行数
+        int m_BufferedLines = 0;
+        // 受け取った行数
+        int m_ReceivedLines = 0;
+        // 符号化した MCU の数
+        int m_EncodedMCUCount = 0;
+
+        // 最適化したハフマンテーブルの場合に保持する、 MCU 順・成分順の係数 (ジグザグ順)
+        std::vector<MCUBlock8x8> m_Coefs;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,95 @@
+﻿#include "SegmentWriter.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "Image/Jpeg/Decoder/Common.h"
+
+using namespace RagiMagick2::Image::Jpeg::Syntax;
+
+namespace RagiMagick2::Image::Jpeg
+{
+    void writeAPP0(BitStreamWriter& writer)
+    {
+        constexpr uint8_t IDENTIFIER[] = { 'J', 'F', 'I', 'F', 0 };
+
+        writer.writeMarker(getMarkerCode(Marker::APP0));
+        writer.writeWord(16);
+        writer.writeBytes(IDENTIFIER);
+        writer.writeWord(APP0::V1_1);
+        writer.writeByte(static_cast<uint8_t>(APP0::Units::NONE));
+        writer.writeWord(1);
+        writer.writeWord(1);
+        writer.writeByte(0);
+        writer.writeByte(0);
+    }
+
+    void writeDQT(BitStreamWriter& writer, QuantizationTableID tableID, const std::array<uint16_t, 64>& table)
+    {
+        const bool is8Bits = std::ranges::all_of(table, [](uint16_t value) { return value <= 255; });
+        const auto precision = is8Bits ? DQT::Precision::BITS_8 : DQT::Precision::BITS_16;
+
+        writer.writeMarker(getMarkerCode(Marker::DQT));
+        writer.writeWord(static_cast<uint16_t>(2 + 1 + (is8Bits ? 64 : 128)));
+        writer.writeByte(static_cast<uint8_t>((static_cast<uint8_t>(precision) << 4) | static_cast<uint8_t>(tableID)));
+
+        // Qk はジグザグ順
+        std::array<uint16_t, 64> zigzag{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            zigzag[ZIGZAG[i]] = table[i];
+        }
+        for (uint16_t value : zigzag) {
+            if (is8Bits) {
+                writer.writeByte(static_cast<uint8_t>(value));
+            }
+            else {
+                writer.writeWord(value);
+            }
+        }
+    }
+
+    void writeSOF(BitStreamWriter& writer, const SOF0& sof)
+    {
+        writer.writeMarker(getMarkerCode(sof.marker));
+        writer.writeWord(static_cast<uint16_t>(8 + sof.components.size() * 3));
+        writer.writeByte(sof.precision);
+        writer.writeWord(sof.height);
+        writer.writeWord(sof.width);
+        writer.writeByte(static_cast<uint8_t>(sof.components.size()));
+        for (const auto& component : sof.components) {
+            writer.writeByte(static_cast<uint8_t>(component.id));
+            writer.writeByte(static_cast<uint8_t>((component.horizonalSamplingFactor << 4) | component.verticalSamplingFactor));
+            writer.writeByte(static_cast<uint8_t>(component.tableID));
+        }
+    }
+
+    void writeDHT(BitStreamWriter& writer, const DHT& dht)
+    {
+        writer.writeMarker(getMarkerCode(Marker::DHT));
+        writer.writeWord(static_cast<uint16_t>(2 + 1 + 16 + dht.symbols.size()));
+        writer.writeByte(static_cast<uint8_t>((static_cast<uint8_t>(dht.tableClass) << 4) | static_cast<uint8_t>(dht.tableID)));
+        writer.writeBytes(dht.counts);
+        writer.writeBytes(dht.symbols);
+    }
+
+    void writeDRI(BitStreamWriter& writer, uint16_t restartInterval)
+    {
+        writer.writeMarker(getMarkerCode(Marker::DRI));
+        writer.writeWord(4);
+        writer.writeWord(restartInterval);
+    }
+
+    void writeSOS(BitStreamWriter& writer, const SOS& sos)
+    {
+        writer.writeMarker(getMarkerCode(Marker::SOS));
+        writer.writeWord(static_cast<uint16_t>(6 + sos.components.size() * 2));
+        writer.writeByte(static_cast<uint8_t>(sos.components.size()));
+        for (const auto& component : sos.components) {
+            writer.writeByte(static_cast<uint8_t>(component.componentSelector));
+            writer.writeByte(static_cast<uint8_t>((static_cast<uint8_t>(component.dcSelector) << 4) | static_cast<uint8_t>(component.acSelector)));
+        }
+        writer.writeByte(sos.spectralSelectionStart);
+        writer.writeByte(sos.spectralSelectionEnd);
+        // 上位 4 ビットが Ah、下位 4 ビットが Al
+        writer.writeByte(sos.successiveApproximation);
+    }
+} // namespace RagiMagick2::Image::Jpeg
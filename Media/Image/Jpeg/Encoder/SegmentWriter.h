@@ -0,0 +1,37 @@
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include "Image/Jpeg/BitStreamWriter.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // マーカーセグメントを書き込む (JpegParser の parseXXX の逆)
+    // 長さ (Lf, Lh, Ls など) はセグメントの中身から計算するので、構造体の length は使わない
+
+    // マーカーの2バイト目 (BitStreamWriter::writeMarker に渡す値)
+    inline constexpr uint8_t getMarkerCode(Syntax::Marker marker) noexcept
+    {
+        return static_cast<uint8_t>(static_cast<uint16_t>(marker) & 0xFF);
+    }
+
+    // JFIF APP0 (バージョン 1.01、縦横比 1:1、サムネイル無し)
+    void writeAPP0(BitStreamWriter& writer);
+
+    // B.2.4.1 量子化テーブル (table は自然順)
+    // 全ての値が 255 以下なら 8 ビット精度、そうでなければ 16 ビット精度で書き込む
+    void writeDQT(BitStreamWriter& writer, Syntax::QuantizationTableID tableID, const std::array<uint16_t, 64>& table);
+
+    // B.2.2 フレームヘッダ (marker は SOF0 など)
+    void writeSOF(BitStreamWriter& writer, const Syntax::SOF0& sof);
+
+    // B.2.4.2 ハフマンテーブル
+    void writeDHT(BitStreamWriter& writer, const Syntax::DHT& dht);
+
+    // B.2.4.4 リスタート間隔
+    void writeDRI(BitStreamWriter& writer, uint16_t restartInterval);
+
+    // B.2.3 スキャンヘッダ
+    void writeSOS(BitStreamWriter& writer, const Syntax::SOS& sos);
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,248 @@
+﻿#include "ExifReader.h"
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+namespace
+{
+    constexpr uint8_t EXIF_HEADER[] = { 'E', 'x', 'i', 'f', 0, 0 };
+    constexpr size_t TIFF_HEADER_SIZE = 8;
+    constexpr size_t ENTRY_SIZE = 12;
+
+    // Type ごとの1要素のバイト数 (BYTE, ASCII, SHORT, LONG, RATIONAL, SBYTE, UNDEFINED, SSHORT, SLONG, SRATIONAL, FLOAT, DOUBLE)
+    constexpr size_t getTypeSize(uint16_t type) noexcept
+    {
+        switch (type) {
+        case 1: case 2: case 6: case 7:
+            return 1;
+        case 3: case 8:
+            return 2;
+        case 4: case 9: case 11:
+            return 4;
+        case 5: case 10: case 12:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    constexpr uint16_t TYPE_ASCII = 2;
+    constexpr uint16_t TYPE_SHORT = 3;
+    constexpr uint16_t TYPE_LONG = 4;
+
+    // IFD0, IFD1
+    constexpr uint16_t TAG_COMPRESSION = 0x0103;
+    constexpr uint16_t TAG_ORIENTATION = 0x0112;
+    constexpr uint16_t TAG_DATE_TIME = 0x0132;
+    constexpr uint16_t TAG_JPEG_INTERCHANGE_FORMAT = 0x0201;
+    constexpr uint16_t TAG_JPEG_INTERCHANGE_FORMAT_LENGTH = 0x0202;
+    constexpr uint16_t TAG_EXIF_IFD_POINTER = 0x8769;
+    // Exif IFD
+    constexpr uint16_t TAG_DATE_TIME_ORIGINAL = 0x9003;
+    constexpr uint16_t TAG_DATE_TIME_DIGITIZED = 0x9004;
+    constexpr uint16_t TAG_PIXEL_X_DIMENSION = 0xA002;
+    constexpr uint16_t TAG_PIXEL_Y_DIMENSION = 0xA003;
+
+    // Compression が 6 (旧 JPEG) ならサムネイルは JPEG
+    constexpr uint32_t COMPRESSION_JPEG = 6;
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    ExifReader::ExifReader(std::span<const uint8_t> data) noexcept
+    {
+        if (data.size() < sizeof(EXIF_HEADER) + TIFF_HEADER_SIZE || std::memcmp(data.data(), EXIF_HEADER, sizeof(EXIF_HEADER)) != 0) {
+            return;
+        }
+
+        // TIFF ヘッダ ("II" ならリトルエンディアン、 "MM" ならビッグエンディアン)
+        const auto tiff = data.subspan(sizeof(EXIF_HEADER));
+        if (tiff[0] == 'I' && tiff[1] == 'I') {
+            m_IsLittleEndian = true;
+        }
+        else if (tiff[0] == 'M' && tiff[1] == 'M') {
+            m_IsLittleEndian = false;
+        }
+        else {
+            return;
+        }
+
+        m_Tiff = tiff;
+        if (readUInt16(2) != 0x002A) {
+            m_Tiff = {};
+            return;
+        }
+        m_IFD0 = readUInt32(4);
+    }
+
+    ExifReader::~ExifReader()
+    {
+    }
+
+    uint16_t ExifReader::readUInt16(size_t offset) const noexcept
+    {
+        if (offset + 2 > m_Tiff.size()) {
+            return 0;
+        }
+        return m_IsLittleEndian
+            ? static_cast<uint16_t>(m_Tiff[offset] | (m_Tiff[offset + 1] << 8))
+            : static_cast<uint16_t>((m_Tiff[offset] << 8) | m_Tiff[offset + 1]);
+    }
+
+    uint32_t ExifReader::readUInt32(size_t offset) const noexcept
+    {
+        return m_IsLittleEndian
+            ? (static_cast<uint32_t>(readUInt16(offset + 2)) << 16) | readUInt16(offset)
+            : (static_cast<uint32_t>(readUInt16(offset)) << 16) | readUInt16(offset + 2);
+    }
+
+    std::optional<ExifReader::Entry> ExifReader::findEntry(uint32_t ifdOffset, uint16_t tag) const noexcept
+    {
+        // 0 は TIFF ヘッダなので IFD ではない (ポインタが無い場合も 0)
+        if (ifdOffset < TIFF_HEADER_SIZE || static_cast<size_t>(ifdOffset) + 2 > m_Tiff.size()) {
+            return std::nullopt;
+        }
+
+        const size_t count = readUInt16(ifdOffset);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t entry = ifdOffset + 2 + i * ENTRY_SIZE;
+            if (entry + ENTRY_SIZE > m_Tiff.size()) {
+                break;
+            }
+            if (readUInt16(entry) != tag) {
+                continue;
+            }
+
+            Entry result{};
+            result.type = readUInt16(entry + 2);
+            result.count = readUInt32(entry + 4);
+            const size_t size = getTypeSize(result.type) * result.count;
+            if (size <= 4) {
+                result.value = m_Tiff.subspan(entry + 8, size);
+            }
+            else {
+                const size_t offset = readUInt32(entry + 8);
+                if (offset > m_Tiff.size() || size > m_Tiff.size() - offset) {
+                    return std::nullopt;
+                }
+                result.value = m_Tiff.subspan(offset, size);
+            }
+            return result;
+        }
+        return std::nullopt;
+    }
+
+    uint32_t ExifReader::getNextIFD(uint32_t ifdOffset) const noexcept
+    {
+        if (ifdOffset < TIFF_HEADER_SIZE || static_cast<size_t>(ifdOffset) + 2 > m_Tiff.size()) {
+            return 0;
+        }
+        const size_t count = readUInt16(ifdOffset);
+        return readUInt32(ifdOffset + 2 + count * ENTRY_SIZE);
+    }
+
+    uint32_t ExifReader::getExifIFD() const noexcept
+    {
+        return findInteger(m_IFD0, TAG_EXIF_IFD_POINTER).value_or(0);
+    }
+
+    std::optional<uint32_t> ExifReader::findInteger(uint32_t ifdOffset, uint16_t tag) const noexcept
+    {
+        const auto entry = findEntry(ifdOffset, tag);
+        if (!entry || entry->count != 1) {
+            return std::nullopt;
+        }
+        // 値はエントリの Value に左詰めで入っている
+        const size_t offset = entry->value.data() - m_Tiff.data();
+        switch (entry->type) {
+        case TYPE_SHORT:
+            return readUInt16(offset);
+        case TYPE_LONG:
+            return readUInt32(offset);
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<std::string_view> ExifReader::findString(uint32_t ifdOffset, uint16_t tag) const noexcept
+    {
+        const auto entry = findEntry(ifdOffset, tag);
+        if (!entry || entry->type != TYPE_ASCII) {
+            return std::nullopt;
+        }
+        std::string_view value(reinterpret_cast<const char*>(entry->value.data()), entry->value.size());
+        // Count には終端の NUL も含まれる
+        if (const auto end = value.find('\0'); end != std::string_view::npos) {
+            value = value.substr(0, end);
+        }
+        return value;
+    }
+
+    std::optional<int> ExifReader::getOrientation() const noexcept
+    {
+        const auto orientation = findInteger(m_IFD0, TAG_ORIENTATION);
+        if (!orientation || *orientation < 1 || *orientation > 8) {
+            return std::nullopt;
+        }
+        return static_cast<int>(*orientation);
+    }
+
+    std::optional<size_t> ExifReader::getOrientationOffset() const noexcept
+    {
+        const auto entry = findEntry(m_IFD0, TAG_ORIENTATION);
+        if (!entry || entry->type != TYPE_SHORT || entry->count != 1) {
+            return std::nullopt;
+        }
+        return sizeof(EXIF_HEADER) + (entry->value.data() - m_Tiff.data());
+    }
+
+    std::optional<std::tuple<int, int>> ExifReader::getPixelDimensions() const noexcept
+    {
+        const uint32_t exifIFD = getExifIFD();
+        const auto width = findInteger(exifIFD, TAG_PIXEL_X_DIMENSION);
+        const auto height = findInteger(exifIFD, TAG_PIXEL_Y_DIMENSION);
+        if (!width || !height || *width > INT32_MAX || *height > INT32_MAX) {
+            return std::nullopt;
+        }
+        return std::make_tuple(static_cast<int>(*width), static_cast<int>(*height));
+    }
+
+    std::optional<std::string_view> ExifReader::getDateTime() const noexcept
+    {
+        return findString(m_IFD0, TAG_DATE_TIME);
+    }
+
+    std::optional<std::string_view> ExifReader::getDateTimeOriginal() const noexcept
+    {
+        return findString(getExifIFD(), TAG_DATE_TIME_ORIGINAL);
+    }
+
+    std::optional<std::string_view> ExifReader::getDateTimeDigitized() const noexcept
+    {
+        return findString(getExifIFD(), TAG_DATE_TIME_DIGITIZED);
+    }
+
+    std::span<const uint8_t> ExifReader::getThumbnail() const noexcept
+    {
+        // IFD1 (IFD0 の次の IFD) がサムネイルの IFD
+        const uint32_t ifd1 = getNextIFD(m_IFD0);
+        if (const auto compression = findInteger(ifd1, TAG_COMPRESSION); compression && *compression != COMPRESSION_JPEG) {
+            return {};
+        }
+
+        const auto offset = findInteger(ifd1, TAG_JPEG_INTERCHANGE_FORMAT);
+        const auto length = findInteger(ifd1, TAG_JPEG_INTERCHANGE_FORMAT_LENGTH);
+        if (!offset || !length || *offset > m_Tiff.size() || *length > m_Tiff.size() - *offset || *length < 4) {
+            return {};
+        }
+
+        const auto thumbnail = m_Tiff.subspan(*offset, *length);
+        if (thumbnail[0] != 0xFF || thumbnail[1] != 0xD8) {
+            return {};
+        }
+        return thumbnail;
+    }
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,75 @@
+﻿#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // APP1 の EXIF (TIFF 構造) から必要なタグだけを読む
+    // コンストラクタではヘッダを確認するだけで、 IFD はタグを取得するときに必要な分だけたどる。
+    // 値はコピーせずに APP1 のデータをそのまま指すので、 data は ExifReader (と取得した値) を使い終わるまで有効であること
+    class ExifReader final
+    {
+    public:
+        // data は APP1 の length の後ろ ("Exif\0\0" から)
+        ExifReader(std::span<const uint8_t> data) noexcept;
+        ~ExifReader();
+
+        // EXIF の APP1 で、 TIFF ヘッダが正しければ true
+        inline bool isValid() const noexcept { return !m_Tiff.empty(); }
+
+        // IFD0 の Orientation (1～8)
+        std::optional<int> getOrientation() const noexcept;
+        // IFD0 の Orientation の値 (SHORT) の位置 (コンストラクタに渡した data の先頭からのオフセット)
+        // 値を書き換える場合に使う (バイト順は isLittleEndian)
+        std::optional<size_t> getOrientationOffset() const noexcept;
+        inline bool isLittleEndian() const noexcept { return m_IsLittleEndian; }
+        // Exif IFD の PixelXDimension, PixelYDimension (幅, 高さ)
+        std::optional<std::tuple<int, int>> getPixelDimensions() const noexcept;
+        // "YYYY:MM:DD HH:MM:SS" の形式の日時 (末尾の NUL は含まない)
+        // IFD0 の DateTime (ファイルの変更日時)
+        std::optional<std::string_view> getDateTime() const noexcept;
+        // Exif IFD の DateTimeOriginal (撮影日時)
+        std::optional<std::string_view> getDateTimeOriginal() const noexcept;
+        // Exif IFD の DateTimeDigitized (デジタル化した日時)
+        std::optional<std::string_view> getDateTimeDigitized() const noexcept;
+
+        // IFD1 の JPEGInterchangeFormat が指すサムネイル (SOI から EOI まで) をそのまま返す
+        // サムネイルが無いか JPEG でない場合は空
+        std::span<const uint8_t> getThumbnail() const noexcept;
+
+    private:
+        // IFD のエントリ (Tag (2), Type (2), Count (4), Value (4) の 12 バイト)
+        struct Entry
+        {
+            uint16_t type = 0;
+            uint32_t count = 0;
+            // 値 (4 バイトに収まる場合はエントリの中、収まらない場合は Value が指す位置)
+            std::span<const uint8_t> value{};
+        };
+
+        uint16_t readUInt16(size_t offset) const noexcept;
+        uint32_t readUInt32(size_t offset) const noexcept;
+
+        // offset の IFD から tag のエントリを探す
+        std::optional<Entry> findEntry(uint32_t ifdOffset, uint16_t tag) const noexcept;
+        // offset の IFD の次の IFD の位置 (無ければ 0)
+        uint32_t getNextIFD(uint32_t ifdOffset) const noexcept;
+        // Exif IFD の位置 (IFD0 の ExifIFDPointer、無ければ 0)
+        uint32_t getExifIFD() const noexcept;
+
+        // SHORT か LONG の値 (Count が 1 のもの)
+        std::optional<uint32_t> findInteger(uint32_t ifdOffset, uint16_t tag) const noexcept;
+        // ASCII の値
+        std::optional<std::string_view> findString(uint32_t ifdOffset, uint16_t tag) const noexcept;
+
+    private:
+        // TIFF ヘッダ ("II" か "MM") からの範囲 (IFD の位置は全てここからのオフセット)
+        std::span<const uint8_t> m_Tiff{};
+        bool m_IsLittleEndian = true;
+        uint32_t m_IFD0 = 0;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
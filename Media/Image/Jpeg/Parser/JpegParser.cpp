@@ -1,379 +1,597 @@
-﻿#include "JpegParser.h"
-#include <cstdint>
-#include <memory>
-#include <print>
-#include <variant>
-#include <vector>
-#include "Common/BinaryFileReader.h"
-#include "Image/Jpeg/Syntax/Marker.h"
-#include "Image/Jpeg/Syntax/Segment.h"
-
-using namespace RagiMagick2::Common;
-using namespace RagiMagick2::Image::Jpeg::Syntax;
-
-namespace RagiMagick2::Image::Jpeg
-{
-    JpegParser::JpegParser(std::string_view fileName) noexcept
-        : m_FileReader(fileName)
-    {
-    }
-
-    JpegParser::~JpegParser()
-    {
-    }
-
-    bool JpegParser::parse() noexcept
-    {
-        if (!m_FileReader.open()) {
-            std::println("Failed to open file");
-            return false;
-        }
-
-        Marker marker{};
-        m_FileReader.ReadUInt16(marker);
-        m_Markers.push_back(marker);
-
-        if (marker != Marker::SOI) {
-            std::println("Invalid JPEG file");
-            return false;
-        }
-
-        while (true) {
-            using enum Marker;
-            switch (marker) {
-            case SOI:
-                parseSOI();
-                break;
-            case APP0:
-                parseAPP0();
-                break;
-            case DQT:
-                parseDQT();
-                break;
-            case SOF0:
-                parseSOF0();
-                break;
-            case EOI:
-                parseEOI();
-                return true;
-            case DHT:
-                parseDHT();
-                break;
-            case SOS:
-                parseSOS();
-                break;
-            case DRI:
-                parseDRI();
-                break;
-            case APP1:
-                parseAPP1();
-                break;
-            case APP2:
-                parseAPP2();
-                break;
-            case APP13:
-                parseAPP13();
-                break;
-            case APP14:
-                parseAPP14();
-                break;
-            case APP3:
-            case APP4:
-            case APP5:
-            case APP6:
-            case APP7:
-            case APP8:
-            case APP9:
-            case APP10:
-            case APP11:
-            case APP12:
-            case APP15:
-                std::println("Unsupported marker: 0x{:02X}", static_cast<uint16_t>(marker));
-                break; // 無視
-            case COM:
-                parseCOM();
-                break;
-            default:
-                std::println("Unknown marker: 0x{:02X}", static_cast<uint16_t>(marker));
-                return false; // 中断
-            }
-            m_FileReader.ReadUInt16(marker);
-            m_Markers.push_back(marker);
-        }
-
-        return true;
-    }
-
-    void JpegParser::parseSOI()
-    {
-        auto soi = SOI{};
-        soi.marker = Marker::SOI;
-        m_Segments.emplace_back(std::make_shared<SOI>(soi));
-    }
-
-    void JpegParser::parseAPP0()
-    {
-        auto app0 = APP0{};
-        app0.marker = Marker::APP0;
-        m_FileReader.ReadUInt16(app0.length);
-
-        int remain = app0.length - sizeof(app0.length);
-        if (remain >= sizeof(app0.identifier)) {
-            m_FileReader.ReadBytes(app0.identifier);
-            remain -= sizeof(app0.identifier);
-        }
-        if (remain >= sizeof(app0.version)) {
-            m_FileReader.ReadUInt16(app0.version);
-            remain -= sizeof(app0.version);
-        }
-        if (remain >= sizeof(app0.units)) {
-            m_FileReader.ReadUInt8(app0.units);
-            remain -= sizeof(app0.units);
-        }
-        if (remain >= sizeof(app0.xDensity) + sizeof(app0.yDensity)) {
-            m_FileReader.ReadUInt16(app0.xDensity);
-            m_FileReader.ReadUInt16(app0.yDensity);
-            remain -= sizeof(app0.xDensity) + sizeof(app0.yDensity);
-        }
-        if (remain >= sizeof(app0.thumbnailWidth) + sizeof(app0.thumbnailHeight)) {
-            m_FileReader.ReadUInt8(app0.thumbnailWidth);
-            m_FileReader.ReadUInt8(app0.thumbnailHeight);
-            remain -= sizeof(app0.thumbnailWidth) + sizeof(app0.thumbnailHeight);
-        }
-        m_Segments.emplace_back(std::make_shared<APP0>(app0));
-    }
-
-    void JpegParser::parseDQT()
-    {
-        auto dqt = DQT{};
-        dqt.marker = Marker::DQT;
-        m_FileReader.ReadUInt16(dqt.length);
-
-        int remain = dqt.length - sizeof(dqt.length);
-        if (remain >= 1) {
-            uint8_t value = 0;
-            m_FileReader.ReadUInt8(value);
-            dqt.precision = static_cast<DQT::Precision>(value >> 4);
-            dqt.tableID = static_cast<QuantizationTableID>(value & 0x0F);
-            remain--;
-        }
-
-        switch (dqt.precision) {
-        case DQT::Precision::BITS_8:
-            if (int size = sizeof(std::get<DQT::Bits8Table>(dqt.table)); remain >= size) {
-                m_FileReader.ReadBytes(std::get<DQT::Bits8Table>(dqt.table));
-                remain -= size;
-            }
-            m_Segments.emplace_back(std::make_shared<DQT>(dqt));
-
-            // Luminance と Chrominance の情報が 1つの DQT にまとめられている場合を考慮
-            if (remain >= 1) {
-                uint8_t value = 0;
-                m_FileReader.ReadUInt8(value);
-                dqt.precision = static_cast<DQT::Precision>(value >> 4);
-                dqt.tableID = static_cast<QuantizationTableID>(value & 0x0F);
-                remain--;
-            }
-
-            if (int size = sizeof(std::get<DQT::Bits8Table>(dqt.table)); remain >= size) {
-                m_FileReader.ReadBytes(std::get<DQT::Bits8Table>(dqt.table));
-                remain -= size;
-            }
-            m_Segments.emplace_back(std::make_shared<DQT>(dqt));
-            break;
-        case DQT::Precision::BITS_16:
-            if (int size = sizeof(std::get<DQT::Bits16Table>(dqt.table)); remain >= size) {
-                m_FileReader.ReadBytes(std::get<DQT::Bits16Table>(dqt.table));
-                remain -= size;
-            }
-            m_Segments.emplace_back(std::make_shared<DQT>(dqt));
-            break;
-        default:
-            break;
-        }
-    }
-
-    void JpegParser::parseSOF0()
-    {
-        auto sof0 = SOF0{};
-        sof0.marker = Marker::SOF0;
-        m_FileReader.ReadUInt16(sof0.length);
-
-        int remain = sof0.length - sizeof(sof0.length);
-        if (remain >= 1) {
-            m_FileReader.ReadUInt8(sof0.precision);
-            remain--;
-        }
-        if (remain >= sizeof(sof0.height) + sizeof(sof0.width)) {
-            m_FileReader.ReadUInt16(sof0.height);
-            m_FileReader.ReadUInt16(sof0.width);
-            remain -= sizeof(sof0.height) + sizeof(sof0.width);
-        }
-        if (remain >= 1) {
-            m_FileReader.ReadUInt8(sof0.numComponents);
-            remain--;
-        }
-        sof0.components.resize(sof0.numComponents);
-        if (remain >= sizeof(sof0.components[0]) * sof0.numComponents) {
-            m_FileReader.ReadBytes(sof0.components);
-            remain -= sizeof(sof0.components[0]) * sof0.numComponents;
-        }
-
-        m_Segments.emplace_back(std::make_shared<SOF0>(sof0));
-    }
-
-    void JpegParser::parseDHT()
-    {
-        auto dht = DHT{};
-        dht.marker = Marker::DHT;
-        m_FileReader.ReadUInt16(dht.length);
-
-        int remain = dht.length - sizeof(dht.length);
-        while (remain > 0) {
-            if (remain >= 1) {
-                uint8_t value = 0;
-                m_FileReader.ReadUInt8(value);
-                dht.tableClass = static_cast<DHT::TableClass>(value >> 4);
-                dht.tableID = static_cast<HuffmanTableID>(value & 0xFF);
-                remain--;
-            }
-            if (remain >= sizeof(dht.counts)) {
-                m_FileReader.ReadBytes(dht.counts);
-                remain -= sizeof(dht.counts);
-            }
-            int total = 0;
-            for (auto count : dht.counts) {
-                total += count;
-            }
-            if (remain >= total) {
-                dht.symbols.resize(total);
-                m_FileReader.ReadBytes(dht.symbols);
-                remain -= total;
-            }
-            m_Segments.emplace_back(std::make_shared<DHT>(dht));
-        }
-    }
-
-    void JpegParser::parseSOS()
-    {
-        auto sos = SOS{};
-        sos.marker = Marker::SOS;
-        m_FileReader.ReadUInt16(sos.length);
-        int remain = sos.length - sizeof(sos.length);
-        if (remain >= 1) {
-            m_FileReader.ReadUInt8(sos.numComponents);
-            remain--;
-        }
-        sos.components.resize(sos.numComponents);
-        if (remain >= sizeof(sos.components[0]) * sos.numComponents) {
-            m_FileReader.ReadBytes(sos.components);
-            remain -= sizeof(sos.components[0]) * sos.numComponents;
-        }
-        if (remain >= 3) {
-            m_FileReader.ReadUInt8(sos.spectralSelectionStart);
-            m_FileReader.ReadUInt8(sos.spectralSelectionEnd);
-            m_FileReader.ReadUInt8(sos.successiveApproximation);
-            remain -= 3;
-        }
-
-        m_Segments.emplace_back(std::make_shared<SOS>(sos));
-
-        parseECS();
-    }
-
-    void JpegParser::parseECS()
-    {
-        auto current_pos = m_FileReader.GetCurrentPosition();
-        m_FileReader.Seek(-2, BinaryFileReader::SeekOrigin::End);
-        auto end_pos = m_FileReader.GetCurrentPosition();
-
-        Marker marker{};
-        m_FileReader.ReadUInt16(marker);
-
-        if (marker != Marker::EOI) {
-            std::println("[{}] Invalid JPEG file", __FUNCTION__);
-            return;
-        }
-
-        m_FileReader.Seek(current_pos);
-
-        m_ECS.resize(end_pos - current_pos);
-        m_FileReader.ReadBytes(m_ECS);
-    }
-
-    void JpegParser::parseEOI()
-    {
-        auto eoi = EOI{};
-        eoi.marker = Marker::EOI;
-        m_Segments.emplace_back(std::make_shared<EOI>(eoi));
-    }
-
-    void JpegParser::parseDRI()
-    {
-        auto dri = DRI{};
-        dri.marker = Marker::DRI;
-        m_FileReader.ReadUInt16(dri.length);
-        int remain = dri.length - sizeof(dri.length);
-        if (remain >= sizeof(dri.restartInterval)) {
-            m_FileReader.ReadUInt16(dri.restartInterval);
-            remain -= sizeof(dri.restartInterval);
-        }
-        m_Segments.emplace_back(std::make_shared<DRI>(dri));
-    }
-
-    void JpegParser::parseAPP1()
-    {
-        auto app1 = APP1{};
-        app1.marker = Marker::APP1;
-        m_FileReader.ReadUInt16(app1.length);
-        m_Segments.emplace_back(std::make_shared<APP1>(app1));
-
-        int remain = app1.length - sizeof(app1.length);
-        m_FileReader.Seek(remain, BinaryFileReader::SeekOrigin::Current); // 捨てる
-    }
-
-    void JpegParser::parseAPP2()
-    {
-        auto app2 = APP2{};
-        app2.marker = Marker::APP2;
-        m_FileReader.ReadUInt16(app2.length);
-        m_Segments.emplace_back(std::make_shared<APP2>(app2));
-
-        int remain = app2.length - sizeof(app2.length);
-        m_FileReader.Seek(remain, BinaryFileReader::SeekOrigin::Current); // 捨てる
-    }
-
-    void JpegParser::parseAPP13()
-    {
-        auto app13 = APP13{};
-        app13.marker = Marker::APP13;
-        m_FileReader.ReadUInt16(app13.length);
-        m_Segments.emplace_back(std::make_shared<APP13>(app13));
-
-        int remain = app13.length - sizeof(app13.length);
-        m_FileReader.Seek(remain, BinaryFileReader::SeekOrigin::Current); // 捨てる
-    }
-
-    void JpegParser::parseAPP14()
-    {
-        auto app14 = APP14{};
-        app14.marker = Marker::APP14;
-        m_FileReader.ReadUInt16(app14.length);
-        m_Segments.emplace_back(std::make_shared<APP14>(app14));
-
-        int remain = app14.length - sizeof(app14.length);
-        m_FileReader.Seek(remain, BinaryFileReader::SeekOrigin::Current); // 捨てる
-    }
-
-    void JpegParser::parseCOM()
-    {
-        auto com = COM{};
-        com.marker = Marker::COM;
-        m_FileReader.ReadUInt16(com.length);
-        int remain = com.length - sizeof(com.length);
-        com.comment.resize(remain);
-        m_FileReader.ReadBytes(com.comment);
-        m_Segments.emplace_back(std::make_shared<COM>(com));
-    }
-
-} // namespace RagiMagick2::Image::Jpeg
+﻿#include "JpegParser.h"
+#include <cstdint>
+#include <memory>
+#include <print>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Common/BinaryMemoryReader.h"
+#include "Common/MemoryMappedFile.h"
+#include "Image/Jpeg/Exif/ExifReader.h"
+#include "Image/Jpeg/Syntax/Marker.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+using namespace RagiMagick2::Common;
+using namespace RagiMagick2::Image::Jpeg::Syntax;
+
+namespace RagiMagick2::Image::Jpeg
+{
+    JpegParser::JpegParser(std::string_view fileName) noexcept
+    {
+        m_File.emplace(fileName);
+    }
+
+    JpegParser::JpegParser(std::span<const uint8_t> data) noexcept
+        : m_Data(data)
+    {
+    }
+
+    JpegParser::~JpegParser()
+    {
+    }
+
+    bool JpegParser::open() noexcept
+    {
+        if (m_File) {
+            if (!m_File->open()) {
+                std::println("Failed to open file");
+                return false;
+            }
+            m_Data = m_File->GetData();
+        }
+
+        m_Reader = BinaryMemoryReader(m_Data);
+        return true;
+    }
+
+    bool JpegParser::parse() noexcept
+    {
+        if (!open()) {
+            return false;
+        }
+
+        m_Markers.clear();
+        m_Segments.clear();
+        m_HasSegments = false;
+        m_Index = {};
+        m_ECS = {};
+        m_Exif = {};
+        m_MetadataSegments.clear();
+
+        Marker marker{};
+        m_Reader.ReadUInt16(marker);
+        m_Markers.push_back(marker);
+
+        if (marker != Marker::SOI) {
+            std::println("Invalid JPEG file");
+            return false;
+        }
+
+        while (true) {
+            using enum Marker;
+            const size_t segmentStart = m_Reader.GetCurrentPosition() - sizeof(marker);
+            switch (marker) {
+            case SOI:
+                parseSOI();
+                break;
+            case APP0:
+                parseAPP0();
+                break;
+            case DQT:
+                parseDQT();
+                break;
+            case SOF0:
+                parseSOF0();
+                break;
+            case SOF1:
+            case SOF2:
+                parseSOF0(marker);
+                break;
+            case EOI:
+                parseEOI();
+                return true;
+            case DHT:
+                parseDHT();
+                break;
+            case SOS:
+                parseSOS();
+                break;
+            case DRI:
+                parseDRI();
+                break;
+            case APP1:
+                parseAPP1();
+                break;
+            case APP2:
+                parseAPP2();
+                break;
+            case APP13:
+                parseAPP13();
+                break;
+            case APP14:
+                parseAPP14();
+                break;
+            case APP3:
+            case APP4:
+            case APP5:
+            case APP6:
+            case APP7:
+            case APP8:
+            case APP9:
+            case APP10:
+            case APP11:
+            case APP12:
+            case APP15:
+                skipSegment(); // 中身は使わない
+                break;
+            case COM:
+                parseCOM();
+                break;
+            default:
+                std::println("Unknown marker: 0x{:02X}", static_cast<uint16_t>(marker));
+                return false; // 中断
+            }
+            if ((marker >= APP1 && marker <= APP15) || marker == COM) {
+                m_MetadataSegments.push_back(m_Data.subspan(segmentStart, m_Reader.GetCurrentPosition() - segmentStart));
+            }
+            if (m_Reader.isEOF()) {
+                // EOI が無くても、スキャンが1つ以上あれば最後まで読んだものとして扱う
+                if (m_Index.sos) {
+                    return true;
+                }
+                std::println("Unexpected end of file");
+                return false;
+            }
+            m_Reader.ReadUInt16(marker);
+            m_Markers.push_back(marker);
+        }
+
+        return true;
+    }
+
+    const std::vector<std::shared_ptr<Syntax::Segment>>& JpegParser::getSegments() noexcept
+    {
+        // デコーダは m_Index を指しているので、別のパーサーで解析し直してセグメントだけを受け取る
+        if (!m_HasSegments && !m_Data.empty()) {
+            JpegParser parser(m_Data);
+            parser.m_IsCollectingSegments = true;
+            parser.parse();
+            m_Segments = std::move(parser.m_Segments);
+            m_HasSegments = true;
+        }
+        return m_Segments;
+    }
+
+    bool JpegParser::probe(JpegInfo& info) noexcept
+    {
+        if (!open()) {
+            return false;
+        }
+
+        Marker marker{};
+        m_Reader.ReadUInt16(marker);
+        if (marker != Marker::SOI) {
+            return false;
+        }
+
+        info = {};
+        m_Exif = {};
+        bool hasFrameHeader = false;
+
+        while (!m_Reader.isEOF()) {
+            m_Reader.ReadUInt16(marker);
+
+            using enum Marker;
+            switch (marker) {
+            case SOF0:
+            case SOF1:
+            case SOF2:
+            {
+                uint16_t length = 0;
+                uint8_t precision = 0;
+                uint16_t height = 0;
+                uint16_t width = 0;
+                uint8_t numComponents = 0;
+                m_Reader.ReadUInt16(length);
+                m_Reader.ReadUInt8(precision);
+                m_Reader.ReadUInt16(height);
+                m_Reader.ReadUInt16(width);
+                m_Reader.ReadUInt8(numComponents);
+
+                info.width = width;
+                info.height = height;
+                info.componentCount = numComponents;
+                info.isProgressive = marker == SOF2;
+                for (int i = 0; i < numComponents; ++i) {
+                    uint8_t id = 0;
+                    uint8_t samplingFactor = 0;
+                    uint8_t tableID = 0;
+                    m_Reader.ReadUInt8(id);
+                    m_Reader.ReadUInt8(samplingFactor);
+                    m_Reader.ReadUInt8(tableID);
+                    info.samplingFactors.emplace_back(samplingFactor >> 4, samplingFactor & 0x0F);
+                }
+                hasFrameHeader = true;
+                break;
+            }
+            case APP1:
+            {
+                uint16_t length = 0;
+                m_Reader.ReadUInt16(length);
+                const auto data = m_Reader.ReadSpan(length - sizeof(length));
+                // APP1 は XMP の場合もあるので、 EXIF の場合だけ採用する
+                if (const ExifReader exif(data); exif.isValid() && m_Exif.empty()) {
+                    m_Exif = data;
+                    info.orientation = exif.getOrientation().value_or(1);
+                    info.dateTime = exif.getDateTimeOriginal().value_or(exif.getDateTime().value_or(""));
+                    info.thumbnailSize = exif.getThumbnail().size();
+                }
+                break;
+            }
+            case SOS:
+            case EOI:
+                return hasFrameHeader;
+            default:
+                // RSTn などの長さを持たないマーカーはヘッダ部分には出てこない
+                if ((static_cast<uint16_t>(marker) & 0xFF00) != 0xFF00) {
+                    return false;
+                }
+                skipSegment();
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    void JpegParser::skipSegment()
+    {
+        uint16_t length = 0;
+        m_Reader.ReadUInt16(length);
+        m_Reader.Seek(length - sizeof(length), BinaryMemoryReader::SeekOrigin::Current);
+    }
+
+    void JpegParser::parseSOI()
+    {
+        auto soi = SOI{};
+        soi.marker = Marker::SOI;
+        addSegment(soi);
+    }
+
+    void JpegParser::parseAPP0()
+    {
+        auto app0 = APP0{};
+        app0.marker = Marker::APP0;
+        m_Reader.ReadUInt16(app0.length);
+
+        int remain = app0.length - sizeof(app0.length);
+        if (remain >= static_cast<int>(sizeof(app0.identifier))) {
+            m_Reader.ReadBytes(app0.identifier);
+            remain -= sizeof(app0.identifier);
+        }
+        if (remain >= static_cast<int>(sizeof(app0.version))) {
+            m_Reader.ReadUInt16(app0.version);
+            remain -= sizeof(app0.version);
+        }
+        if (remain >= static_cast<int>(sizeof(app0.units))) {
+            m_Reader.ReadUInt8(app0.units);
+            remain -= sizeof(app0.units);
+        }
+        if (remain >= static_cast<int>(sizeof(app0.xDensity) + sizeof(app0.yDensity))) {
+            m_Reader.ReadUInt16(app0.xDensity);
+            m_Reader.ReadUInt16(app0.yDensity);
+            remain -= sizeof(app0.xDensity) + sizeof(app0.yDensity);
+        }
+        if (remain >= static_cast<int>(sizeof(app0.thumbnailWidth) + sizeof(app0.thumbnailHeight))) {
+            m_Reader.ReadUInt8(app0.thumbnailWidth);
+            m_Reader.ReadUInt8(app0.thumbnailHeight);
+            remain -= sizeof(app0.thumbnailWidth) + sizeof(app0.thumbnailHeight);
+        }
+        addSegment(app0);
+    }
+
+    void JpegParser::parseDQT()
+    {
+        auto dqt = DQT{};
+        dqt.marker = Marker::DQT;
+        m_Reader.ReadUInt16(dqt.length);
+
+        // 1つの DQT に複数のテーブル (Luminance と Chrominance など) がまとめられている場合がある
+        int remain = dqt.length - sizeof(dqt.length);
+        while (remain >= 1) {
+            uint8_t value = 0;
+            m_Reader.ReadUInt8(value);
+            dqt.precision = static_cast<DQT::Precision>(value >> 4);
+            dqt.tableID = static_cast<QuantizationTableID>(value & 0x0F);
+            remain--;
+
+            switch (dqt.precision) {
+            case DQT::Precision::BITS_8:
+            {
+                DQT::Bits8Table table{};
+                if (int size = sizeof(table); remain >= size) {
+                    m_Reader.ReadBytes(table);
+                    remain -= size;
+                }
+                dqt.table = table;
+                break;
+            }
+            case DQT::Precision::BITS_16:
+            {
+                // 16 ビットの要素はビッグエンディアン
+                DQT::Bits16Table table{};
+                if (int size = sizeof(table); remain >= size) {
+                    for (auto& element : table) {
+                        m_Reader.ReadUInt16(element);
+                    }
+                    remain -= size;
+                }
+                dqt.table = table;
+                break;
+            }
+            default:
+                // 不明な精度の場合は残りを捨てる
+                m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current);
+                return;
+            }
+            if (const auto id = std::to_underlying(dqt.tableID); id < m_Index.dqts.size()) {
+                m_Index.dqts[id] = dqt;
+            }
+            addSegment(dqt);
+        }
+    }
+
+    void JpegParser::parseSOF0(Marker marker)
+    {
+        auto sof0 = SOF0{};
+        sof0.marker = marker;
+        m_Reader.ReadUInt16(sof0.length);
+
+        int remain = sof0.length - sizeof(sof0.length);
+        if (remain >= 1) {
+            m_Reader.ReadUInt8(sof0.precision);
+            remain--;
+        }
+        if (remain >= static_cast<int>(sizeof(sof0.height) + sizeof(sof0.width))) {
+            m_Reader.ReadUInt16(sof0.height);
+            m_Reader.ReadUInt16(sof0.width);
+            remain -= sizeof(sof0.height) + sizeof(sof0.width);
+        }
+        if (remain >= 1) {
+            m_Reader.ReadUInt8(sof0.numComponents);
+            remain--;
+        }
+        // Figure B.3 – Frame header syntax (Ci, Hi, Vi, Tqi の 3 バイトずつ)
+        sof0.components.resize(sof0.numComponents);
+        for (auto& component : sof0.components) {
+            if (remain < 3) {
+                break;
+            }
+            uint8_t samplingFactor = 0;
+            m_Reader.ReadUInt8(component.id);
+            m_Reader.ReadUInt8(samplingFactor);
+            m_Reader.ReadUInt8(component.tableID);
+            component.horizonalSamplingFactor = samplingFactor >> 4;
+            component.verticalSamplingFactor = samplingFactor & 0x0F;
+            remain -= 3;
+        }
+
+        m_Index.sof = sof0;
+        addSegment(sof0);
+    }
+
+    void JpegParser::parseDHT()
+    {
+        auto dht = DHT{};
+        dht.marker = Marker::DHT;
+        m_Reader.ReadUInt16(dht.length);
+
+        int remain = dht.length - sizeof(dht.length);
+        while (remain > 0) {
+            if (remain >= 1) {
+                uint8_t value = 0;
+                m_Reader.ReadUInt8(value);
+                dht.tableClass = static_cast<DHT::TableClass>(value >> 4);
+                dht.tableID = static_cast<HuffmanTableID>(value & 0xFF);
+                remain--;
+            }
+            if (remain >= static_cast<int>(sizeof(dht.counts))) {
+                m_Reader.ReadBytes(dht.counts);
+                remain -= sizeof(dht.counts);
+            }
+            int total = 0;
+            for (auto count : dht.counts) {
+                total += count;
+            }
+            if (remain < total) {
+                // 壊れたセグメント (残りを捨てる)
+                m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current);
+                break;
+            }
+            dht.symbols.resize(total);
+            m_Reader.ReadBytes(dht.symbols);
+            remain -= total;
+
+            // スキャンはテーブルの添え字だけを持つので、 DHT は1回だけ追加する
+            auto& tables = (dht.tableClass == DHT::TableClass::DC_OR_LOSSLESS) ? m_Index.dcTables : m_Index.acTables;
+            if (const auto id = std::to_underlying(dht.tableID); id < tables.size()) {
+                tables[id] = static_cast<int>(m_Index.huffmanTables.size());
+            }
+            addSegment(dht);
+            m_Index.huffmanTables.push_back(std::move(dht));
+        }
+    }
+
+    void JpegParser::parseSOS()
+    {
+        auto sos = SOS{};
+        sos.marker = Marker::SOS;
+        m_Reader.ReadUInt16(sos.length);
+        int remain = sos.length - sizeof(sos.length);
+        if (remain >= 1) {
+            m_Reader.ReadUInt8(sos.numComponents);
+            remain--;
+        }
+        // Figure B.4 – Scan header syntax (Csj, Tdj, Taj の 2 バイトずつ)
+        sos.components.resize(sos.numComponents);
+        for (auto& component : sos.components) {
+            if (remain < 2) {
+                break;
+            }
+            uint8_t selectors = 0;
+            m_Reader.ReadUInt8(component.componentSelector);
+            m_Reader.ReadUInt8(selectors);
+            component.dcSelector = static_cast<HuffmanTableID>(selectors >> 4);
+            component.acSelector = static_cast<HuffmanTableID>(selectors & 0x0F);
+            remain -= 2;
+        }
+        if (remain >= 3) {
+            m_Reader.ReadUInt8(sos.spectralSelectionStart);
+            m_Reader.ReadUInt8(sos.spectralSelectionEnd);
+            m_Reader.ReadUInt8(sos.successiveApproximation);
+            remain -= 3;
+        }
+
+        addSegment(sos);
+
+        const auto ecs = parseECS();
+        if (!m_Index.sos) {
+            m_Index.sos = sos;
+            m_ECS = ecs;
+        }
+        m_Index.scans.push_back({
+            .sos = std::move(sos),
+            .ecs = ecs,
+            .dcTables = m_Index.dcTables,
+            .acTables = m_Index.acTables,
+            .restartInterval = m_Index.dri ? m_Index.dri->restartInterval : 0
+        });
+    }
+
+    std::span<const uint8_t> JpegParser::parseECS()
+    {
+        // ECS の終わりは、 0xFF00 (スタッフィング) と RSTn 以外のマーカーの手前
+        // データはコピーせずに、その範囲を指すだけにする
+        const auto data = m_Reader.GetRemainingData();
+        const uint8_t* begin = data.data();
+        const uint8_t* end = begin + data.size();
+        const uint8_t* p = begin;
+
+        while (p + 1 < end) {
+            p = static_cast<const uint8_t*>(std::memchr(p, 0xFF, end - p - 1));
+            if (p == nullptr) {
+                p = end;
+                break;
+            }
+            if (p[1] == 0x00 || (p[1] >= 0xD0 && p[1] <= 0xD7)) {
+                p += 2;
+                continue;
+            }
+            if (p[1] >= 0x02 && p[1] <= 0xBF) {
+                // 予約されたマーカー (Table B.1) は ECS の後ろに置かれないので、壊れたデータとして ECS に含める
+                // (デコーダの BitStreamReader はここで止まるので、壊れた区間として扱われる)
+                p += 2;
+                continue;
+            }
+            if (p[1] == 0xFF) {
+                // マーカーの前の埋め草
+                ++p;
+                continue;
+            }
+            break;
+        }
+        if (p + 1 >= end) {
+            // EOI が無いか途中で切れている (parse はスキャンまで読めていれば続ける)
+            std::println("[{}] Unexpected end of file", __FUNCTION__);
+            p = end;
+        }
+
+        return m_Reader.ReadSpan(p - begin);
+    }
+
+    void JpegParser::parseEOI()
+    {
+        auto eoi = EOI{};
+        eoi.marker = Marker::EOI;
+        addSegment(eoi);
+    }
+
+    void JpegParser::parseDRI()
+    {
+        auto dri = DRI{};
+        dri.marker = Marker::DRI;
+        m_Reader.ReadUInt16(dri.length);
+        int remain = dri.length - sizeof(dri.length);
+        if (remain >= static_cast<int>(sizeof(dri.restartInterval))) {
+            m_Reader.ReadUInt16(dri.restartInterval);
+            remain -= sizeof(dri.restartInterval);
+        }
+        m_Index.dri = dri;
+        addSegment(dri);
+    }
+
+    void JpegParser::parseAPP1()
+    {
+        auto app1 = APP1{};
+        app1.marker = Marker::APP1;
+        m_Reader.ReadUInt16(app1.length);
+
+        // EXIF などは後で必要になった時に解析するので、範囲だけ覚えておく
+        int remain = app1.length - sizeof(app1.length);
+        app1.data = m_Reader.ReadSpan(remain);
+        if (m_Exif.empty() && ExifReader(app1.data).isValid()) {
+            m_Exif = app1.data;
+        }
+        addSegment(app1);
+    }
+
+    void JpegParser::parseAPP2()
+    {
+        auto app2 = APP2{};
+        app2.marker = Marker::APP2;
+        m_Reader.ReadUInt16(app2.length);
+        addSegment(app2);
+
+        int remain = app2.length - sizeof(app2.length);
+        m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current); // 捨てる
+    }
+
+    void JpegParser::parseAPP13()
+    {
+        auto app13 = APP13{};
+        app13.marker = Marker::APP13;
+        m_Reader.ReadUInt16(app13.length);
+        addSegment(app13);
+
+        int remain = app13.length - sizeof(app13.length);
+        m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current); // 捨てる
+    }
+
+    void JpegParser::parseAPP14()
+    {
+        auto app14 = APP14{};
+        app14.marker = Marker::APP14;
+        m_Reader.ReadUInt16(app14.length);
+        addSegment(app14);
+
+        int remain = app14.length - sizeof(app14.length);
+        m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current); // 捨てる
+    }
+
+    void JpegParser::parseCOM()
+    {
+        auto com = COM{};
+        com.marker = Marker::COM;
+        m_Reader.ReadUInt16(com.length);
+        int remain = com.length - sizeof(com.length);
+        if (!m_IsCollectingSegments) {
+            m_Reader.Seek(remain, BinaryMemoryReader::SeekOrigin::Current);
+            return;
+        }
+        com.comment.resize(remain);
+        m_Reader.ReadBytes(com.comment);
+        addSegment(com);
+    }
+
+} // namespace RagiMagick2::Image::Jpeg
@@ -1,46 +1,161 @@
-﻿#pragma once
-#include <cstdint>
-#include <memory>
-#include <string_view>
-#include <vector>
-#include "Image/Jpeg/Syntax/Marker.h"
-#include "Image/Jpeg/Syntax/Segment.h"
-#include "Common/BinaryFileReader.h"
-
-namespace RagiMagick2::Image::Jpeg
-{
-    class JpegParser final
-    {
-    public:
-        JpegParser(std::string_view filename) noexcept;
-        ~JpegParser();
-
-        bool parse() noexcept;
-
-        inline auto getMarkers() const noexcept { return m_Markers; }
-        inline auto getSegments() const noexcept { return m_Segments; }
-        inline auto getECS() const noexcept { return m_ECS; }
-
-    private:
-        void parseSOI();
-        void parseAPP0();
-        void parseDQT();
-        void parseSOF0();
-        void parseEOI();
-        void parseDHT();
-        void parseSOS();
-        void parseECS();
-        void parseDRI();
-        void parseAPP1();
-        void parseAPP2();
-        void parseAPP13();
-        void parseAPP14();
-        void parseCOM();
-
-    private:
-        Common::BinaryFileReader m_FileReader;
-        std::vector<Syntax::Marker> m_Markers{};
-        std::vector<std::shared_ptr<Syntax::Segment>> m_Segments{};
-        std::vector<uint8_t> m_ECS{};
-    };
-} // namespace RagiMagick2::Image::Jpeg
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "Image/Jpeg/Syntax/Marker.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+#include "Common/BinaryMemoryReader.h"
+#include "Common/MemoryMappedFile.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // probe で取得する画像の情報
+    struct JpegInfo
+    {
+        int width = 0;
+        int height = 0;
+        int componentCount = 0;
+        // 成分ごとのサンプリングファクタ (H, V)
+        std::vector<std::tuple<uint8_t, uint8_t>> samplingFactors{};
+        // SOF2 (プログレッシブ) なら true
+        bool isProgressive = false;
+        // EXIF の Orientation (1～8、 EXIF が無ければ 1)
+        int orientation = 1;
+        // EXIF の撮影日時 (DateTimeOriginal、無ければ DateTime、どちらも無ければ空)
+        std::string dateTime{};
+        // EXIF の埋め込みサムネイル (JPEG) のバイト数 (無ければ 0)
+        size_t thumbnailSize = 0;
+    };
+
+    // parse の途中で作る、デコードに必要なセグメントの索引
+    // 種類ごと (DQT はテーブル ID ごと) に値で持つので、デコード時にセグメントを探す必要が無い
+    // 同じテーブル ID が再定義された場合は後のもので上書きする
+    struct SegmentIndex
+    {
+        // huffmanTables の添え字 (テーブル ID ごと、定義されていなければ NO_TABLE)
+        static constexpr int NO_TABLE = -1;
+        using TableIndices = std::array<int, 4>;
+
+        // スキャン1つ分 (SOS とそれに続く ECS)
+        // プログレッシブ JPEG ではスキャンの間で DHT や DRI を定義し直せるので、
+        // そのスキャンの時点で有効なハフマンテーブル (の添え字) とリスタート間隔も一緒に持つ
+        struct Scan
+        {
+            Syntax::SOS sos{};
+            // ファイル (データ) 中の ECS をそのまま指す
+            std::span<const uint8_t> ecs{};
+            TableIndices dcTables{};
+            TableIndices acTables{};
+            int restartInterval = 0;
+        };
+
+        // SOF0, SOF1, SOF2 のいずれか (marker で区別する)
+        std::optional<Syntax::SOF0> sof{};
+        // 最初の SOS
+        std::optional<Syntax::SOS> sos{};
+        std::optional<Syntax::DRI> dri{};
+        std::array<std::optional<Syntax::DQT>, 4> dqts{};
+        // 出現順の全 DHT (再定義されたものも含めて、1つにつき1回だけ持つ)
+        std::vector<Syntax::DHT> huffmanTables{};
+        // 最後のスキャンの時点で有効なテーブル
+        TableIndices dcTables{ NO_TABLE, NO_TABLE, NO_TABLE, NO_TABLE };
+        TableIndices acTables{ NO_TABLE, NO_TABLE, NO_TABLE, NO_TABLE };
+        // 出現順の全スキャン
+        std::vector<Scan> scans{};
+
+        // tables (dcTables, acTables か、 Scan のもの) のテーブル ID が id の DHT (無ければ nullptr)
+        inline const Syntax::DHT* findHuffmanTable(const TableIndices& tables, size_t id) const noexcept
+        {
+            if (id >= tables.size() || tables[id] == NO_TABLE) {
+                return nullptr;
+            }
+            return &huffmanTables[tables[id]];
+        }
+    };
+
+    class JpegParser final
+    {
+    public:
+        // ファイルをメモリにマップして解析する
+        JpegParser(std::string_view filename) noexcept;
+        // 呼び出し元が持っているデータをコピーせずに解析する
+        // data は JpegParser (と取得したセグメント、 ECS) を使い終わるまで有効であること
+        JpegParser(std::span<const uint8_t> data) noexcept;
+        ~JpegParser();
+
+        // 呼ぶたびに解析し直す
+        bool parse() noexcept;
+
+        // 最初の SOS までのヘッダだけを読んで、画像の情報を返す (セグメントや ECS は保持しない)
+        // SOF と APP1 (EXIF) 以外のセグメントは長さだけ読んで飛ばすので、読むのはファイルの先頭の数 KB で済む
+        bool probe(JpegInfo& info) noexcept;
+
+        inline const auto& getMarkers() const noexcept { return m_Markers; }
+        // 出現順の全セグメント (ダンプなど用、デコードには getIndex を使う)
+        // parse では作らずに、最初に呼ばれたときにもう一度解析して作る (getIndex の内容は変わらない)
+        const std::vector<std::shared_ptr<Syntax::Segment>>& getSegments() noexcept;
+        inline const SegmentIndex& getIndex() const noexcept { return m_Index; }
+        // ファイル (データ) 中の最初のスキャンの ECS をそのまま指す
+        inline std::span<const uint8_t> getECS() const noexcept { return m_ECS; }
+        // parse か probe の後で、最初の EXIF の APP1 ("Exif\0\0" から) をそのまま指す (無ければ空)
+        // ExifReader に渡すと、タグやサムネイルをコピーせずに取り出せる
+        inline std::span<const uint8_t> getExif() const noexcept { return m_Exif; }
+        // parse の後で、 APP0 以外のアプリケーションセグメント (APP1～APP15) と COM を、マーカーからそのまま指す (出現順)
+        // ロスレス変換で、 EXIF や ICC プロファイルなどを出力にコピーするのに使う
+        inline const std::vector<std::span<const uint8_t>>& getMetadataSegments() const noexcept { return m_MetadataSegments; }
+
+    private:
+        void parseSOI();
+        void parseAPP0();
+        void parseDQT();
+        // SOF0 以外の SOFn もフレームヘッダの構文は同じなので、 marker を変えて読む
+        void parseSOF0(Syntax::Marker marker = Syntax::Marker::SOF0);
+        void parseEOI();
+        void parseDHT();
+        void parseSOS();
+        // ECS の範囲を返す
+        std::span<const uint8_t> parseECS();
+        void parseDRI();
+        void parseAPP1();
+        void parseAPP2();
+        void parseAPP13();
+        void parseAPP14();
+        void parseCOM();
+        // length だけ読んで、セグメントの残りを飛ばす
+        void skipSegment();
+
+        // ファイルを開いて m_Data を設定し、 m_Reader を先頭に戻す
+        bool open() noexcept;
+
+        // getSegments 用に解析している場合だけ、 m_Segments に追加する
+        template <typename T>
+        void addSegment(const T& segment)
+        {
+            if (m_IsCollectingSegments) {
+                m_Segments.emplace_back(std::make_shared<T>(segment));
+            }
+        }
+
+    private:
+        // ファイル名を指定された場合だけ使う
+        std::optional<Common::MemoryMappedFile> m_File;
+        std::span<const uint8_t> m_Data{};
+        Common::BinaryMemoryReader m_Reader{};
+        std::vector<Syntax::Marker> m_Markers{};
+        std::vector<std::shared_ptr<Syntax::Segment>> m_Segments{};
+        // m_Segments を作るために解析しているか
+        bool m_IsCollectingSegments = false;
+        // m_Segments を作ったか (parse し直したら作り直す)
+        bool m_HasSegments = false;
+        SegmentIndex m_Index{};
+        std::span<const uint8_t> m_ECS{};
+        std::span<const uint8_t> m_Exif{};
+        std::vector<std::span<const uint8_t>> m_MetadataSegments{};
+    };
+} // namespace RagiMagick2::Image::Jpeg
@@ -0,0 +1,347 @@
+﻿#include "JpegTransformer.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Image/Jpeg/BitStreamWriter.h"
+#include "Image/Jpeg/Decoder/Common.h"
+#include "Image/Jpeg/Decoder/Utility.h"
+#include "Image/Jpeg/Encoder/HuffmanEncoder.h"
+#include "Image/Jpeg/Encoder/SegmentWriter.h"
+#include "Image/Jpeg/Exif/ExifReader.h"
+#include "Image/Jpeg/Syntax/Marker.h"
+#include "Image/Jpeg/Syntax/Segment.h"
+
+using namespace RagiMagick2::Image::Jpeg;
+using namespace RagiMagick2::Image::Jpeg::Syntax;
+using RagiMagick2::Image::Pixel::Orientation;
+
+namespace
+{
+    // 出力ブロックの各係数 (ジグザグ順) を、入力ブロックのどの係数 (ジグザグ順) から符号をどうして持ってくるか
+    // 8x8 の DCT では、左右反転は奇数列 (水平方向の奇数次) の係数の符号反転、上下反転は奇数行の符号反転、転置は係数の転置になる
+    struct CoefficientMapping
+    {
+        std::array<uint8_t, BLOCK_SIZE> sourceIndices{};
+        std::array<int8_t, BLOCK_SIZE> signs{};
+    };
+
+    CoefficientMapping createCoefficientMapping(const Orientation& flags)
+    {
+        CoefficientMapping mapping{};
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            const int u = i % BLOCK_WIDTH;
+            const int v = i / BLOCK_WIDTH;
+            const int source = flags.transpose ? u * BLOCK_WIDTH + v : i;
+            const bool negate = (flags.flipX && u % 2 == 1) != (flags.flipY && v % 2 == 1);
+            mapping.sourceIndices[ZIGZAG[i]] = static_cast<uint8_t>(ZIGZAG[source]);
+            mapping.signs[ZIGZAG[i]] = static_cast<int8_t>(negate ? -1 : 1);
+        }
+        return mapping;
+    }
+
+    inline void transformBlock(const MCUBlock8x8& src, MCUBlock8x8& dst, const CoefficientMapping& mapping) noexcept
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            dst[k] = static_cast<int16_t>(src[mapping.sourceIndices[k]] * mapping.signs[k]);
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Jpeg
+{
+    Pixel::Orientation getTransformOrientation(TransformType type) noexcept
+    {
+        switch (type) {
+        case TransformType::FlipHorizontal:
+            return { false, true, false };
+        case TransformType::FlipVertical:
+            return { false, false, true };
+        case TransformType::Transpose:
+            return { true, false, false };
+        case TransformType::Transverse:
+            return { true, true, true };
+        case TransformType::Rotate90:
+            // (x, y) → 転置 (y, x) → 左右反転 (H - 1 - y, x)
+            return { true, true, false };
+        case TransformType::Rotate180:
+            return { false, true, true };
+        case TransformType::Rotate270:
+            return { true, false, true };
+        default:
+            return {};
+        }
+    }
+
+    JpegTransformer::JpegTransformer(std::string_view fileName)
+        : m_Decoder(fileName)
+    {
+    }
+
+    JpegTransformer::JpegTransformer(std::span<const uint8_t> data)
+        : m_Decoder(data)
+    {
+    }
+
+    JpegTransformer::~JpegTransformer()
+    {
+    }
+
+    bool JpegTransformer::transform(std::vector<uint8_t>& output, const TransformOptions& options)
+    {
+        if (options.restartInterval < 0 || options.restartInterval > UINT16_MAX) {
+            return false;
+        }
+
+        CoefficientImage image{};
+        if (!m_Decoder.decodeCoefficients(image)) {
+            return false;
+        }
+
+        const auto& srcSOF = image.sof0;
+        const auto [srcHMaxFactor, srcVMaxFactor] = getMaxSamplingFactor(srcSOF);
+        const int srcMCUWidth = srcHMaxFactor * BLOCK_WIDTH;
+        const int srcMCUHeight = srcVMaxFactor * BLOCK_HEIGHT;
+
+        // EXIF の向きを反映する場合は、その変換と type の変換をまとめて1回で行う
+        const auto exifOrientation = options.applyExifOrientation ? Pixel::getOrientation(image.orientation) : Orientation{};
+        const auto flags = Pixel::combineOrientations(exifOrientation, getTransformOrientation(options.type));
+
+        // 切り抜く範囲 (左上は MCU の境界に揃える)
+        int cropX = 0;
+        int cropY = 0;
+        int cropWidth = srcSOF.width;
+        int cropHeight = srcSOF.height;
+        if (const auto& crop = options.crop; crop.width > 0 && crop.height > 0) {
+            // EXIF の向きを反映した画像の範囲に切り詰めてから、元の画像の座標に戻す (反転を戻してから転置を戻す)
+            const auto [orientedWidth, orientedHeight] = Pixel::getOrientedSize(srcSOF.width, srcSOF.height, exifOrientation);
+            const int orientedLeft = std::clamp(crop.x, 0, orientedWidth);
+            const int orientedTop = std::clamp(crop.y, 0, orientedHeight);
+            const int orientedRight = std::clamp(crop.x + crop.width, orientedLeft, orientedWidth);
+            const int orientedBottom = std::clamp(crop.y + crop.height, orientedTop, orientedHeight);
+            if (orientedLeft == orientedRight || orientedTop == orientedBottom) {
+                return false;
+            }
+            const int x = exifOrientation.flipX ? orientedWidth - orientedRight : orientedLeft;
+            const int y = exifOrientation.flipY ? orientedHeight - orientedBottom : orientedTop;
+            const int w = orientedRight - orientedLeft;
+            const int h = orientedBottom - orientedTop;
+            const int left = exifOrientation.transpose ? y : x;
+            const int top = exifOrientation.transpose ? x : y;
+            const int right = left + (exifOrientation.transpose ? h : w);
+            const int bottom = top + (exifOrientation.transpose ? w : h);
+            cropX = left / srcMCUWidth * srcMCUWidth;
+            cropY = top / srcMCUHeight * srcMCUHeight;
+            cropWidth = right - cropX;
+            cropHeight = bottom - cropY;
+        }
+
+        // 出力のフレーム (転置する場合はサイズとサンプリングファクタを入れ替える)
+        SOF0 sof = srcSOF;
+        sof.marker = Marker::SOF0;
+        int width = flags.transpose ? cropHeight : cropWidth;
+        int height = flags.transpose ? cropWidth : cropHeight;
+        if (flags.transpose) {
+            for (auto& component : sof.components) {
+                const uint8_t h = component.horizonalSamplingFactor;
+                component.horizonalSamplingFactor = component.verticalSamplingFactor;
+                component.verticalSamplingFactor = h;
+            }
+        }
+
+        const auto [hMaxFactor, vMaxFactor] = getMaxSamplingFactor(sof);
+        const int mcuWidth = hMaxFactor * BLOCK_WIDTH;
+        const int mcuHeight = vMaxFactor * BLOCK_HEIGHT;
+
+        // 反転する方向の半端な MCU を切り捨てる
+        if (flags.flipX) {
+            width = width / mcuWidth * mcuWidth;
+        }
+        if (flags.flipY) {
+            height = height / mcuHeight * mcuHeight;
+        }
+        if (width == 0 || height == 0) {
+            return false;
+        }
+        sof.width = static_cast<uint16_t>(width);
+        sof.height = static_cast<uint16_t>(height);
+
+        const int mcuHorizontalCount = (width + mcuWidth - 1) / mcuWidth;
+        const int mcuVerticalCount = (height + mcuHeight - 1) / mcuHeight;
+
+        // 出力の係数を並べる
+        const auto mapping = createCoefficientMapping(flags);
+        std::vector<CoefficientPlane> planes(sof.components.size());
+        for (size_t c = 0; c < sof.components.size(); ++c) {
+            const auto& component = sof.components[c];
+            const auto& srcPlane = image.planes[c];
+            auto& plane = planes[c];
+            const int h = component.horizonalSamplingFactor;
+            const int v = component.verticalSamplingFactor;
+            plane.blocksPerLine = mcuHorizontalCount * h;
+            plane.blockLines = mcuVerticalCount * v;
+            plane.blocks.resize(static_cast<size_t>(plane.blocksPerLine) * plane.blockLines);
+
+            // 切り抜いた範囲の左上のブロック (入力の座標)
+            const int srcOffsetX = cropX / srcMCUWidth * srcSOF.components[c].horizonalSamplingFactor;
+            const int srcOffsetY = cropY / srcMCUHeight * srcSOF.components[c].verticalSamplingFactor;
+
+            for (int y = 0; y < plane.blockLines; ++y) {
+                for (int x = 0; x < plane.blocksPerLine; ++x) {
+                    // 反転する方向は MCU の倍数に切り捨てているので、ブロック数は出力の MCU 数から分かる
+                    const int tx = flags.flipX ? plane.blocksPerLine - 1 - x : x;
+                    const int ty = flags.flipY ? plane.blockLines - 1 - y : y;
+                    // 右端・下端のパディングのブロックが入力の範囲を超える場合は、端のブロックを使う
+                    const int srcX = std::min((flags.transpose ? ty : tx) + srcOffsetX, srcPlane.blocksPerLine - 1);
+                    const int srcY = std::min((flags.transpose ? tx : ty) + srcOffsetY, srcPlane.blockLines - 1);
+
+                    const auto& src = srcPlane.blocks[static_cast<size_t>(srcY) * srcPlane.blocksPerLine + srcX];
+                    transformBlock(src, plane.blocks[static_cast<size_t>(y) * plane.blocksPerLine + x], mapping);
+                }
+            }
+        }
+
+        // 輝度 (最初の成分) はテーブル 0、色差はテーブル 1 で符号化する
+        const size_t tableCount = sof.components.size() == 1 ? 1 : 2;
+        auto getTableIndex = [](size_t componentIndex) { return componentIndex == 0 ? 0 : 1; };
+
+        // MCU 順に全てのブロックを渡す (リスタート間隔の区切りでは、その MCU のブロックより先に onRestart を呼ぶ)
+        // 1成分だけの場合も、サンプリングファクタが 1x1 なので1ブロックが1 MCU になる
+        const int restartInterval = options.restartInterval;
+        auto forEachBlock = [&](auto&& onRestart, auto&& onBlock) {
+            const int mcuCount = mcuHorizontalCount * mcuVerticalCount;
+            for (int mcu = 0; mcu < mcuCount; ++mcu) {
+                if (restartInterval > 0 && mcu != 0 && mcu % restartInterval == 0) {
+                    onRestart(mcu / restartInterval - 1);
+                }
+                const int mcuX = mcu % mcuHorizontalCount;
+                const int mcuY = mcu / mcuHorizontalCount;
+                for (size_t c = 0; c < sof.components.size(); ++c) {
+                    const auto& plane = planes[c];
+                    const int h = sof.components[c].horizonalSamplingFactor;
+                    const int v = sof.components[c].verticalSamplingFactor;
+                    for (int blockRow = 0; blockRow < v; ++blockRow) {
+                        for (int blockCol = 0; blockCol < h; ++blockCol) {
+                            const size_t i = static_cast<size_t>(mcuY * v + blockRow) * plane.blocksPerLine + mcuX * h + blockCol;
+                            onBlock(c, plane.blocks[i]);
+                        }
+                    }
+                }
+            }
+        };
+
+        // ハフマンテーブル
+        std::array<DHT, 2> dcTables{};
+        std::array<DHT, 2> acTables{};
+        if (options.optimizeHuffmanTables) {
+            std::array<SymbolFrequencies, 2> dcFrequencies{};
+            std::array<SymbolFrequencies, 2> acFrequencies{};
+            std::array<int, 4> dcPred{};
+            forEachBlock(
+                [&](int) { dcPred = {}; },
+                [&](size_t c, const MCUBlock8x8& block) {
+                    const auto table = getTableIndex(c);
+                    countBlockSymbols(block, dcPred[c], dcFrequencies[table], acFrequencies[table]);
+                }
+            );
+            for (size_t i = 0; i < tableCount; ++i) {
+                dcTables[i] = createOptimalDHT(dcFrequencies[i], DHT::TableClass::DC_OR_LOSSLESS, static_cast<HuffmanTableID>(i));
+                acTables[i] = createOptimalDHT(acFrequencies[i], DHT::TableClass::AC, static_cast<HuffmanTableID>(i));
+            }
+        }
+        else {
+            for (size_t i = 0; i < tableCount; ++i) {
+                dcTables[i] = createStandardDHT(DHT::TableClass::DC_OR_LOSSLESS, static_cast<HuffmanTableID>(i));
+                acTables[i] = createStandardDHT(DHT::TableClass::AC, static_cast<HuffmanTableID>(i));
+            }
+        }
+        std::array<HuffmanCodeTable, 2> dcCodes{};
+        std::array<HuffmanCodeTable, 2> acCodes{};
+        for (size_t i = 0; i < tableCount; ++i) {
+            dcCodes[i] = createHuffmanCodeTable(dcTables[i]);
+            acCodes[i] = createHuffmanCodeTable(acTables[i]);
+        }
+
+        // ヘッダ
+        BitStreamWriter writer(output);
+        writer.writeMarker(getMarkerCode(Marker::SOI));
+        writeAPP0(writer);
+        if (options.copyMetadata) {
+            for (const auto& segment : image.metadataSegments) {
+                // EXIF の向きを反映した場合は、表示するときにもう一度回転されないように Orientation を 1 にする
+                // (マーカーと length の 4 バイトの後ろが EXIF のデータ)
+                const ExifReader exif(segment.size() > 4 ? segment.subspan(4) : std::span<const uint8_t>{});
+                const auto orientationOffset = exif.isValid() && options.applyExifOrientation ? exif.getOrientationOffset() : std::nullopt;
+                if (!orientationOffset) {
+                    writer.writeBytes(segment);
+                    continue;
+                }
+                std::vector<uint8_t> copy(segment.begin(), segment.end());
+                const size_t offset = 4 + *orientationOffset;
+                copy[offset] = exif.isLittleEndian() ? 1 : 0;
+                copy[offset + 1] = exif.isLittleEndian() ? 0 : 1;
+                writer.writeBytes(copy);
+            }
+        }
+
+        // 量子化テーブルは元のものを使う (成分が参照しているものだけ)
+        // 転置する場合は係数と一緒にテーブルも転置する
+        std::array<bool, 4> isWritten{};
+        for (const auto& component : sof.components) {
+            const auto id = std::to_underlying(component.tableID);
+            if (isWritten[id]) {
+                continue;
+            }
+            std::array<uint16_t, BLOCK_SIZE> table{};
+            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                const int source = flags.transpose ? (i % BLOCK_WIDTH) * BLOCK_WIDTH + i / BLOCK_WIDTH : i;
+                table[i] = static_cast<uint16_t>(image.quantTables[id][source]);
+            }
+            writeDQT(writer, component.tableID, table);
+            isWritten[id] = true;
+        }
+
+        writeSOF(writer, sof);
+        if (restartInterval > 0) {
+            writeDRI(writer, static_cast<uint16_t>(restartInterval));
+        }
+        for (size_t i = 0; i < tableCount; ++i) {
+            writeDHT(writer, dcTables[i]);
+            writeDHT(writer, acTables[i]);
+        }
+
+        SOS sos{};
+        sos.marker = Marker::SOS;
+        sos.numComponents = static_cast<uint8_t>(sof.components.size());
+        for (size_t c = 0; c < sof.components.size(); ++c) {
+            SOS::Component component{};
+            component.componentSelector = sof.components[c].id;
+            component.dcSelector = static_cast<HuffmanTableID>(getTableIndex(c));
+            component.acSelector = static_cast<HuffmanTableID>(getTableIndex(c));
+            sos.components.push_back(component);
+        }
+        sos.spectralSelectionStart = 0;
+        sos.spectralSelectionEnd = 63;
+        sos.successiveApproximation = 0;
+        writeSOS(writer, sos);
+
+        // エントロピー符号化
+        std::array<int, 4> dcPred{};
+        forEachBlock(
+            [&](int restartIndex) {
+                writer.writeMarker(static_cast<uint8_t>(getMarkerCode(Marker::RST0) + restartIndex % 8));
+                dcPred = {};
+            },
+            [&](size_t c, const MCUBlock8x8& block) {
+                const auto table = getTableIndex(c);
+                encodeBlock(writer, block, dcPred[c], dcCodes[table], acCodes[table]);
+            }
+        );
+
+        writer.writeMarker(getMarkerCode(Marker::EOI));
+        return true;
+    }
+} // namespace RagiMagick2::Image::Jpeg
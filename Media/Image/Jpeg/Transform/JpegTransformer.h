@@ -0,0 +1,68 @@
+﻿#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "Image/Jpeg/Decoder/JpegDecoder.h"
+#include "Image/Pixel/PixelOrientation.h"
+
+namespace RagiMagick2::Image::Jpeg
+{
+    // ロスレス変換の種類 (EXIF の Orientation で必要になる変換が全て揃う)
+    enum class TransformType
+    {
+        None,
+        FlipHorizontal,     // 左右反転
+        FlipVertical,       // 上下反転
+        Transpose,          // 左上と右下を結ぶ対角線で反転
+        Transverse,         // 右上と左下を結ぶ対角線で反転
+        Rotate90,           // 時計回りに 90 度
+        Rotate180,
+        Rotate270,          // 時計回りに 270 度 (反時計回りに 90 度)
+    };
+
+    struct TransformOptions
+    {
+        TransformType type = TransformType::None;
+        // 切り抜く範囲 (変換前の画像の座標、幅か高さが 0 なら切り抜かない)
+        // 係数のまま切り抜くので、左上は MCU の境界まで広げる (右下はそのまま)
+        // applyExifOrientation が true なら、 EXIF の Orientation を反映した画像の座標 (MCU の境界に揃えるのは元の画像の座標で行う)
+        DecodeRegion crop{};
+        // true なら EXIF の Orientation の変換をしてから type の変換をする (1回の変換にまとめて行う)
+        // copyMetadata も true なら、コピーする EXIF の Orientation は 1 に書き換える
+        bool applyExifOrientation = false;
+        // true なら jpegtran の -copy all と同じく、 APP1～APP15 (EXIF, ICC プロファイルなど) と COM を入力の順にコピーする
+        // false なら APP0 (JFIF) だけを書くので、メタデータは全て失われる
+        // EXIF は Orientation 以外 (サイズやサムネイルなど) を変換に合わせて書き換えない
+        bool copyMetadata = true;
+        // true なら画像に合わせたハフマンテーブル (K.2) で符号化し直す
+        bool optimizeHuffmanTables = true;
+        // 0 以外なら、この MCU 数ごとにリスタートマーカーを入れる (1～65535)
+        int restartInterval = 0;
+    };
+
+    // 変換を EXIF の Orientation と同じく「転置してから左右・上下に反転する」の組み合わせで表したもの
+    Pixel::Orientation getTransformOrientation(TransformType type) noexcept;
+
+    // jpegtran と同じく、 DCT 係数のまま回転・反転・切り抜きをするロスレス変換
+    // エントロピー復号した係数を並べ替えて (反転する方向の奇数次の係数は符号を反転し、転置する場合は係数も転置する)
+    // ベースライン JPEG として符号化し直すので、 IDCT も色変換もせず、画質も劣化しない。
+    // 反転する方向の端に MCU に満たない半端な列 (行) がある場合は、 jpegtran の -trim と同じく切り捨てる
+    // (反転すると反対側の端に来て、本来は見えないパディングが見えてしまうため)
+    class JpegTransformer final
+    {
+    public:
+        JpegTransformer(std::string_view fileName);
+        // メモリ上の JPEG をコピーせずに変換する (data は変換が終わるまで有効であること)
+        JpegTransformer(std::span<const uint8_t> data);
+        ~JpegTransformer();
+
+        // 変換した JPEG を output の末尾に追記する
+        // 対応していない画像 (JpegDecoder でデコードできないもの) や、切り抜く範囲が画像と重ならない場合は false を返す
+        bool transform(std::vector<uint8_t>& output, const TransformOptions& options = {});
+
+    private:
+        JpegDecoder m_Decoder;
+    };
+
+} // namespace RagiMagick2::Image::Jpeg
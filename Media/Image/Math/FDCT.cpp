@@ -0,0 +1,17 @@
+﻿#include "FDCT.h"
+#include "Common/CPU.h"
+
+// このファイルはプロジェクトの既定の命令セットでビルドする (AVX2 版は FDCTAVX2.cpp)
+namespace RagiMagick2::Image::Math::FDCT
+{
+    const Kernels& getKernels() noexcept
+    {
+        static const Kernels kernels = [] () -> Kernels {
+            if (Common::getSIMDLevel() >= Common::SIMDLevel::AVX2) {
+                return { fdctQuantizeAVX2 };
+            }
+            return { fdctQuantizeScalar };
+        }();
+        return kernels;
+    }
+} // namespace RagiMagick2::Image::Math::FDCT
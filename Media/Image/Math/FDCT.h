@@ -0,0 +1,149 @@
+﻿#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include "IDCT.h"
+
+namespace RagiMagick2::Image::Math
+{
+    // 整数演算による 8x8 の順方向 DCT (libjpeg の jfdctint.c (islow) と同じ定数・丸め)
+    // レベルシフト (-128)、 DCT、量子化までをまとめて行う。
+    // 定数は IDCT と共通 (IDCT.h)
+    namespace FDCT
+    {
+        using Block = IDCT::Block;
+
+        // 量子化の除数を逆数の乗算で表したもの (自然順)
+        // DCT の結果は 8 倍されているので、除数は量子化テーブルの値 * 8
+        // 商は (|x| + divisor / 2) / divisor を切り捨てたもので、 libjpeg の量子化と同じになる
+        struct Divisors
+        {
+            // divisor / 2
+            std::array<int32_t, 8 * 8> rounding{};
+            // ceil(2^shift / divisor)
+            std::array<int32_t, 8 * 8> multiplier{};
+            // 15 + ceil(log2(divisor))
+            std::array<int32_t, 8 * 8> shift{};
+        };
+
+        // (|x| + rounding) < 2^15 の範囲で割り算と同じ結果になる (DCT の結果は |x| < 2^14 に収まる)
+        // multiplier < 2^16 + 1 なので、積は int32_t に収まる
+        inline constexpr Divisors createDivisors(const std::array<uint16_t, 8 * 8>& quant)
+        {
+            Divisors divisors{};
+            for (size_t i = 0; i < quant.size(); ++i) {
+                const int32_t divisor = quant[i] * 8;
+                const int32_t shift = 15 + std::bit_width(static_cast<uint32_t>(divisor - 1));
+                divisors.rounding[i] = divisor / 2;
+                divisors.multiplier[i] = static_cast<int32_t>(((int64_t{ 1 } << shift) + divisor - 1) / divisor);
+                divisors.shift[i] = shift;
+            }
+            return divisors;
+        }
+
+        inline int32_t quantize(int32_t value, const Divisors& divisors, size_t i)
+        {
+            const int32_t q = ((std::abs(value) + divisors.rounding[i]) * divisors.multiplier[i]) >> divisors.shift[i];
+            return value < 0 ? -q : q;
+        }
+
+        // 1次元 DCT
+        // in[i * stride] を入力として out[i * stride] に書き込む
+        // 1パス目 (isFirstPass) は結果を PASS1_BITS だけ大きくし、2パス目は PASS1_BITS 分を戻す
+        inline void fdct1D(const int32_t* in, int32_t* out, int stride, bool isFirstPass)
+        {
+            using namespace IDCT;
+
+            const int32_t tmp0 = in[0 * stride] + in[7 * stride];
+            int32_t tmp7 = in[0 * stride] - in[7 * stride];
+            const int32_t tmp1 = in[1 * stride] + in[6 * stride];
+            int32_t tmp6 = in[1 * stride] - in[6 * stride];
+            const int32_t tmp2 = in[2 * stride] + in[5 * stride];
+            int32_t tmp5 = in[2 * stride] - in[5 * stride];
+            const int32_t tmp3 = in[3 * stride] + in[4 * stride];
+            int32_t tmp4 = in[3 * stride] - in[4 * stride];
+
+            // 偶数部
+            const int32_t tmp10 = tmp0 + tmp3;
+            const int32_t tmp13 = tmp0 - tmp3;
+            const int32_t tmp11 = tmp1 + tmp2;
+            const int32_t tmp12 = tmp1 - tmp2;
+
+            const int shift = isFirstPass ? CONST_BITS - PASS1_BITS : CONST_BITS + PASS1_BITS;
+            auto descale = [](int32_t x, int n) { return (x + (1 << (n - 1))) >> n; };
+
+            if (isFirstPass) {
+                out[0 * stride] = (tmp10 + tmp11) * (1 << PASS1_BITS);
+                out[4 * stride] = (tmp10 - tmp11) * (1 << PASS1_BITS);
+            }
+            else {
+                out[0 * stride] = descale(tmp10 + tmp11, PASS1_BITS);
+                out[4 * stride] = descale(tmp10 - tmp11, PASS1_BITS);
+            }
+
+            int32_t z1 = (tmp12 + tmp13) * FIX_0_541196100;
+            out[2 * stride] = descale(z1 + tmp13 * FIX_0_765366865, shift);
+            out[6 * stride] = descale(z1 - tmp12 * FIX_1_847759065, shift);
+
+            // 奇数部
+            z1 = tmp4 + tmp7;
+            int32_t z2 = tmp5 + tmp6;
+            int32_t z3 = tmp4 + tmp6;
+            int32_t z4 = tmp5 + tmp7;
+            const int32_t z5 = (z3 + z4) * FIX_1_175875602;
+
+            tmp4 *= FIX_0_298631336;
+            tmp5 *= FIX_2_053119869;
+            tmp6 *= FIX_3_072711026;
+            tmp7 *= FIX_1_501321110;
+            z1 *= -FIX_0_899976223;
+            z2 *= -FIX_2_562915447;
+            z3 = z3 * -FIX_1_961570560 + z5;
+            z4 = z4 * -FIX_0_390180644 + z5;
+
+            out[7 * stride] = descale(tmp4 + z1 + z3, shift);
+            out[5 * stride] = descale(tmp5 + z2 + z4, shift);
+            out[3 * stride] = descale(tmp6 + z2 + z3, shift);
+            out[1 * stride] = descale(tmp7 + z1 + z4, shift);
+        }
+
+        // スカラー版 (AVX2 が無い CPU 用、 AVX2 版の検証用)
+        // samples は 0～255 のサンプル値 (自然順)、 out は量子化した係数 (自然順)
+        inline void fdctQuantizeScalar(const Block& samples, const Divisors& divisors, Block& out)
+        {
+            std::array<int32_t, 8 * 8> workspace{};
+            for (size_t i = 0; i < workspace.size(); ++i) {
+                workspace[i] = samples[i] - 128;
+            }
+
+            // 行方向 → 列方向
+            for (int y = 0; y < 8; ++y) {
+                fdct1D(&workspace[y * 8], &workspace[y * 8], 1, true);
+            }
+            for (int x = 0; x < 8; ++x) {
+                fdct1D(&workspace[x], &workspace[x], 8, false);
+            }
+
+            for (size_t i = 0; i < workspace.size(); ++i) {
+                out[i] = static_cast<int16_t>(quantize(workspace[i], divisors, i));
+            }
+        }
+
+        // AVX2 版
+        // samples と out は 32 バイト境界に揃えること (samples と out は同じでもよい)
+        void fdctQuantizeAVX2(const Block& samples, const Divisors& divisors, Block& out);
+
+        using FDCTFunction = void (*)(const Block& samples, const Divisors& divisors, Block& out);
+
+        // CPU に合わせて選んだ DCT
+        struct Kernels
+        {
+            FDCTFunction fdctQuantize;
+        };
+
+        // 最初に呼ばれたときに Common::getSIMDLevel() で1度だけ選ぶ
+        const Kernels& getKernels() noexcept;
+
+    } // namespace FDCT
+} // namespace RagiMagick2::Image::Math
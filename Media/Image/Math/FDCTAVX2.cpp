@@ -0,0 +1,165 @@
+﻿#include "FDCT.h"
+#include <immintrin.h>
+#include <array>
+#include <cstdint>
+
+// MSVC はこのファイルだけ /arch:AVX2 でビルドする (Media.vcxproj)
+// GCC / Clang は #include の後ろの定義だけを AVX2 向けにする
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace
+{
+    using namespace RagiMagick2::Image::Math;
+    using namespace RagiMagick2::Image::Math::IDCT;
+
+    inline __m256i mul(__m256i a, int32_t b)
+    {
+        return _mm256_mullo_epi32(a, _mm256_set1_epi32(b));
+    }
+
+    template <int Shift>
+    inline __m256i descale(__m256i x)
+    {
+        return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1 << (Shift - 1))), Shift);
+    }
+
+    // 8本のベクトルの同じレーン同士で 1次元 DCT を行う (FDCT::fdct1D と同じ計算)
+    template <bool IsFirstPass>
+    inline void fdct1DVector(std::array<__m256i, 8>& v)
+    {
+        constexpr int shift = IsFirstPass ? CONST_BITS - PASS1_BITS : CONST_BITS + PASS1_BITS;
+
+        const __m256i tmp0 = _mm256_add_epi32(v[0], v[7]);
+        __m256i tmp7 = _mm256_sub_epi32(v[0], v[7]);
+        const __m256i tmp1 = _mm256_add_epi32(v[1], v[6]);
+        __m256i tmp6 = _mm256_sub_epi32(v[1], v[6]);
+        const __m256i tmp2 = _mm256_add_epi32(v[2], v[5]);
+        __m256i tmp5 = _mm256_sub_epi32(v[2], v[5]);
+        const __m256i tmp3 = _mm256_add_epi32(v[3], v[4]);
+        __m256i tmp4 = _mm256_sub_epi32(v[3], v[4]);
+
+        // 偶数部
+        const __m256i tmp10 = _mm256_add_epi32(tmp0, tmp3);
+        const __m256i tmp13 = _mm256_sub_epi32(tmp0, tmp3);
+        const __m256i tmp11 = _mm256_add_epi32(tmp1, tmp2);
+        const __m256i tmp12 = _mm256_sub_epi32(tmp1, tmp2);
+
+        if constexpr (IsFirstPass) {
+            v[0] = _mm256_slli_epi32(_mm256_add_epi32(tmp10, tmp11), PASS1_BITS);
+            v[4] = _mm256_slli_epi32(_mm256_sub_epi32(tmp10, tmp11), PASS1_BITS);
+        }
+        else {
+            v[0] = descale<PASS1_BITS>(_mm256_add_epi32(tmp10, tmp11));
+            v[4] = descale<PASS1_BITS>(_mm256_sub_epi32(tmp10, tmp11));
+        }
+
+        __m256i z1 = mul(_mm256_add_epi32(tmp12, tmp13), FIX_0_541196100);
+        v[2] = descale<shift>(_mm256_add_epi32(z1, mul(tmp13, FIX_0_765366865)));
+        v[6] = descale<shift>(_mm256_sub_epi32(z1, mul(tmp12, FIX_1_847759065)));
+
+        // 奇数部
+        z1 = _mm256_add_epi32(tmp4, tmp7);
+        __m256i z2 = _mm256_add_epi32(tmp5, tmp6);
+        __m256i z3 = _mm256_add_epi32(tmp4, tmp6);
+        __m256i z4 = _mm256_add_epi32(tmp5, tmp7);
+        const __m256i z5 = mul(_mm256_add_epi32(z3, z4), FIX_1_175875602);
+
+        tmp4 = mul(tmp4, FIX_0_298631336);
+        tmp5 = mul(tmp5, FIX_2_053119869);
+        tmp6 = mul(tmp6, FIX_3_072711026);
+        tmp7 = mul(tmp7, FIX_1_501321110);
+        z1 = mul(z1, -FIX_0_899976223);
+        z2 = mul(z2, -FIX_2_562915447);
+        z3 = _mm256_add_epi32(mul(z3, -FIX_1_961570560), z5);
+        z4 = _mm256_add_epi32(mul(z4, -FIX_0_390180644), z5);
+
+        v[7] = descale<shift>(_mm256_add_epi32(tmp4, _mm256_add_epi32(z1, z3)));
+        v[5] = descale<shift>(_mm256_add_epi32(tmp5, _mm256_add_epi32(z2, z4)));
+        v[3] = descale<shift>(_mm256_add_epi32(tmp6, _mm256_add_epi32(z2, z3)));
+        v[1] = descale<shift>(_mm256_add_epi32(tmp7, _mm256_add_epi32(z1, z4)));
+    }
+
+    // 8x8 (int32_t) の転置 (IDCTAVX2.cpp と同じ)
+    inline void transpose(std::array<__m256i, 8>& v)
+    {
+        __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+        __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+        __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+        __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+        __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+        __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+        __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+        __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+        v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+
+    // 逆数の乗算で量子化する (FDCT::quantize と同じ計算)
+    inline __m256i quantizeVector(__m256i value, const FDCT::Divisors& divisors, int row)
+    {
+        const __m256i rounding = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&divisors.rounding[row * 8]));
+        const __m256i multiplier = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&divisors.multiplier[row * 8]));
+        const __m256i shift = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&divisors.shift[row * 8]));
+        const __m256i q = _mm256_srlv_epi32(_mm256_mullo_epi32(_mm256_add_epi32(_mm256_abs_epi32(value), rounding), multiplier), shift);
+        // value が 0 の場合も q は 0 になる
+        return _mm256_sign_epi32(q, value);
+    }
+}
+
+namespace RagiMagick2::Image::Math::FDCT
+{
+    void fdctQuantizeAVX2(const Block& samples, const Divisors& divisors, Block& out)
+    {
+        // 1行ずつ int32_t に拡張しながらレベルシフトする
+        const __m256i offset = _mm256_set1_epi32(128);
+        std::array<__m256i, 8> v{};
+        for (int y = 0; y < 8; ++y) {
+            const __m128i s = _mm_load_si128(reinterpret_cast<const __m128i*>(&samples[y * 8]));
+            v[y] = _mm256_sub_epi32(_mm256_cvtepi16_epi32(s), offset);
+        }
+
+        // 行方向の DCT (転置して、ベクトル間で計算すると行方向になる)
+        transpose(v);
+        fdct1DVector<true>(v);
+
+        // 列方向の DCT
+        transpose(v);
+        fdct1DVector<false>(v);
+
+        // 量子化して int16_t に詰める (量子化後は int16_t に収まる)
+        for (int y = 0; y < 8; y += 2) {
+            const __m256i a = quantizeVector(v[y], divisors, y);
+            const __m256i b = quantizeVector(v[y + 1], divisors, y + 1);
+            // packs は 128 ビットレーンごとに詰めるので、並びを戻す
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&out[y * 8]), packed);
+        }
+    }
+} // namespace RagiMagick2::Image::Math::FDCT
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,21 @@
+﻿#include "IDCT.h"
+#include "Common/CPU.h"
+
+// このファイルはプロジェクトの既定の命令セットでビルドする (AVX2 版は IDCTAVX2.cpp、 AVX-512 版は IDCTAVX512.cpp)
+namespace RagiMagick2::Image::Math::IDCT
+{
+    const Kernels& getKernels() noexcept
+    {
+        static const Kernels kernels = [] () -> Kernels {
+            switch (Common::getSIMDLevel()) {
+            case Common::SIMDLevel::AVX512:
+                return { idctAVX2, idct4x4AVX2, idctPairAVX512 };
+            case Common::SIMDLevel::AVX2:
+                return { idctAVX2, idct4x4AVX2, nullptr };
+            default:
+                return { idctScalar, idctScalar, nullptr };
+            }
+        }();
+        return kernels;
+    }
+} // namespace RagiMagick2::Image::Math::IDCT
@@ -0,0 +1,257 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace RagiMagick2::Image::Math
+{
+    // 整数演算による 8x8 の IDCT (Loeffler, Ligtenberg, Moschytz のアルゴリズム)
+    // libjpeg の jidctint.c (islow) と同じ定数・丸めを使うので、結果も同じになる。
+    // 逆量子化、IDCT、レベルシフト (+128)、0～255 への飽和までをまとめて行う。
+    namespace IDCT
+    {
+        using Block = std::array<int16_t, 8 * 8>;
+        // 逆量子化テーブル (自然順、 int32_t に拡張済み)
+        using QuantTable = std::array<int32_t, 8 * 8>;
+
+        inline constexpr int CONST_BITS = 13;
+        inline constexpr int PASS1_BITS = 2;
+
+        // FIX(x) = x * 2^CONST_BITS を丸めたもの
+        inline constexpr int32_t FIX_0_298631336 = 2446;
+        inline constexpr int32_t FIX_0_390180644 = 3196;
+        inline constexpr int32_t FIX_0_541196100 = 4433;
+        inline constexpr int32_t FIX_0_765366865 = 6270;
+        inline constexpr int32_t FIX_0_899976223 = 7373;
+        inline constexpr int32_t FIX_1_175875602 = 9633;
+        inline constexpr int32_t FIX_1_501321110 = 12299;
+        inline constexpr int32_t FIX_1_847759065 = 15137;
+        inline constexpr int32_t FIX_1_961570560 = 16069;
+        inline constexpr int32_t FIX_2_053119869 = 16819;
+        inline constexpr int32_t FIX_2_562915447 = 20995;
+        inline constexpr int32_t FIX_3_072711026 = 25172;
+        // 縮小 IDCT 用
+        inline constexpr int32_t FIX_0_211164243 = 1730;
+        inline constexpr int32_t FIX_0_509795579 = 4176;
+        inline constexpr int32_t FIX_0_601344887 = 4926;
+        inline constexpr int32_t FIX_0_720959822 = 5906;
+        inline constexpr int32_t FIX_0_850430095 = 6967;
+        inline constexpr int32_t FIX_1_061594337 = 8697;
+        inline constexpr int32_t FIX_1_272758580 = 10426;
+        inline constexpr int32_t FIX_1_451774981 = 11893;
+        inline constexpr int32_t FIX_2_172734803 = 17799;
+        inline constexpr int32_t FIX_3_624509785 = 29692;
+
+        // 1次元 IDCT
+        // in[i * stride] を入力として、 (結果 + 2^(shift - 1)) >> shift を out[i * stride] に書き込む
+        inline void idct1D(const int32_t* in, int32_t* out, int stride, int shift)
+        {
+            // 偶数部
+            int32_t z2 = in[2 * stride];
+            int32_t z3 = in[6 * stride];
+            int32_t z1 = (z2 + z3) * FIX_0_541196100;
+            int32_t tmp2 = z1 - z3 * FIX_1_847759065;
+            int32_t tmp3 = z1 + z2 * FIX_0_765366865;
+
+            z2 = in[0 * stride];
+            z3 = in[4 * stride];
+            int32_t tmp0 = (z2 + z3) * (1 << CONST_BITS);
+            int32_t tmp1 = (z2 - z3) * (1 << CONST_BITS);
+
+            const int32_t tmp10 = tmp0 + tmp3;
+            const int32_t tmp13 = tmp0 - tmp3;
+            const int32_t tmp11 = tmp1 + tmp2;
+            const int32_t tmp12 = tmp1 - tmp2;
+
+            // 奇数部
+            tmp0 = in[7 * stride];
+            tmp1 = in[5 * stride];
+            tmp2 = in[3 * stride];
+            tmp3 = in[1 * stride];
+
+            z1 = tmp0 + tmp3;
+            z2 = tmp1 + tmp2;
+            z3 = tmp0 + tmp2;
+            int32_t z4 = tmp1 + tmp3;
+            const int32_t z5 = (z3 + z4) * FIX_1_175875602;
+
+            tmp0 *= FIX_0_298631336;
+            tmp1 *= FIX_2_053119869;
+            tmp2 *= FIX_3_072711026;
+            tmp3 *= FIX_1_501321110;
+            z1 *= -FIX_0_899976223;
+            z2 *= -FIX_2_562915447;
+            z3 = z3 * -FIX_1_961570560 + z5;
+            z4 = z4 * -FIX_0_390180644 + z5;
+
+            tmp0 += z1 + z3;
+            tmp1 += z2 + z4;
+            tmp2 += z2 + z3;
+            tmp3 += z1 + z4;
+
+            const int32_t round = 1 << (shift - 1);
+            out[0 * stride] = (tmp10 + tmp3 + round) >> shift;
+            out[7 * stride] = (tmp10 - tmp3 + round) >> shift;
+            out[1 * stride] = (tmp11 + tmp2 + round) >> shift;
+            out[6 * stride] = (tmp11 - tmp2 + round) >> shift;
+            out[2 * stride] = (tmp12 + tmp1 + round) >> shift;
+            out[5 * stride] = (tmp12 - tmp1 + round) >> shift;
+            out[3 * stride] = (tmp13 + tmp0 + round) >> shift;
+            out[4 * stride] = (tmp13 - tmp0 + round) >> shift;
+        }
+
+        // スカラー版 (AVX2 が無い CPU 用、 AVX2 版の検証用)
+        // 非ゼロの係数が左上 4x4 に収まっている場合も、そのまま同じ結果になる
+        inline void idctScalar(const Block& coefs, const QuantTable& quant, Block& out)
+        {
+            std::array<int32_t, 8 * 8> dequantized{};
+            for (size_t i = 0; i < dequantized.size(); ++i) {
+                dequantized[i] = coefs[i] * quant[i];
+            }
+
+            // 列方向 → 行方向
+            std::array<int32_t, 8 * 8> workspace{};
+            for (int x = 0; x < 8; ++x) {
+                idct1D(&dequantized[x], &workspace[x], 8, CONST_BITS - PASS1_BITS);
+            }
+
+            std::array<int32_t, 8> row{};
+            for (int y = 0; y < 8; ++y) {
+                idct1D(&workspace[y * 8], row.data(), 1, CONST_BITS + PASS1_BITS + 3);
+                for (int x = 0; x < 8; ++x) {
+                    out[y * 8 + x] = static_cast<int16_t>(std::clamp(row[x] + 128, 0, 255));
+                }
+            }
+        }
+
+        // AC 係数が全て 0 の場合
+        // 全ての出力が同じ値になるので、 idctScalar と同じ丸めで1つだけ計算して埋める
+        inline void idctDCOnly(int16_t dc, int32_t quant, Block& out)
+        {
+            // 1パス目で << PASS1_BITS、2パス目で CONST_BITS + PASS1_BITS + 3 の丸めと同じ
+            const int32_t value = (dc * quant * (1 << PASS1_BITS) + (1 << (PASS1_BITS + 3 - 1))) >> (PASS1_BITS + 3);
+            out.fill(static_cast<int16_t>(std::clamp(value + 128, 0, 255)));
+        }
+
+        // 8x8 の係数から 4x4 のサンプルを求める縮小 IDCT (1/2 縮小デコード用、 libjpeg の jidctred.c と同じ)
+        // 結果は out の左上 4x4 (1行 8 要素の間隔) に書き込む
+        inline void idctReduced4x4(const Block& coefs, const QuantTable& quant, Block& out)
+        {
+            // 1次元 IDCT (入力の 4 番目は使わない)
+            auto idct1D = [](auto in, int stride, int shift, auto store) {
+                int32_t tmp0 = in(0 * stride) * (1 << (CONST_BITS + 1));
+                int32_t tmp2 = in(2 * stride) * FIX_1_847759065 - in(6 * stride) * FIX_0_765366865;
+                const int32_t tmp10 = tmp0 + tmp2;
+                const int32_t tmp12 = tmp0 - tmp2;
+
+                const int32_t z1 = in(7 * stride);
+                const int32_t z2 = in(5 * stride);
+                const int32_t z3 = in(3 * stride);
+                const int32_t z4 = in(1 * stride);
+                tmp0 = -z1 * FIX_0_211164243 + z2 * FIX_1_451774981 - z3 * FIX_2_172734803 + z4 * FIX_1_061594337;
+                tmp2 = -z1 * FIX_0_509795579 - z2 * FIX_0_601344887 + z3 * FIX_0_899976223 + z4 * FIX_2_562915447;
+
+                const int32_t round = 1 << (shift - 1);
+                store(0, (tmp10 + tmp2 + round) >> shift);
+                store(3, (tmp10 - tmp2 + round) >> shift);
+                store(1, (tmp12 + tmp0 + round) >> shift);
+                store(2, (tmp12 - tmp0 + round) >> shift);
+            };
+
+            // 列方向 (8 → 4)
+            std::array<int32_t, 4 * 8> workspace{};
+            for (int x = 0; x < 8; ++x) {
+                if (x == 4) {
+                    continue;
+                }
+                idct1D(
+                    [&](int i) { return coefs[i + x] * quant[i + x]; }, 8, CONST_BITS - PASS1_BITS + 1,
+                    [&](int y, int32_t value) { workspace[y * 8 + x] = value; }
+                );
+            }
+
+            // 行方向 (8 → 4)
+            for (int y = 0; y < 4; ++y) {
+                idct1D(
+                    [&](int i) { return workspace[y * 8 + i]; }, 1, CONST_BITS + PASS1_BITS + 3 + 1,
+                    [&](int x, int32_t value) { out[y * 8 + x] = static_cast<int16_t>(std::clamp(value + 128, 0, 255)); }
+                );
+            }
+        }
+
+        // 8x8 の係数から 2x2 のサンプルを求める縮小 IDCT (1/4 縮小デコード用、 libjpeg の jidctred.c と同じ)
+        // 結果は out の左上 2x2 (1行 8 要素の間隔) に書き込む
+        inline void idctReduced2x2(const Block& coefs, const QuantTable& quant, Block& out)
+        {
+            // 1次元 IDCT (入力の 0, 1, 3, 5, 7 番目だけ使う)
+            auto idct1D = [](auto in, int stride, int shift, auto store) {
+                const int32_t tmp10 = in(0 * stride) * (1 << (CONST_BITS + 2));
+                const int32_t tmp0 =
+                    -in(7 * stride) * FIX_0_720959822 + in(5 * stride) * FIX_0_850430095
+                    - in(3 * stride) * FIX_1_272758580 + in(1 * stride) * FIX_3_624509785;
+
+                const int32_t round = 1 << (shift - 1);
+                store(0, (tmp10 + tmp0 + round) >> shift);
+                store(1, (tmp10 - tmp0 + round) >> shift);
+            };
+
+            // 列方向 (8 → 2)
+            std::array<int32_t, 2 * 8> workspace{};
+            for (int x = 0; x < 8; ++x) {
+                if (x == 2 || x == 4 || x == 6) {
+                    continue;
+                }
+                idct1D(
+                    [&](int i) { return coefs[i + x] * quant[i + x]; }, 8, CONST_BITS - PASS1_BITS + 2,
+                    [&](int y, int32_t value) { workspace[y * 8 + x] = value; }
+                );
+            }
+
+            // 行方向 (8 → 2)
+            for (int y = 0; y < 2; ++y) {
+                idct1D(
+                    [&](int i) { return workspace[y * 8 + i]; }, 1, CONST_BITS + PASS1_BITS + 3 + 2,
+                    [&](int x, int32_t value) { out[y * 8 + x] = static_cast<int16_t>(std::clamp(value + 128, 0, 255)); }
+                );
+            }
+        }
+
+        // AVX2 版
+        // coefs と out は 32 バイト境界に揃えること (coefs と out は同じでもよい)
+        void idctAVX2(const Block& coefs, const QuantTable& quant, Block& out);
+
+        // 非ゼロの係数が左上 4x4 に収まっている場合の AVX2 版
+        // 後ろ半分の入力が 0 の前提で計算を省くだけなので、結果は idctAVX2 と同じになる
+        void idct4x4AVX2(const Block& coefs, const QuantTable& quant, Block& out);
+
+        // 係数の並び順 (自然順で i 番目の係数が、入力の order[i] 番目にある)
+        using CoefficientOrder = std::array<int16_t, 8 * 8>;
+
+        // AVX-512 版 (2 ブロックをまとめて処理する)
+        // 入力の係数を order で自然順に並べ替えてから (vpermt2w)、 idctAVX2 と同じ計算をする
+        // out0, out1 は 32 バイト境界に揃えること (coefs と out は同じでもよい)
+        void idctPairAVX512(
+            const Block& coefs0, const QuantTable& quant0, Block& out0,
+            const Block& coefs1, const QuantTable& quant1, Block& out1,
+            const CoefficientOrder& order
+        );
+
+        using IDCTFunction = void (*)(const Block& coefs, const QuantTable& quant, Block& out);
+        using IDCTPairFunction = decltype(&idctPairAVX512);
+
+        // CPU に合わせて選んだ IDCT
+        struct Kernels
+        {
+            // 8x8 の IDCT
+            IDCTFunction idct;
+            // 非ゼロの係数が左上 4x4 に収まっている場合の IDCT
+            IDCTFunction idct4x4;
+            // 2 ブロックをまとめて並べ替えから行う IDCT (AVX-512 が無い場合は nullptr)
+            IDCTPairFunction idctPair;
+        };
+
+        // 最初に呼ばれたときに Common::getSIMDLevel() で1度だけ選ぶ
+        const Kernels& getKernels() noexcept;
+
+    } // namespace IDCT
+} // namespace RagiMagick2::Image::Math
@@ -0,0 +1,210 @@
+﻿#include "IDCT.h"
+#include <immintrin.h>
+#include <array>
+#include <cstdint>
+
+// MSVC はこのファイルだけ /arch:AVX2 でビルドする (Media.vcxproj)
+// GCC / Clang は #include の後ろの定義だけを AVX2 向けにする (ヘッダーのインライン関数を AVX2 向けにしないため)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace
+{
+    using namespace RagiMagick2::Image::Math::IDCT;
+
+    inline __m256i mul(__m256i a, int32_t b)
+    {
+        return _mm256_mullo_epi32(a, _mm256_set1_epi32(b));
+    }
+
+    // 8本のベクトルの同じレーン同士で 1次元 IDCT を行う (8列 or 8行分を同時に処理する)
+    // LowFrequency が true の場合は v[4]～v[7] が 0 として、その分の計算を省く
+    template <bool LowFrequency = false>
+    inline void idct1DVector(std::array<__m256i, 8>& v, int shift)
+    {
+        __m256i tmp0, tmp1, tmp2, tmp3;
+
+        // 偶数部
+        if constexpr (LowFrequency) {
+            __m256i z1 = mul(v[2], FIX_0_541196100);
+            tmp2 = z1;
+            tmp3 = _mm256_add_epi32(z1, mul(v[2], FIX_0_765366865));
+            tmp0 = _mm256_slli_epi32(v[0], CONST_BITS);
+            tmp1 = tmp0;
+        }
+        else {
+            __m256i z2 = v[2];
+            __m256i z3 = v[6];
+            __m256i z1 = mul(_mm256_add_epi32(z2, z3), FIX_0_541196100);
+            tmp2 = _mm256_sub_epi32(z1, mul(z3, FIX_1_847759065));
+            tmp3 = _mm256_add_epi32(z1, mul(z2, FIX_0_765366865));
+
+            z2 = v[0];
+            z3 = v[4];
+            tmp0 = _mm256_slli_epi32(_mm256_add_epi32(z2, z3), CONST_BITS);
+            tmp1 = _mm256_slli_epi32(_mm256_sub_epi32(z2, z3), CONST_BITS);
+        }
+
+        const __m256i tmp10 = _mm256_add_epi32(tmp0, tmp3);
+        const __m256i tmp13 = _mm256_sub_epi32(tmp0, tmp3);
+        const __m256i tmp11 = _mm256_add_epi32(tmp1, tmp2);
+        const __m256i tmp12 = _mm256_sub_epi32(tmp1, tmp2);
+
+        // 奇数部
+        if constexpr (LowFrequency) {
+            // v[5], v[7] が 0 なので z1 = v[1], z2 = z3 = v[3], z4 = v[1] になる
+            const __m256i z5 = mul(_mm256_add_epi32(v[3], v[1]), FIX_1_175875602);
+            const __m256i z1 = mul(v[1], -FIX_0_899976223);
+            const __m256i z2 = mul(v[3], -FIX_2_562915447);
+            const __m256i z3 = _mm256_add_epi32(mul(v[3], -FIX_1_961570560), z5);
+            const __m256i z4 = _mm256_add_epi32(mul(v[1], -FIX_0_390180644), z5);
+
+            tmp0 = _mm256_add_epi32(z1, z3);
+            tmp1 = _mm256_add_epi32(z2, z4);
+            tmp2 = _mm256_add_epi32(mul(v[3], FIX_3_072711026), _mm256_add_epi32(z2, z3));
+            tmp3 = _mm256_add_epi32(mul(v[1], FIX_1_501321110), _mm256_add_epi32(z1, z4));
+        }
+        else {
+            tmp0 = v[7];
+            tmp1 = v[5];
+            tmp2 = v[3];
+            tmp3 = v[1];
+
+            __m256i z1 = _mm256_add_epi32(tmp0, tmp3);
+            __m256i z2 = _mm256_add_epi32(tmp1, tmp2);
+            __m256i z3 = _mm256_add_epi32(tmp0, tmp2);
+            __m256i z4 = _mm256_add_epi32(tmp1, tmp3);
+            const __m256i z5 = mul(_mm256_add_epi32(z3, z4), FIX_1_175875602);
+
+            tmp0 = mul(tmp0, FIX_0_298631336);
+            tmp1 = mul(tmp1, FIX_2_053119869);
+            tmp2 = mul(tmp2, FIX_3_072711026);
+            tmp3 = mul(tmp3, FIX_1_501321110);
+            z1 = mul(z1, -FIX_0_899976223);
+            z2 = mul(z2, -FIX_2_562915447);
+            z3 = _mm256_add_epi32(mul(z3, -FIX_1_961570560), z5);
+            z4 = _mm256_add_epi32(mul(z4, -FIX_0_390180644), z5);
+
+            tmp0 = _mm256_add_epi32(tmp0, _mm256_add_epi32(z1, z3));
+            tmp1 = _mm256_add_epi32(tmp1, _mm256_add_epi32(z2, z4));
+            tmp2 = _mm256_add_epi32(tmp2, _mm256_add_epi32(z2, z3));
+            tmp3 = _mm256_add_epi32(tmp3, _mm256_add_epi32(z1, z4));
+        }
+
+        const __m256i round = _mm256_set1_epi32(1 << (shift - 1));
+        auto descale = [&](__m256i x) {
+            return _mm256_srai_epi32(_mm256_add_epi32(x, round), shift);
+        };
+
+        v[0] = descale(_mm256_add_epi32(tmp10, tmp3));
+        v[7] = descale(_mm256_sub_epi32(tmp10, tmp3));
+        v[1] = descale(_mm256_add_epi32(tmp11, tmp2));
+        v[6] = descale(_mm256_sub_epi32(tmp11, tmp2));
+        v[2] = descale(_mm256_add_epi32(tmp12, tmp1));
+        v[5] = descale(_mm256_sub_epi32(tmp12, tmp1));
+        v[3] = descale(_mm256_add_epi32(tmp13, tmp0));
+        v[4] = descale(_mm256_sub_epi32(tmp13, tmp0));
+    }
+
+    // 8x8 (int32_t) の転置
+    inline void transpose(std::array<__m256i, 8>& v)
+    {
+        __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+        __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+        __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+        __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+        __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+        __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+        __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+        __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+        v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+
+    // 1行ずつ int32_t に拡張しながら逆量子化する
+    inline void loadDequantized(const Block& coefs, const QuantTable& quant, std::array<__m256i, 8>& v, int rows)
+    {
+        for (int y = 0; y < rows; ++y) {
+            __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(&coefs[y * 8]));
+            __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&quant[y * 8]));
+            v[y] = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(c), q);
+        }
+    }
+
+    // レベルシフトして、 0～255 に飽和させながら int16_t に詰める
+    inline void storeSamples(const std::array<__m256i, 8>& v, Block& out)
+    {
+        const __m256i offset = _mm256_set1_epi32(128);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max = _mm256_set1_epi16(255);
+        for (int y = 0; y < 8; y += 2) {
+            __m256i a = _mm256_add_epi32(v[y], offset);
+            __m256i b = _mm256_add_epi32(v[y + 1], offset);
+            // packs は 128 ビットレーンごとに詰めるので、並びを戻す
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+            packed = _mm256_min_epi16(_mm256_max_epi16(packed, zero), max);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&out[y * 8]), packed);
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Math::IDCT
+{
+    void idctAVX2(const Block& coefs, const QuantTable& quant, Block& out)
+    {
+        std::array<__m256i, 8> v{};
+        loadDequantized(coefs, quant, v, 8);
+
+        // 列方向の IDCT (各ベクトルが1行分なので、ベクトル間で計算すると列方向になる)
+        idct1DVector(v, CONST_BITS - PASS1_BITS);
+
+        // 行方向の IDCT
+        transpose(v);
+        idct1DVector(v, CONST_BITS + PASS1_BITS + 3);
+        transpose(v);
+
+        storeSamples(v, out);
+    }
+
+    void idct4x4AVX2(const Block& coefs, const QuantTable& quant, Block& out)
+    {
+        std::array<__m256i, 8> v{};
+        loadDequantized(coefs, quant, v, 4);
+
+        // 入力の 4～7 行目が 0
+        idct1DVector<true>(v, CONST_BITS - PASS1_BITS);
+
+        // 入力の 4～7 列目が 0 なので、1パス目の結果も 4～7 列目は 0 になる
+        transpose(v);
+        idct1DVector<true>(v, CONST_BITS + PASS1_BITS + 3);
+        transpose(v);
+
+        storeSamples(v, out);
+    }
+} // namespace RagiMagick2::Image::Math::IDCT
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
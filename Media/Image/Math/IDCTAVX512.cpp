@@ -0,0 +1,218 @@
+﻿#include "IDCT.h"
+#include <immintrin.h>
+#include <array>
+#include <cstdint>
+
+// MSVC はこのファイルだけ /arch:AVX512 でビルドする (Media.vcxproj)
+// GCC / Clang は #include の後ろの定義だけを AVX-512 向けにする
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512bw,avx512dq,avx512vl"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,avx512f,avx512bw,avx512dq,avx512vl")
+#endif
+
+namespace
+{
+    using namespace RagiMagick2::Image::Math::IDCT;
+
+    // 2 ブロック分を並べたベクトル
+    // 下位 256 ビットが 1 つ目のブロック、上位 256 ビットが 2 つ目のブロックの、同じ行 (または列) の 8 要素 (int32_t)
+    using Rows = std::array<__m512i, 8>;
+
+    inline __m512i mul(__m512i a, int32_t b)
+    {
+        return _mm512_mullo_epi32(a, _mm512_set1_epi32(b));
+    }
+
+    // 8本のベクトルの同じレーン同士で 1次元 IDCT を行う (IDCTAVX2.cpp の idct1DVector と同じ計算)
+    inline void idct1DVector(Rows& v, int shift)
+    {
+        // 偶数部
+        __m512i z2 = v[2];
+        __m512i z3 = v[6];
+        __m512i z1 = mul(_mm512_add_epi32(z2, z3), FIX_0_541196100);
+        __m512i tmp2 = _mm512_sub_epi32(z1, mul(z3, FIX_1_847759065));
+        __m512i tmp3 = _mm512_add_epi32(z1, mul(z2, FIX_0_765366865));
+
+        z2 = v[0];
+        z3 = v[4];
+        __m512i tmp0 = _mm512_slli_epi32(_mm512_add_epi32(z2, z3), CONST_BITS);
+        __m512i tmp1 = _mm512_slli_epi32(_mm512_sub_epi32(z2, z3), CONST_BITS);
+
+        const __m512i tmp10 = _mm512_add_epi32(tmp0, tmp3);
+        const __m512i tmp13 = _mm512_sub_epi32(tmp0, tmp3);
+        const __m512i tmp11 = _mm512_add_epi32(tmp1, tmp2);
+        const __m512i tmp12 = _mm512_sub_epi32(tmp1, tmp2);
+
+        // 奇数部
+        tmp0 = v[7];
+        tmp1 = v[5];
+        tmp2 = v[3];
+        tmp3 = v[1];
+
+        z1 = _mm512_add_epi32(tmp0, tmp3);
+        z2 = _mm512_add_epi32(tmp1, tmp2);
+        z3 = _mm512_add_epi32(tmp0, tmp2);
+        __m512i z4 = _mm512_add_epi32(tmp1, tmp3);
+        const __m512i z5 = mul(_mm512_add_epi32(z3, z4), FIX_1_175875602);
+
+        tmp0 = mul(tmp0, FIX_0_298631336);
+        tmp1 = mul(tmp1, FIX_2_053119869);
+        tmp2 = mul(tmp2, FIX_3_072711026);
+        tmp3 = mul(tmp3, FIX_1_501321110);
+        z1 = mul(z1, -FIX_0_899976223);
+        z2 = mul(z2, -FIX_2_562915447);
+        z3 = _mm512_add_epi32(mul(z3, -FIX_1_961570560), z5);
+        z4 = _mm512_add_epi32(mul(z4, -FIX_0_390180644), z5);
+
+        tmp0 = _mm512_add_epi32(tmp0, _mm512_add_epi32(z1, z3));
+        tmp1 = _mm512_add_epi32(tmp1, _mm512_add_epi32(z2, z4));
+        tmp2 = _mm512_add_epi32(tmp2, _mm512_add_epi32(z2, z3));
+        tmp3 = _mm512_add_epi32(tmp3, _mm512_add_epi32(z1, z4));
+
+        const __m512i round = _mm512_set1_epi32(1 << (shift - 1));
+        auto descale = [&](__m512i x) {
+            return _mm512_srai_epi32(_mm512_add_epi32(x, round), shift);
+        };
+
+        v[0] = descale(_mm512_add_epi32(tmp10, tmp3));
+        v[7] = descale(_mm512_sub_epi32(tmp10, tmp3));
+        v[1] = descale(_mm512_add_epi32(tmp11, tmp2));
+        v[6] = descale(_mm512_sub_epi32(tmp11, tmp2));
+        v[2] = descale(_mm512_add_epi32(tmp12, tmp1));
+        v[5] = descale(_mm512_sub_epi32(tmp12, tmp1));
+        v[3] = descale(_mm512_add_epi32(tmp13, tmp0));
+        v[4] = descale(_mm512_sub_epi32(tmp13, tmp0));
+    }
+
+    // 256 ビットごとに 8x8 (int32_t) の転置 (2 ブロックを別々に転置する)
+    inline void transpose(Rows& v)
+    {
+        const __m512i t0 = _mm512_unpacklo_epi32(v[0], v[1]);
+        const __m512i t1 = _mm512_unpackhi_epi32(v[0], v[1]);
+        const __m512i t2 = _mm512_unpacklo_epi32(v[2], v[3]);
+        const __m512i t3 = _mm512_unpackhi_epi32(v[2], v[3]);
+        const __m512i t4 = _mm512_unpacklo_epi32(v[4], v[5]);
+        const __m512i t5 = _mm512_unpackhi_epi32(v[4], v[5]);
+        const __m512i t6 = _mm512_unpacklo_epi32(v[6], v[7]);
+        const __m512i t7 = _mm512_unpackhi_epi32(v[6], v[7]);
+
+        const __m512i u0 = _mm512_unpacklo_epi64(t0, t2);
+        const __m512i u1 = _mm512_unpackhi_epi64(t0, t2);
+        const __m512i u2 = _mm512_unpacklo_epi64(t1, t3);
+        const __m512i u3 = _mm512_unpackhi_epi64(t1, t3);
+        const __m512i u4 = _mm512_unpacklo_epi64(t4, t6);
+        const __m512i u5 = _mm512_unpackhi_epi64(t4, t6);
+        const __m512i u6 = _mm512_unpacklo_epi64(t5, t7);
+        const __m512i u7 = _mm512_unpackhi_epi64(t5, t7);
+
+        // AVX2 版の permute2x128 (0x20, 0x31) を、 256 ビットの半分ごとに行う
+        const __m512i lowIndex = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+        const __m512i highIndex = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+        v[0] = _mm512_permutex2var_epi64(u0, lowIndex, u4);
+        v[1] = _mm512_permutex2var_epi64(u1, lowIndex, u5);
+        v[2] = _mm512_permutex2var_epi64(u2, lowIndex, u6);
+        v[3] = _mm512_permutex2var_epi64(u3, lowIndex, u7);
+        v[4] = _mm512_permutex2var_epi64(u0, highIndex, u4);
+        v[5] = _mm512_permutex2var_epi64(u1, highIndex, u5);
+        v[6] = _mm512_permutex2var_epi64(u2, highIndex, u6);
+        v[7] = _mm512_permutex2var_epi64(u3, highIndex, u7);
+    }
+
+    // order に従って 64 個の係数を並べ替える (vpermt2w を 2 回)
+    // 結果は自然順の 0～3 行目と 4～7 行目
+    inline void reorder(const Block& coefs, const __m512i (&index)[2], __m512i& upper, __m512i& lower)
+    {
+        const __m512i first = _mm512_loadu_si512(&coefs[0]);
+        const __m512i second = _mm512_loadu_si512(&coefs[32]);
+        upper = _mm512_permutex2var_epi16(first, index[0], second);
+        lower = _mm512_permutex2var_epi16(first, index[1], second);
+    }
+
+    // 2 ブロック分の係数 (自然順、 int16_t) を行ごとに並べて int32_t に拡張しながら逆量子化する
+    inline void loadDequantized(
+        const Block& coefs0, const QuantTable& quant0,
+        const Block& coefs1, const QuantTable& quant1,
+        const __m512i (&index)[2],
+        Rows& v
+    )
+    {
+        __m512i upper0, lower0, upper1, lower1;
+        reorder(coefs0, index, upper0, lower0);
+        reorder(coefs1, index, upper1, lower1);
+
+        // 128 ビット (1行) 単位で [ブロック0 の y 行, ブロック1 の y 行, ブロック0 の y + 1 行, ブロック1 の y + 1 行] に並べる
+        const __m512i evenIndex = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+        const __m512i oddIndex = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+        const std::array<__m512i, 4> pairs = {
+            _mm512_permutex2var_epi64(upper0, evenIndex, upper1),
+            _mm512_permutex2var_epi64(upper0, oddIndex, upper1),
+            _mm512_permutex2var_epi64(lower0, evenIndex, lower1),
+            _mm512_permutex2var_epi64(lower0, oddIndex, lower1),
+        };
+
+        for (int y = 0; y < 8; ++y) {
+            const __m512i& pair = pairs[y / 2];
+            const __m256i c = y % 2 == 0 ? _mm512_castsi512_si256(pair) : _mm512_extracti64x4_epi64(pair, 1);
+            const __m512i q = _mm512_inserti64x4(
+                _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&quant0[y * 8]))),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&quant1[y * 8])),
+                1
+            );
+            v[y] = _mm512_mullo_epi32(_mm512_cvtepi16_epi32(c), q);
+        }
+    }
+
+    // レベルシフトして、 0～255 に飽和させながら int16_t に詰めて、それぞれのブロックに書き込む
+    inline void storeSamples(const Rows& v, Block& out0, Block& out1)
+    {
+        const __m512i offset = _mm512_set1_epi32(128);
+        const __m512i max = _mm512_set1_epi16(255);
+        // packus は 128 ビットレーンごとに詰めるので、行の並びに戻す
+        const __m512i order = _mm512_set_epi64(7, 5, 6, 4, 3, 1, 2, 0);
+        for (int y = 0; y < 8; y += 2) {
+            const __m512i a = _mm512_add_epi32(v[y], offset);
+            const __m512i b = _mm512_add_epi32(v[y + 1], offset);
+            // 負の値は packus で 0 になる
+            __m512i packed = _mm512_permutexvar_epi64(order, _mm512_packus_epi32(a, b));
+            packed = _mm512_min_epu16(packed, max);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&out0[y * 8]), _mm512_castsi512_si256(packed));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&out1[y * 8]), _mm512_extracti64x4_epi64(packed, 1));
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Math::IDCT
+{
+    void idctPairAVX512(
+        const Block& coefs0, const QuantTable& quant0, Block& out0,
+        const Block& coefs1, const QuantTable& quant1, Block& out1,
+        const CoefficientOrder& order
+    )
+    {
+        const __m512i index[2] = {
+            _mm512_loadu_si512(&order[0]),
+            _mm512_loadu_si512(&order[32]),
+        };
+
+        Rows v{};
+        loadDequantized(coefs0, quant0, coefs1, quant1, index, v);
+
+        // 列方向の IDCT
+        idct1DVector(v, CONST_BITS - PASS1_BITS);
+
+        // 行方向の IDCT
+        transpose(v);
+        idct1DVector(v, CONST_BITS + PASS1_BITS + 3);
+        transpose(v);
+
+        storeSamples(v, out0, out1);
+    }
+} // namespace RagiMagick2::Image::Math::IDCT
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -1,14 +1,24 @@
-﻿#pragma once
-
-namespace RagiMagick2::Image::Pixel
-{
-    enum class PixelFormat
-    {
-        // YCbCr 4:4:4
-        YCBCR444_UINT,
-        // YCbCr 4:2:0
-        YCBCR420_UINT,
-        // BGRA 32bit
-        B8G8R8A8_UINT,
-    };
-} // namespace RagiMagick2::Image::Pixel
+﻿#pragma once
+
+namespace RagiMagick2::Image::Pixel
+{
+    enum class PixelFormat
+    {
+        // YCbCr 4:4:4
+        // 出力形式としては、色変換しない 8bit の平面 (Y, Cb, Cr が同じ大きさ)
+        YCBCR444_UINT,
+        // YCbCr 4:2:0
+        // 出力形式としては、色変換しない 8bit の平面 (Cb, Cr は幅・高さとも Y の半分を切り上げ)
+        YCBCR420_UINT,
+        // BGRA 32bit
+        B8G8R8A8_UINT,
+        // グレースケール 8bit
+        R8_UINT,
+        // RGB 24bit
+        R8G8B8_UINT,
+        // BGR 24bit
+        B8G8R8_UINT,
+        // RGBA 32bit
+        R8G8B8A8_UINT,
+    };
+} // namespace RagiMagick2::Image::Pixel
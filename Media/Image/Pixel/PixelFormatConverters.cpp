@@ -0,0 +1,129 @@
+﻿#include "PixelFormatConverters.h"
+#include "SIMDCommon.h"
+#include <cstdint>
+#include "Common/CPU.h"
+
+// スカラー版と、 CPU に合わせた実装の選択
+// このファイルはプロジェクトの既定の命令セットでビルドする (AVX2 の CPU が無くても動くように)
+namespace
+{
+    using namespace RagiMagick2::Image::Pixel;
+    using RagiMagick2::Image::Pixel::SIMD::dispatchRGBFormat;
+
+    template <PixelFormat Format>
+    inline void storePixel(int y, int cb, int cr, uint8_t* dst)
+    {
+        const auto& [r, g, b] = ycbcrToRGB(y, cb, cr);
+        storeRGB(Format, r, g, b, dst);
+    }
+
+    RowConverters selectRowConverters() noexcept
+    {
+        using RagiMagick2::Common::SIMDLevel;
+        switch (RagiMagick2::Common::getSIMDLevel()) {
+        case SIMDLevel::AVX512:
+            return { convertRowYCbCr420AVX512, convertRowYCbCr444AVX2, convertRowYCbCr420FancyAVX2, convertRowGrayAVX2 };
+        case SIMDLevel::AVX2:
+            return { convertRowYCbCr420AVX2, convertRowYCbCr444AVX2, convertRowYCbCr420FancyAVX2, convertRowGrayAVX2 };
+        default:
+            return { convertRowYCbCr420Scalar, convertRowYCbCr444Scalar, convertRowYCbCr420FancyScalar, convertRowGrayScalar };
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Pixel
+{
+    void convertRowYCbCr420Scalar(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool /*isNonTemporal*/
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            for (int x = 0; x < width; ++x) {
+                storePixel<Format>(y[x], cb[x / 2], cr[x / 2], dst + x * bytesPerPixel);
+            }
+        });
+    }
+
+    void convertRowYCbCr444Scalar(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool /*isNonTemporal*/
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            for (int x = 0; x < width; ++x) {
+                storePixel<Format>(y[x], cb[x], cr[x], dst + x * bytesPerPixel);
+            }
+        });
+    }
+
+    void convertRowYCbCr420FancyScalar(
+        const int16_t* y,
+        const int16_t* cbNear,
+        const int16_t* cbFar,
+        const int16_t* crNear,
+        const int16_t* crFar,
+        int chromaWidth,
+        int left,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool /*isNonTemporal*/
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            for (int x = left; x < left + width; ++x) {
+                storePixel<Format>(
+                    y[x],
+                    upsampleFancy(cbNear, cbFar, chromaWidth, x),
+                    upsampleFancy(crNear, crFar, chromaWidth, x),
+                    dst + (x - left) * bytesPerPixel
+                );
+            }
+        });
+    }
+
+    void convertRowGrayScalar(
+        const int16_t* y,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool /*isNonTemporal*/
+    ) noexcept
+    {
+        if (format == PixelFormat::R8_UINT) {
+            for (int x = 0; x < width; ++x) {
+                dst[x] = static_cast<uint8_t>(y[x]);
+            }
+            return;
+        }
+
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            for (int x = 0; x < width; ++x) {
+                const auto value = static_cast<uint8_t>(y[x]);
+                storeRGB(Format, value, value, value, dst + x * bytesPerPixel);
+            }
+        });
+    }
+
+    const RowConverters& getRowConverters() noexcept
+    {
+        static const RowConverters converters = selectRowConverters();
+        return converters;
+    }
+
+} // namespace RagiMagick2::Image::Pixel
@@ -1,161 +1,473 @@
-﻿#pragma once
-#include <immintrin.h>
-#include <algorithm>
-#include <cassert>
-#include <concepts>
-#include <cstdint>
-#include <span>
-#include <tuple>
-#include <utility>
-#include <vector>
-#include "PixelFormat.h"
-
-namespace RagiMagick2::Image::Pixel
-{
-    template<std::integral T = int, std::integral R = uint8_t>
-    constexpr std::tuple<R, R, R> ycbcrToRGB(T y, T cb, T cr) noexcept
-    {
-        constexpr int coef_r = static_cast<int>(1.402 * 65536);
-        constexpr int coef_g_1 = static_cast<int>(0.344136 * 65536);
-        constexpr int coef_g_2 = static_cast<int>(0.714136 * 65536);
-        constexpr int coef_b = static_cast<int>(1.772 * 65536);
-
-        cb -= 128;
-        cr -= 128;
-        int r = y + ((coef_r * cr) >> 16);
-        int g = y - ((coef_g_1 * cb + coef_g_2 * cr) >> 16);
-        int b = y + ((coef_b * cb) >> 16);
-
-        return {
-            static_cast<R>(std::clamp(r, 0, 255)),
-            static_cast<R>(std::clamp(g, 0, 255)),
-            static_cast<R>(std::clamp(b, 0, 255))
-        };
-    }
-    static_assert(ycbcrToRGB(255, 128, 128) == std::make_tuple(255, 255, 255));
-    static_assert(ycbcrToRGB(1, 2, 3) == std::make_tuple(0, 134, 0));
-
-    constexpr std::tuple<double, double> getHorizontalSamplingFactor(PixelFormat format) noexcept
-    {
-        switch (format) {
-        case PixelFormat::YCBCR444_UINT:
-            return { 1.0, 1.0 };
-        case PixelFormat::YCBCR420_UINT:
-            return { 0.5, 0.5 };
-        default:
-            assert(false);
-            return { 1.0, 1.0 };
-        }
-    }
-
-    constexpr std::tuple<double, double> getVerticalSamplingFactor(PixelFormat format) noexcept
-    {
-        switch (format) {
-        case PixelFormat::YCBCR444_UINT:
-            return { 1.0, 1.0 };
-        case PixelFormat::YCBCR420_UINT:
-            return { 0.5, 0.5 };
-        default:
-            assert(false);
-            return { 1.0, 1.0 };
-        }
-    }
-
-    template <PixelFormat SrcFormat>
-    inline void convertYCbCrToBGRA32(
-        int width,
-        int height,
-        std::span<uint8_t> dst,
-        std::span<int16_t> srcY,
-        std::span<int16_t> srcCb,
-        std::span<int16_t> srcCr
-    ) noexcept
-    {
-        assert(dst.size() == width * height * 4);
-        assert(srcY.size() == width * height);
-
-        constexpr auto hFactor = getHorizontalSamplingFactor(SrcFormat);
-        constexpr auto vFactor = getVerticalSamplingFactor(SrcFormat);
-
-        const auto& [cbHFactor, cbVFactor] = hFactor;
-        const auto& [crHFactor, crVFactor] = vFactor;
-
-        const int cbWidth = static_cast<int>(width * cbHFactor);
-        const int crWidth = static_cast<int>(width * crHFactor);
-        assert(srcCb.size() == cbWidth * height * cbVFactor);
-        assert(srcCr.size() == crWidth * height * crVFactor);
-
-        struct Pixel
-        {
-            uint8_t b = 0;
-            uint8_t r = 0;
-            uint8_t g = 0;
-            uint8_t a = 0;
-        };
-
-        std::vector<Pixel> pixels(width * height);
-        size_t index = 0;
-
-        for (size_t row = 0; row < height; ++row) {
-            size_t yRow = row * width;
-            size_t cbRow = static_cast<size_t>(row * cbHFactor) * cbWidth;
-            size_t crRow = static_cast<size_t>(row * crHFactor) * crWidth;
-
-            for (size_t col = 0; col < width; ++col) {
-                size_t yOffset = yRow + col;
-                size_t cbOffset = cbRow + static_cast<size_t>(col * cbVFactor);
-                size_t crOffset = crRow + static_cast<size_t>(col * crVFactor);
-
-                int16_t y = srcY[yOffset];
-                int16_t cb = srcCb[cbOffset];
-                int16_t cr = srcCr[crOffset];
-
-                const auto& [r, g, b] = ycbcrToRGB(y, cb, cr);
-                pixels[index++] = { b, g, r, 0xFF }; // 結局ここが遅い
-            }
-        }
-
-        for (size_t i = 0; i < pixels.size(); i += 8) {
-            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
-            _mm256_store_si256(reinterpret_cast<__m256i*>(&dst[i * 4]), v);
-        }
-    }
-
-    template <>
-    inline void convertYCbCrToBGRA32<PixelFormat::YCBCR444_UINT>(
-        int width,
-        int height,
-        std::span<uint8_t> dst,
-        std::span<int16_t> srcY,
-        std::span<int16_t> srcCb,
-        std::span<int16_t> srcCr
-    ) noexcept
-    {
-        assert(dst.size() == width * height * 4);
-        assert(srcY.size() == width * height);
-        assert(srcCb.size() == width * height);
-        assert(srcCr.size() == width * height);
-
-        struct Pixel
-        {
-            uint8_t b = 0;
-            uint8_t r = 0;
-            uint8_t g = 0;
-            uint8_t a = 0;
-        };
-
-        std::vector<Pixel> pixels(width * height);
-        size_t index = 0;
-
-        for (size_t i = 0; i < srcY.size(); ++i) {
-            const auto& [r, g, b] = ycbcrToRGB(srcY[i], srcCb[i], srcCr[i]);
-            pixels[index++] = { b, g, r, 0xFF };
-        }
-
-        for (size_t i = 0; i < pixels.size(); i += 8) {
-            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
-            _mm256_store_si256(reinterpret_cast<__m256i*>(&dst[i * 4]), v);
-        }
-    }
-
-} // namespace RagiMagick2::Image::Pixel
+﻿#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "PixelFormat.h"
+
+namespace RagiMagick2::Image::Pixel
+{
+    template<std::integral T = int, std::integral R = uint8_t>
+    constexpr std::tuple<R, R, R> ycbcrToRGB(T y, T cb, T cr) noexcept
+    {
+        constexpr int coef_r = static_cast<int>(1.402 * 65536);
+        constexpr int coef_g_1 = static_cast<int>(0.344136 * 65536);
+        constexpr int coef_g_2 = static_cast<int>(0.714136 * 65536);
+        constexpr int coef_b = static_cast<int>(1.772 * 65536);
+
+        cb -= 128;
+        cr -= 128;
+        int r = y + ((coef_r * cr) >> 16);
+        int g = y - ((coef_g_1 * cb + coef_g_2 * cr) >> 16);
+        int b = y + ((coef_b * cb) >> 16);
+
+        return {
+            static_cast<R>(std::clamp(r, 0, 255)),
+            static_cast<R>(std::clamp(g, 0, 255)),
+            static_cast<R>(std::clamp(b, 0, 255))
+        };
+    }
+    static_assert(ycbcrToRGB(255, 128, 128) == std::make_tuple(255, 255, 255));
+    static_assert(ycbcrToRGB(1, 2, 3) == std::make_tuple(0, 134, 0));
+
+    // ycbcrToRGB の逆変換 (libjpeg の jccolor.c (rgb_ycc_convert) と同じ定数・丸め)
+    // Cb, Cr は 255 を超えないように、丸めの定数を 1 小さくしている
+    constexpr std::tuple<uint8_t, uint8_t, uint8_t> rgbToYCbCr(int r, int g, int b) noexcept
+    {
+        constexpr int SCALE_BITS = 16;
+        constexpr int ONE_HALF = 1 << (SCALE_BITS - 1);
+        constexpr int CBCR_OFFSET = 128 << SCALE_BITS;
+        constexpr auto fix = [](double x) { return static_cast<int>(x * (1 << SCALE_BITS) + 0.5); };
+
+        const int y = (fix(0.299) * r + fix(0.587) * g + fix(0.114) * b + ONE_HALF) >> SCALE_BITS;
+        const int cb = (-fix(0.16874) * r - fix(0.33126) * g + fix(0.5) * b + CBCR_OFFSET + ONE_HALF - 1) >> SCALE_BITS;
+        const int cr = (fix(0.5) * r - fix(0.41869) * g - fix(0.08131) * b + CBCR_OFFSET + ONE_HALF - 1) >> SCALE_BITS;
+
+        return { static_cast<uint8_t>(y), static_cast<uint8_t>(cb), static_cast<uint8_t>(cr) };
+    }
+    static_assert(rgbToYCbCr(255, 255, 255) == std::make_tuple(255, 128, 128));
+    static_assert(rgbToYCbCr(0, 0, 255) == std::make_tuple(29, 255, 107));
+
+    constexpr std::tuple<double, double> getHorizontalSamplingFactor(PixelFormat format) noexcept
+    {
+        switch (format) {
+        case PixelFormat::YCBCR444_UINT:
+            return { 1.0, 1.0 };
+        case PixelFormat::YCBCR420_UINT:
+            return { 0.5, 0.5 };
+        default:
+            assert(false);
+            return { 1.0, 1.0 };
+        }
+    }
+
+    constexpr std::tuple<double, double> getVerticalSamplingFactor(PixelFormat format) noexcept
+    {
+        switch (format) {
+        case PixelFormat::YCBCR444_UINT:
+            return { 1.0, 1.0 };
+        case PixelFormat::YCBCR420_UINT:
+            return { 0.5, 0.5 };
+        default:
+            assert(false);
+            return { 1.0, 1.0 };
+        }
+    }
+
+    // libjpeg の h2v2_fancy_upsample と同じ三角フィルタで、出力の x 番目の色差を求める
+    // near は出力行に近い方の色差の行、 far は遠い方の行 (画像の上端・下端では near と同じ行)
+    // 左右の端では、外側の色差の代わりに端の色差を使う
+    inline int upsampleFancy(const int16_t* near, const int16_t* far, int chromaWidth, int x) noexcept
+    {
+        auto colsum = [&](int i) { return near[i] * 3 + far[i]; };
+        const int i = x / 2;
+        const int current = colsum(i);
+        if (x % 2 == 0) {
+            return i == 0 ? (current * 4 + 8) >> 4 : (current * 3 + colsum(i - 1) + 8) >> 4;
+        }
+        return i == chromaWidth - 1 ? (current * 4 + 7) >> 4 : (current * 3 + colsum(i + 1) + 7) >> 4;
+    }
+
+    // 出力するピクセル形式の1ピクセルあたりのバイト数 (平面 YUV の場合は Y のプレーン)
+    constexpr int getBytesPerPixel(PixelFormat format) noexcept
+    {
+        switch (format) {
+        case PixelFormat::B8G8R8A8_UINT:
+        case PixelFormat::R8G8B8A8_UINT:
+            return 4;
+        case PixelFormat::R8G8B8_UINT:
+        case PixelFormat::B8G8R8_UINT:
+            return 3;
+        case PixelFormat::R8_UINT:
+        case PixelFormat::YCBCR444_UINT:
+        case PixelFormat::YCBCR420_UINT:
+            return 1;
+        default:
+            assert(false);
+            return 4;
+        }
+    }
+
+    // 色変換して RGB で書き込むピクセル形式か (BGRA32, RGBA32, RGB24, BGR24)
+    constexpr bool isRGBFormat(PixelFormat format) noexcept
+    {
+        switch (format) {
+        case PixelFormat::B8G8R8A8_UINT:
+        case PixelFormat::R8G8B8A8_UINT:
+        case PixelFormat::R8G8B8_UINT:
+        case PixelFormat::B8G8R8_UINT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 色変換せずに 8bit の平面 YUV で書き込むピクセル形式か
+    constexpr bool isPlanarFormat(PixelFormat format) noexcept
+    {
+        return format == PixelFormat::YCBCR444_UINT || format == PixelFormat::YCBCR420_UINT;
+    }
+
+    // 1ピクセル分の RGB を format (isRGBFormat) の並びで dst に書き込む
+    inline void storeRGB(PixelFormat format, uint8_t r, uint8_t g, uint8_t b, uint8_t* dst) noexcept
+    {
+        switch (format) {
+        case PixelFormat::B8G8R8A8_UINT:
+            dst[0] = b;
+            dst[1] = g;
+            dst[2] = r;
+            dst[3] = 0xFF;
+            break;
+        case PixelFormat::R8G8B8A8_UINT:
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+            dst[3] = 0xFF;
+            break;
+        case PixelFormat::R8G8B8_UINT:
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+            break;
+        case PixelFormat::B8G8R8_UINT:
+            dst[0] = b;
+            dst[1] = g;
+            dst[2] = r;
+            break;
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    // format (isRGBFormat) の並びの1ピクセルから RGB を読む
+    inline std::tuple<uint8_t, uint8_t, uint8_t> loadRGB(PixelFormat format, const uint8_t* src) noexcept
+    {
+        switch (format) {
+        case PixelFormat::B8G8R8A8_UINT:
+        case PixelFormat::B8G8R8_UINT:
+            return { src[2], src[1], src[0] };
+        case PixelFormat::R8G8B8A8_UINT:
+        case PixelFormat::R8G8B8_UINT:
+            return { src[0], src[1], src[2] };
+        default:
+            assert(false);
+            return { 0, 0, 0 };
+        }
+    }
+
+    // 1行分の変換関数の型
+    // format は isRGBFormat の形式 (Gray だけは R8_UINT も可)
+    // isNonTemporal が true なら、書き込み先がアライメントされている部分はキャッシュを汚さないストリーミングストアで書き込む
+    // 結果はどの実装でも ycbcrToRGB で1ピクセルずつ変換したものと同じになる
+
+    // 4:2:0 の1行分の width ピクセルを変換する (色差は最近傍で 2 倍に拡大)
+    // y は出力する最初のピクセル、 cb, cr はその色差を指す (y の x 座標は偶数であること)
+    using ConvertRowYCbCr420 = void (*)(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept;
+
+    // Y, Cb, Cr が同じ大きさの1行分の width ピクセルを変換する
+    using ConvertRowYCbCr444 = ConvertRowYCbCr420;
+
+    // 4:2:0 の1行分を、色差を三角フィルタ (upsampleFancy) で拡大して変換する
+    // y, cbNear, cbFar, crNear, crFar は行の先頭 (x = 0) を指し、 x = left から width ピクセル分を dst に書き込む
+    using ConvertRowYCbCr420Fancy = void (*)(
+        const int16_t* y,
+        const int16_t* cbNear,
+        const int16_t* cbFar,
+        const int16_t* crNear,
+        const int16_t* crFar,
+        int chromaWidth,
+        int left,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept;
+
+    // Y だけの1行分の width ピクセルを、 R8_UINT ならそのまま 8bit に、それ以外は B = G = R = Y で書き込む
+    // サンプル値は IDCT で 0～255 に飽和済みなので、 8bit に詰めるだけでよい
+    using ConvertRowGray = void (*)(
+        const int16_t* y,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept;
+
+    // スカラー版 (SSE2 までの CPU 用、 SIMD 版の検証用)
+    void convertRowYCbCr420Scalar(const int16_t* y, const int16_t* cb, const int16_t* cr, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowYCbCr444Scalar(const int16_t* y, const int16_t* cb, const int16_t* cr, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowYCbCr420FancyScalar(const int16_t* y, const int16_t* cbNear, const int16_t* cbFar, const int16_t* crNear, const int16_t* crFar, int chromaWidth, int left, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowGrayScalar(const int16_t* y, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+
+    // AVX2 版 (16 ピクセル単位の残りはスカラーで処理する)
+    void convertRowYCbCr420AVX2(const int16_t* y, const int16_t* cb, const int16_t* cr, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowYCbCr444AVX2(const int16_t* y, const int16_t* cb, const int16_t* cr, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowYCbCr420FancyAVX2(const int16_t* y, const int16_t* cbNear, const int16_t* cbFar, const int16_t* crNear, const int16_t* crFar, int chromaWidth, int left, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+    void convertRowGrayAVX2(const int16_t* y, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+
+    // AVX-512 版 (32 ピクセルずつ処理する)
+    // 4 バイトの形式以外と 32 ピクセル単位の残りは AVX2 版で処理する
+    void convertRowYCbCr420AVX512(const int16_t* y, const int16_t* cb, const int16_t* cr, int width, uint8_t* dst, PixelFormat format, bool isNonTemporal) noexcept;
+
+    // CPU に合わせて選んだ1行分の変換関数
+    struct RowConverters
+    {
+        ConvertRowYCbCr420 ycbcr420;
+        ConvertRowYCbCr444 ycbcr444;
+        ConvertRowYCbCr420Fancy ycbcr420Fancy;
+        ConvertRowGray gray;
+    };
+
+    // 最初に呼ばれたときに Common::getSIMDLevel() で1度だけ選ぶ
+    const RowConverters& getRowConverters() noexcept;
+
+    // 1成分分のサンプル値のプレーン
+    // 出力の (x, y) には、プレーンの (x * h / maxH, y * v / maxV) のサンプルを使う (最近傍)
+    struct SamplePlane
+    {
+        std::span<const int16_t> samples;
+        int stride;
+        int horizontalSamplingFactor;
+        int verticalSamplingFactor;
+    };
+
+    // 任意のサンプリングファクタの YCbCr のうち、出力の (left, top) から width x height の範囲を dstFormat に変換して dst に書き込む
+    // maxH, maxV は全成分の最大のサンプリングファクタ (4:2:2 なら 2, 1、 4:4:0 なら 1, 2)
+    // 1行ずつ出力の大きさに拡大してから、 4:4:4 と同じ関数で変換する
+    // rowBuffer は拡大した1行分の作業用 (width * 3 に足りなければ広げる)、呼び出し元で使い回して確保を減らす
+    inline void convertYCbCr(
+        PixelFormat dstFormat,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        const SamplePlane& y,
+        const SamplePlane& cb,
+        const SamplePlane& cr,
+        int maxH,
+        int maxV,
+        std::vector<int16_t>& rowBuffer,
+        int left = 0,
+        int top = 0,
+        bool isNonTemporal = false
+    ) noexcept
+    {
+        const size_t bytesPerPixel = getBytesPerPixel(dstFormat);
+        assert(dstStride >= width * bytesPerPixel);
+        assert(dst.size() >= dstStride * (height - 1) + width * bytesPerPixel);
+
+        if (rowBuffer.size() < static_cast<size_t>(width) * 3) {
+            rowBuffer.resize(static_cast<size_t>(width) * 3);
+        }
+        auto upsampleRow = [&](const SamplePlane& plane, int line, int16_t* out) -> const int16_t* {
+            const int16_t* row = &plane.samples[static_cast<size_t>(line * plane.verticalSamplingFactor / maxV) * plane.stride];
+            if (plane.horizontalSamplingFactor == maxH) {
+                return row + left;
+            }
+            for (int col = 0; col < width; ++col) {
+                out[col] = row[(left + col) * plane.horizontalSamplingFactor / maxH];
+            }
+            return out;
+        };
+
+        const auto convertRow = getRowConverters().ycbcr444;
+        for (int r = 0; r < height; ++r) {
+            const int line = top + r;
+            convertRow(
+                upsampleRow(y, line, &rowBuffer[0]),
+                upsampleRow(cb, line, &rowBuffer[width]),
+                upsampleRow(cr, line, &rowBuffer[width * 2]),
+                width, &dst[r * dstStride], dstFormat, isNonTemporal
+            );
+        }
+    }
+
+    // Y だけのプレーンの (left, top) から width x height の範囲を dstFormat (R8_UINT か isRGBFormat) で dst に書き込む
+    // R8_UINT の場合は色変換せずに 8bit のグレースケール、それ以外は B = G = R = Y
+    inline void convertGray(
+        PixelFormat dstFormat,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        std::span<const int16_t> srcY,
+        int srcStride,
+        int left = 0,
+        int top = 0,
+        bool isNonTemporal = false
+    ) noexcept
+    {
+        const size_t bytesPerPixel = getBytesPerPixel(dstFormat);
+        assert(dstStride >= width * bytesPerPixel);
+        assert(dst.size() >= dstStride * (height - 1) + width * bytesPerPixel);
+        assert(srcY.size() >= static_cast<size_t>((top + height - 1) * srcStride + left + width));
+
+        const auto convertRow = getRowConverters().gray;
+        for (int row = 0; row < height; ++row) {
+            const int16_t* in = &srcY[static_cast<size_t>(top + row) * srcStride + left];
+            convertRow(in, width, &dst[row * dstStride], dstFormat, isNonTemporal);
+        }
+    }
+
+    // Y プレーン上の (left, top) から width x height の範囲を dstFormat (isRGBFormat) に変換して dst に書き込む
+    // srcStride は Y プレーンの幅で、色差のプレーンの幅は切り上げ (YCbCrComponents と同じ)
+    // dst は dstStride バイト間隔で height 行、アライメントや 8 ピクセル単位であることは仮定しない
+    // isNonTemporal は、 SIMD 版で変換する場合にストリーミングストアを使うかどうか
+    template <PixelFormat SrcFormat>
+    inline void convertYCbCr(
+        PixelFormat dstFormat,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        std::span<const int16_t> srcY,
+        std::span<const int16_t> srcCb,
+        std::span<const int16_t> srcCr,
+        int srcStride,
+        int left = 0,
+        int top = 0,
+        bool isNonTemporal = false
+    ) noexcept
+    {
+        const size_t bytesPerPixel = getBytesPerPixel(dstFormat);
+        assert(dstStride >= width * bytesPerPixel);
+        assert(dst.size() >= dstStride * (height - 1) + width * bytesPerPixel);
+        assert(srcY.size() >= static_cast<size_t>((top + height - 1) * srcStride + left + width));
+
+        constexpr auto hFactor = getHorizontalSamplingFactor(SrcFormat);
+        constexpr auto vFactor = getVerticalSamplingFactor(SrcFormat);
+
+        const auto& [cbHFactor, crHFactor] = hFactor;
+        const auto& [cbVFactor, crVFactor] = vFactor;
+
+        const size_t cbStride = static_cast<size_t>(srcStride * cbHFactor + 0.5);
+        const size_t crStride = static_cast<size_t>(srcStride * crHFactor + 0.5);
+
+        for (int row = 0; row < height; ++row) {
+            const int y = top + row;
+            const int16_t* yRow = &srcY[static_cast<size_t>(y) * srcStride];
+            const int16_t* cbRow = &srcCb[static_cast<size_t>(y * cbVFactor) * cbStride];
+            const int16_t* crRow = &srcCr[static_cast<size_t>(y * crVFactor) * crStride];
+            uint8_t* out = &dst[row * dstStride];
+
+            for (int col = 0; col < width; ++col) {
+                const int x = left + col;
+                const auto& [r, g, b] = ycbcrToRGB(
+                    yRow[x],
+                    cbRow[static_cast<size_t>(x * cbHFactor)],
+                    crRow[static_cast<size_t>(x * crHFactor)]
+                );
+                storeRGB(dstFormat, r, g, b, out + col * bytesPerPixel);
+            }
+        }
+    }
+
+    // 4:2:0 は1行ずつ getRowConverters() の関数で変換する
+    template <>
+    inline void convertYCbCr<PixelFormat::YCBCR420_UINT>(
+        PixelFormat dstFormat,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        std::span<const int16_t> srcY,
+        std::span<const int16_t> srcCb,
+        std::span<const int16_t> srcCr,
+        int srcStride,
+        int left,
+        int top,
+        bool isNonTemporal
+    ) noexcept
+    {
+        const size_t bytesPerPixel = getBytesPerPixel(dstFormat);
+        assert(dstStride >= width * bytesPerPixel);
+        assert(dst.size() >= dstStride * (height - 1) + width * bytesPerPixel);
+        assert(srcY.size() >= static_cast<size_t>((top + height - 1) * srcStride + left + width));
+
+        const size_t chromaStride = static_cast<size_t>(srcStride + 1) / 2;
+        const auto convertRow = getRowConverters().ycbcr420;
+
+        for (int row = 0; row < height; ++row) {
+            const int y = top + row;
+            const int16_t* yRow = &srcY[static_cast<size_t>(y) * srcStride];
+            const int16_t* cbRow = &srcCb[static_cast<size_t>(y / 2) * chromaStride];
+            const int16_t* crRow = &srcCr[static_cast<size_t>(y / 2) * chromaStride];
+            uint8_t* out = &dst[row * dstStride];
+
+            // 1行分の変換関数は偶数の x から始めるので、奇数なら最初の1ピクセルだけここで変換する
+            int x = left;
+            if (x % 2 != 0) {
+                const auto& [r, g, b] = ycbcrToRGB(yRow[x], cbRow[x / 2], crRow[x / 2]);
+                storeRGB(dstFormat, r, g, b, out);
+                out += bytesPerPixel;
+                ++x;
+            }
+            if (const int count = left + width - x; count > 0) {
+                convertRow(yRow + x, cbRow + x / 2, crRow + x / 2, count, out, dstFormat, isNonTemporal);
+            }
+        }
+    }
+
+    template <>
+    inline void convertYCbCr<PixelFormat::YCBCR444_UINT>(
+        PixelFormat dstFormat,
+        int width,
+        int height,
+        std::span<uint8_t> dst,
+        size_t dstStride,
+        std::span<const int16_t> srcY,
+        std::span<const int16_t> srcCb,
+        std::span<const int16_t> srcCr,
+        int srcStride,
+        int left,
+        int top,
+        bool isNonTemporal
+    ) noexcept
+    {
+        const size_t bytesPerPixel = getBytesPerPixel(dstFormat);
+        assert(dstStride >= width * bytesPerPixel);
+        assert(dst.size() >= dstStride * (height - 1) + width * bytesPerPixel);
+        assert(srcY.size() >= static_cast<size_t>((top + height - 1) * srcStride + left + width));
+        assert(srcCb.size() == srcY.size() && srcCr.size() == srcY.size());
+
+        const auto convertRow = getRowConverters().ycbcr444;
+        for (int row = 0; row < height; ++row) {
+            const size_t offset = static_cast<size_t>(top + row) * srcStride + left;
+            convertRow(&srcY[offset], &srcCb[offset], &srcCr[offset], width, &dst[row * dstStride], dstFormat, isNonTemporal);
+        }
+    }
+
+} // namespace RagiMagick2::Image::Pixel
@@ -0,0 +1,305 @@
+﻿#include "PixelFormatConverters.h"
+#include "SIMDCommon.h"
+#include <immintrin.h>
+#include <array>
+#include <cstdint>
+
+// MSVC はこのファイルだけ /arch:AVX2 でビルドする (Media.vcxproj)
+// GCC / Clang は #include の後ろの定義だけを AVX2 向けにする (ヘッダーのインライン関数を AVX2 向けにしないため)
+// MSVC ではヘッダーのインライン関数も AVX2 でビルドされて、既定の命令セットの翻訳単位のものとまとめられることがあるので、
+// ここではヘッダーのインライン関数 (ycbcrToRGB, storeRGB など) を呼ばずに、 SIMD で処理しない部分はスカラー版を呼ぶ
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace
+{
+    using namespace RagiMagick2::Image::Pixel;
+    using namespace RagiMagick2::Image::Pixel::SIMD;
+
+    // RGB24 の 48 バイトのうち、各 16 バイトに R, G, B (それぞれ 16 ピクセル分) のどのバイトを置くかの pshufb のマスク
+    // [出力の 16 バイト単位の位置][チャンネル]、該当しないバイトは 0x80 (0 になる)
+    constexpr auto RGB24_SHUFFLE = [] {
+        std::array<std::array<std::array<int8_t, 16>, 3>, 3> masks{};
+        for (int part = 0; part < 3; ++part) {
+            for (int channel = 0; channel < 3; ++channel) {
+                for (int i = 0; i < 16; ++i) {
+                    const int offset = part * 16 + i;
+                    masks[part][channel][i] = static_cast<int8_t>(offset % 3 == channel ? offset / 3 : 0x80);
+                }
+            }
+        }
+        return masks;
+    }();
+
+    // 16 ピクセル分の Y, Cb, Cr (16bit) を RGB に変換する
+    // 結果は 0～255 に飽和済み
+    inline void ycbcrToRGB16(__m256i y, __m256i cb, __m256i cr, __m256i& r, __m256i& g, __m256i& b)
+    {
+        const __m256i offset = _mm256_set1_epi16(128);
+        cb = _mm256_sub_epi16(cb, offset);
+        cr = _mm256_sub_epi16(cr, offset);
+
+        r = _mm256_add_epi16(_mm256_add_epi16(y, cr), _mm256_mulhi_epi16(cr, _mm256_set1_epi16(COEF_R)));
+        b = _mm256_add_epi16(_mm256_add_epi16(y, _mm256_add_epi16(cb, cb)), _mm256_mulhi_epi16(cb, _mm256_set1_epi16(COEF_B)));
+
+        // G は Cb と Cr の積和を 32bit で求めてから >> 16 する
+        const __m256i coefG = _mm256_set1_epi32(static_cast<int32_t>((static_cast<uint32_t>(static_cast<uint16_t>(COEF_G_CR)) << 16) | static_cast<uint16_t>(COEF_G_CB)));
+        const __m256i lo = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(cb, cr), coefG), 16);
+        const __m256i hi = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(cb, cr), coefG), 16);
+        g = _mm256_sub_epi16(_mm256_sub_epi16(y, cr), _mm256_packs_epi32(lo, hi));
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max = _mm256_set1_epi16(255);
+        r = _mm256_min_epi16(_mm256_max_epi16(r, zero), max);
+        g = _mm256_min_epi16(_mm256_max_epi16(g, zero), max);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max);
+    }
+
+    // ストリーミングストアは書き込み先がアライメントされている場合だけ使う
+    inline void store128(uint8_t* dst, __m128i value, bool isNonTemporal)
+    {
+        auto* out = reinterpret_cast<__m128i*>(dst);
+        if (isNonTemporal && isAligned(dst, 16)) {
+            _mm_stream_si128(out, value);
+        }
+        else {
+            _mm_storeu_si128(out, value);
+        }
+    }
+
+    inline void store256(uint8_t* dst, __m256i value, bool isNonTemporal)
+    {
+        auto* out = reinterpret_cast<__m256i*>(dst);
+        if (isNonTemporal && isAligned(dst, 32)) {
+            _mm256_stream_si256(out, value);
+        }
+        else {
+            _mm256_storeu_si256(out, value);
+        }
+    }
+
+    // 16bit の 16 個を 8bit に詰める (値は 0～255 の前提)
+    inline __m128i packBytes(__m256i v)
+    {
+        return _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    }
+
+    // 16 ピクセル分の R, G, B (16bit) を Format の並びで dst に書き込む
+    template <PixelFormat Format>
+    inline void storePixels16(__m256i r, __m256i g, __m256i b, uint8_t* dst, bool isNonTemporal)
+    {
+        if constexpr (Format == PixelFormat::B8G8R8A8_UINT || Format == PixelFormat::R8G8B8A8_UINT) {
+            // 16bit の各要素を B | G << 8 と R | A << 8 にまとめて、交互に並べると BGRA になる (RGBA は R と B が逆)
+            const __m256i first = Format == PixelFormat::B8G8R8A8_UINT ? b : r;
+            const __m256i third = Format == PixelFormat::B8G8R8A8_UINT ? r : b;
+            const __m256i low = _mm256_or_si256(first, _mm256_slli_epi16(g, 8));
+            const __m256i high = _mm256_or_si256(third, _mm256_set1_epi16(static_cast<int16_t>(0xFF00)));
+            const __m256i lo = _mm256_unpacklo_epi16(low, high);
+            const __m256i hi = _mm256_unpackhi_epi16(low, high);
+
+            // unpack は 128bit 単位なので、ピクセルの順番に並べ直す
+            store256(dst, _mm256_permute2x128_si256(lo, hi, 0x20), isNonTemporal);
+            store256(dst + 32, _mm256_permute2x128_si256(lo, hi, 0x31), isNonTemporal);
+        }
+        else {
+            static_assert(Format == PixelFormat::R8G8B8_UINT || Format == PixelFormat::B8G8R8_UINT);
+            // 3 チャンネルを 8bit に詰めてから、出力の各バイトに来るものを pshufb で選んで OR する
+            const __m128i channels[3] = {
+                packBytes(Format == PixelFormat::R8G8B8_UINT ? r : b),
+                packBytes(g),
+                packBytes(Format == PixelFormat::R8G8B8_UINT ? b : r)
+            };
+            for (int part = 0; part < 3; ++part) {
+                __m128i value = _mm_setzero_si128();
+                for (int channel = 0; channel < 3; ++channel) {
+                    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RGB24_SHUFFLE[part][channel].data()));
+                    value = _mm_or_si128(value, _mm_shuffle_epi8(channels[channel], mask));
+                }
+                store128(dst + part * 16, value, isNonTemporal);
+            }
+        }
+    }
+
+    // 8 個の色差 (16bit) を 2 個ずつに複製して 16 個にする
+    inline __m256i duplicate8(const int16_t* src)
+    {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        return _mm256_set_m128i(_mm_unpackhi_epi16(c, c), _mm_unpacklo_epi16(c, c));
+    }
+
+    // 色差の i 番目から 8 個分について、縦方向の三角フィルタ (near * 3 + far) を求める
+    inline __m128i columnSum8(const int16_t* near, const int16_t* far, int i)
+    {
+        const __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(near + i));
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(far + i));
+        return _mm_add_epi16(_mm_add_epi16(n, _mm_add_epi16(n, n)), f);
+    }
+
+    // 色差の i 番目から 8 個分を、横方向にも三角フィルタをかけて 16 個に拡大する (upsampleFancy と同じ)
+    // i - 1 番目と i + 8 番目も読むので、両方とも色差の行の内側であること
+    inline __m256i upsampleFancy8(const int16_t* near, const int16_t* far, int i)
+    {
+        const __m128i prev = columnSum8(near, far, i - 1);
+        const __m128i current = columnSum8(near, far, i);
+        const __m128i next = columnSum8(near, far, i + 1);
+
+        const __m128i current3 = _mm_add_epi16(current, _mm_add_epi16(current, current));
+        const __m128i even = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(current3, prev), _mm_set1_epi16(8)), 4);
+        const __m128i odd = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(current3, next), _mm_set1_epi16(7)), 4);
+        return _mm256_set_m128i(_mm_unpackhi_epi16(even, odd), _mm_unpacklo_epi16(even, odd));
+    }
+
+    inline __m256i load16(const int16_t* src)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    }
+}
+
+namespace RagiMagick2::Image::Pixel
+{
+    void convertRowYCbCr420AVX2(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                __m256i r, g, b;
+                ycbcrToRGB16(load16(y + x), duplicate8(cb + x / 2), duplicate8(cr + x / 2), r, g, b);
+                storePixels16<Format>(r, g, b, dst + x * bytesPerPixel, isNonTemporal);
+            }
+            if (x < width) {
+                convertRowYCbCr420Scalar(y + x, cb + x / 2, cr + x / 2, width - x, dst + x * bytesPerPixel, Format, false);
+            }
+        });
+
+        if (isNonTemporal) {
+            _mm_sfence();
+        }
+    }
+
+    void convertRowYCbCr444AVX2(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                __m256i r, g, b;
+                ycbcrToRGB16(load16(y + x), load16(cb + x), load16(cr + x), r, g, b);
+                storePixels16<Format>(r, g, b, dst + x * bytesPerPixel, isNonTemporal);
+            }
+            if (x < width) {
+                convertRowYCbCr444Scalar(y + x, cb + x, cr + x, width - x, dst + x * bytesPerPixel, Format, false);
+            }
+        });
+
+        if (isNonTemporal) {
+            _mm_sfence();
+        }
+    }
+
+    void convertRowYCbCr420FancyAVX2(
+        const int16_t* y,
+        const int16_t* cbNear,
+        const int16_t* cbFar,
+        const int16_t* crNear,
+        const int16_t* crFar,
+        int chromaWidth,
+        int left,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept
+    {
+        dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+            constexpr int bytesPerPixel = getBytesPerPixel(Format);
+            const int right = left + width;
+
+            // 偶数の x から 16 ピクセル分ずつ、両隣の色差 (i - 1 と i + 8) が行の内側に収まる範囲だけ SIMD で処理する
+            // その前後 (行の端と、奇数の left) はスカラー版で
+            int begin = left % 2 == 0 ? left : left + 1;
+            begin = begin < 2 ? 2 : begin;
+            begin = begin < right ? begin : right;
+            if (begin > left) {
+                convertRowYCbCr420FancyScalar(y, cbNear, cbFar, crNear, crFar, chromaWidth, left, begin - left, dst, Format, false);
+            }
+            int x = begin;
+            for (; x + 16 <= right && x / 2 + 8 <= chromaWidth - 1; x += 16) {
+                const int i = x / 2;
+                __m256i r, g, b;
+                ycbcrToRGB16(load16(y + x), upsampleFancy8(cbNear, cbFar, i), upsampleFancy8(crNear, crFar, i), r, g, b);
+                storePixels16<Format>(r, g, b, dst + (x - left) * bytesPerPixel, isNonTemporal);
+            }
+            if (x < right) {
+                convertRowYCbCr420FancyScalar(y, cbNear, cbFar, crNear, crFar, chromaWidth, x, right - x, dst + (x - left) * bytesPerPixel, Format, false);
+            }
+        });
+
+        if (isNonTemporal) {
+            _mm_sfence();
+        }
+    }
+
+    void convertRowGrayAVX2(
+        const int16_t* y,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept
+    {
+        if (format == PixelFormat::R8_UINT) {
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                store128(dst + x, packBytes(load16(y + x)), isNonTemporal);
+            }
+            for (; x < width; ++x) {
+                dst[x] = static_cast<uint8_t>(y[x]);
+            }
+        }
+        else {
+            dispatchRGBFormat(format, [&]<PixelFormat Format>() {
+                constexpr int bytesPerPixel = getBytesPerPixel(Format);
+                int x = 0;
+                for (; x + 16 <= width; x += 16) {
+                    const __m256i value = load16(y + x);
+                    storePixels16<Format>(value, value, value, dst + x * bytesPerPixel, isNonTemporal);
+                }
+                if (x < width) {
+                    convertRowGrayScalar(y + x, width - x, dst + x * bytesPerPixel, Format, false);
+                }
+            });
+        }
+
+        if (isNonTemporal) {
+            _mm_sfence();
+        }
+    }
+
+} // namespace RagiMagick2::Image::Pixel
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
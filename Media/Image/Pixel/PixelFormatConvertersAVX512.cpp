@@ -0,0 +1,93 @@
+﻿#include "PixelFormatConverters.h"
+#include "SIMDCommon.h"
+#include <immintrin.h>
+#include <cstdint>
+
+// MSVC はこのファイルだけ /arch:AVX512 でビルドする (Media.vcxproj)
+// GCC / Clang は #include の後ろの定義だけを AVX-512 向けにする
+// MSVC ではヘッダーのインライン関数も AVX-512 でビルドされるので、ここでは呼ばない (PixelFormatConvertersAVX2.cpp と同じ)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512bw,avx512dq,avx512vl"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,avx512f,avx512bw,avx512dq,avx512vl")
+#endif
+
+namespace RagiMagick2::Image::Pixel
+{
+    using namespace RagiMagick2::Image::Pixel::SIMD;
+
+    void convertRowYCbCr420AVX512(
+        const int16_t* y,
+        const int16_t* cb,
+        const int16_t* cr,
+        int width,
+        uint8_t* dst,
+        PixelFormat format,
+        bool isNonTemporal
+    ) noexcept
+    {
+        int x = 0;
+        if (format == PixelFormat::B8G8R8A8_UINT || format == PixelFormat::R8G8B8A8_UINT) {
+            const bool isBGRA = format == PixelFormat::B8G8R8A8_UINT;
+            const __m512i duplicateIndex = _mm512_set_epi16(
+                15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8, 8,
+                7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0
+            );
+            const __m512i firstIndex = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+            const __m512i secondIndex = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+            const __m512i offset = _mm512_set1_epi16(128);
+            const __m512i coefG = _mm512_set1_epi32(static_cast<int32_t>((static_cast<uint32_t>(static_cast<uint16_t>(COEF_G_CR)) << 16) | static_cast<uint16_t>(COEF_G_CB)));
+            const __m512i zero = _mm512_setzero_si512();
+            const __m512i max = _mm512_set1_epi16(255);
+
+            for (; x + 32 <= width; x += 32) {
+                const __m512i y32 = _mm512_loadu_si512(y + x);
+                const __m512i cb32 = _mm512_sub_epi16(_mm512_permutexvar_epi16(duplicateIndex, _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cb + x / 2)))), offset);
+                const __m512i cr32 = _mm512_sub_epi16(_mm512_permutexvar_epi16(duplicateIndex, _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cr + x / 2)))), offset);
+
+                __m512i r = _mm512_add_epi16(_mm512_add_epi16(y32, cr32), _mm512_mulhi_epi16(cr32, _mm512_set1_epi16(COEF_R)));
+                __m512i b = _mm512_add_epi16(_mm512_add_epi16(y32, _mm512_add_epi16(cb32, cb32)), _mm512_mulhi_epi16(cb32, _mm512_set1_epi16(COEF_B)));
+                const __m512i lo = _mm512_srai_epi32(_mm512_madd_epi16(_mm512_unpacklo_epi16(cb32, cr32), coefG), 16);
+                const __m512i hi = _mm512_srai_epi32(_mm512_madd_epi16(_mm512_unpackhi_epi16(cb32, cr32), coefG), 16);
+                __m512i g = _mm512_sub_epi16(_mm512_sub_epi16(y32, cr32), _mm512_packs_epi32(lo, hi));
+
+                r = _mm512_min_epi16(_mm512_max_epi16(r, zero), max);
+                g = _mm512_min_epi16(_mm512_max_epi16(g, zero), max);
+                b = _mm512_min_epi16(_mm512_max_epi16(b, zero), max);
+
+                const __m512i low = _mm512_or_si512(isBGRA ? b : r, _mm512_slli_epi16(g, 8));
+                const __m512i high = _mm512_or_si512(isBGRA ? r : b, _mm512_set1_epi16(static_cast<int16_t>(0xFF00)));
+                const __m512i pixelsLo = _mm512_unpacklo_epi16(low, high);
+                const __m512i pixelsHi = _mm512_unpackhi_epi16(low, high);
+                const __m512i first = _mm512_permutex2var_epi64(pixelsLo, firstIndex, pixelsHi);
+                const __m512i second = _mm512_permutex2var_epi64(pixelsLo, secondIndex, pixelsHi);
+
+                uint8_t* out = dst + x * 4;
+                if (isNonTemporal && isAligned(out, 64)) {
+                    _mm512_stream_si512(reinterpret_cast<__m512i*>(out), first);
+                    _mm512_stream_si512(reinterpret_cast<__m512i*>(out + 64), second);
+                }
+                else {
+                    _mm512_storeu_si512(out, first);
+                    _mm512_storeu_si512(out + 64, second);
+                }
+            }
+        }
+
+        // 残りは AVX2 版で (x が進むのは 4 バイトの形式だけ)
+        if (x < width) {
+            convertRowYCbCr420AVX2(y + x, cb + x / 2, cr + x / 2, width - x, dst + x * 4, format, isNonTemporal);
+        }
+        else if (isNonTemporal) {
+            _mm_sfence();
+        }
+    }
+
+} // namespace RagiMagick2::Image::Pixel
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,203 @@
+﻿#include "PixelOrientation.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace RagiMagick2::Image::Pixel;
+
+namespace
+{
+    // 転置する場合のタイルの一辺 (ピクセル)
+    constexpr int TILE_SIZE = 16;
+
+    // 元の画像の (sx, sy) が、向きを変えた画像のどこに来るか
+    struct Mapping
+    {
+        const Orientation& orientation;
+        // 向きを変えた後のサイズ
+        int width;
+        int height;
+
+        inline std::ptrdiff_t getOffset(int sx, int sy, int bytesPerPixel, size_t dstStride) const noexcept
+        {
+            const int tx = orientation.transpose ? sy : sx;
+            const int ty = orientation.transpose ? sx : sy;
+            const int dx = orientation.flipX ? width - 1 - tx : tx;
+            const int dy = orientation.flipY ? height - 1 - ty : ty;
+            return static_cast<std::ptrdiff_t>(dy) * static_cast<std::ptrdiff_t>(dstStride) + static_cast<std::ptrdiff_t>(dx) * bytesPerPixel;
+        }
+    };
+
+    // 転置しない場合は、元の1行が向きを変えた画像の1行 (左右反転なら逆順) になる
+    template <int BytesPerPixel>
+    void storeRows(
+        const Mapping& mapping,
+        const uint8_t* src,
+        size_t srcStride,
+        int x,
+        int y,
+        int width,
+        int height,
+        uint8_t* dst,
+        size_t dstStride
+    )
+    {
+        for (int row = 0; row < height; ++row) {
+            const uint8_t* s = src + row * srcStride;
+            uint8_t* d = dst + mapping.getOffset(x, y + row, BytesPerPixel, dstStride);
+            if (!mapping.orientation.flipX) {
+                std::memcpy(d, s, static_cast<size_t>(width) * BytesPerPixel);
+                continue;
+            }
+            for (int col = 0; col < width; ++col) {
+                std::memcpy(d - col * BytesPerPixel, s + col * BytesPerPixel, BytesPerPixel);
+            }
+        }
+    }
+
+    // 4x4 (uint32_t) を転置して、元の列を向きを変えた画像の行として書き込む
+    // 左右反転する場合は、行の中の並びを逆にする
+    inline void storeTransposed4x4(
+        const Mapping& mapping,
+        const uint8_t* src,
+        size_t srcStride,
+        int sx,
+        int sy,
+        uint8_t* dst,
+        size_t dstStride
+    )
+    {
+        const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + srcStride));
+        const __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + srcStride * 2));
+        const __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + srcStride * 3));
+
+        const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        __m128i columns[4] = {
+            _mm_unpacklo_epi64(t0, t1),
+            _mm_unpackhi_epi64(t0, t1),
+            _mm_unpacklo_epi64(t2, t3),
+            _mm_unpackhi_epi64(t2, t3),
+        };
+
+        // 向きを変えた画像では、元の列 sx + i の4ピクセルは (sy, sy + 3) の範囲に並ぶ
+        const int firstRow = mapping.orientation.flipX ? sy + 3 : sy;
+        for (int i = 0; i < 4; ++i) {
+            __m128i column = columns[i];
+            if (mapping.orientation.flipX) {
+                column = _mm_shuffle_epi32(column, _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + mapping.getOffset(sx + i, firstRow, 4, dstStride)), column);
+        }
+    }
+
+    // 転置する場合は、タイルごとに元の行を読んで向きを変えた画像の列に書き込む
+    template <int BytesPerPixel>
+    void storeTiles(
+        const Mapping& mapping,
+        const uint8_t* src,
+        size_t srcStride,
+        int x,
+        int y,
+        int width,
+        int height,
+        uint8_t* dst,
+        size_t dstStride
+    )
+    {
+        for (int tileY = 0; tileY < height; tileY += TILE_SIZE) {
+            const int tileHeight = std::min(TILE_SIZE, height - tileY);
+            for (int tileX = 0; tileX < width; tileX += TILE_SIZE) {
+                const int tileWidth = std::min(TILE_SIZE, width - tileX);
+
+                int row = 0;
+                if constexpr (BytesPerPixel == 4) {
+                    for (; row + 4 <= tileHeight; row += 4) {
+                        const uint8_t* s = src + (tileY + row) * srcStride + tileX * BytesPerPixel;
+                        int col = 0;
+                        for (; col + 4 <= tileWidth; col += 4) {
+                            storeTransposed4x4(mapping, s + col * BytesPerPixel, srcStride, x + tileX + col, y + tileY + row, dst, dstStride);
+                        }
+                        for (int r = 0; r < 4; ++r) {
+                            for (int c = col; c < tileWidth; ++c) {
+                                const auto offset = mapping.getOffset(x + tileX + c, y + tileY + row + r, BytesPerPixel, dstStride);
+                                std::memcpy(dst + offset, s + r * srcStride + c * BytesPerPixel, BytesPerPixel);
+                            }
+                        }
+                    }
+                }
+                for (; row < tileHeight; ++row) {
+                    const uint8_t* s = src + (tileY + row) * srcStride + tileX * BytesPerPixel;
+                    for (int col = 0; col < tileWidth; ++col) {
+                        const auto offset = mapping.getOffset(x + tileX + col, y + tileY + row, BytesPerPixel, dstStride);
+                        std::memcpy(dst + offset, s + col * BytesPerPixel, BytesPerPixel);
+                    }
+                }
+            }
+        }
+    }
+
+    template <int BytesPerPixel>
+    void store(
+        const Mapping& mapping,
+        const uint8_t* src,
+        size_t srcStride,
+        int x,
+        int y,
+        int width,
+        int height,
+        uint8_t* dst,
+        size_t dstStride
+    )
+    {
+        if (mapping.orientation.transpose) {
+            storeTiles<BytesPerPixel>(mapping, src, srcStride, x, y, width, height, dst, dstStride);
+        }
+        else {
+            storeRows<BytesPerPixel>(mapping, src, srcStride, x, y, width, height, dst, dstStride);
+        }
+    }
+}
+
+namespace RagiMagick2::Image::Pixel
+{
+    void storeOriented(
+        const Orientation& orientation,
+        int bytesPerPixel,
+        const uint8_t* src,
+        size_t srcStride,
+        int x,
+        int y,
+        int width,
+        int height,
+        int imageWidth,
+        int imageHeight,
+        uint8_t* dst,
+        size_t dstStride
+    )
+    {
+        const auto [orientedWidth, orientedHeight] = getOrientedSize(imageWidth, imageHeight, orientation);
+        const Mapping mapping{ orientation, orientedWidth, orientedHeight };
+
+        switch (bytesPerPixel) {
+        case 1:
+            store<1>(mapping, src, srcStride, x, y, width, height, dst, dstStride);
+            break;
+        case 3:
+            store<3>(mapping, src, srcStride, x, y, width, height, dst, dstStride);
+            break;
+        case 4:
+            store<4>(mapping, src, srcStride, x, y, width, height, dst, dstStride);
+            break;
+        default:
+            assert(false);
+            break;
+        }
+    }
+} // namespace RagiMagick2::Image::Pixel
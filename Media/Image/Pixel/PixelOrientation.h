@@ -0,0 +1,77 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace RagiMagick2::Image::Pixel
+{
+    // EXIF の Orientation (1～8) を「転置してから左右・上下に反転する」の組み合わせで表したもの
+    struct Orientation
+    {
+        bool transpose = false;
+        bool flipX = false;
+        bool flipY = false;
+
+        constexpr bool isIdentity() const noexcept { return !transpose && !flipX && !flipY; }
+    };
+
+    // 保存された画像を表示の向きにする変換 (範囲外の値は 1 として扱う)
+    constexpr Orientation getOrientation(int exifOrientation) noexcept
+    {
+        switch (exifOrientation) {
+        case 2:
+            return { false, true, false };  // 左右反転
+        case 3:
+            return { false, true, true };   // 180 度回転
+        case 4:
+            return { false, false, true };  // 上下反転
+        case 5:
+            return { true, false, false };  // 転置
+        case 6:
+            return { true, true, false };   // 時計回りに 90 度回転
+        case 7:
+            return { true, true, true };    // 反転置
+        case 8:
+            return { true, false, true };   // 反時計回りに 90 度回転
+        default:
+            return {};
+        }
+    }
+
+    // width x height の画像の向きを変えた後のサイズ (幅, 高さ)
+    constexpr std::tuple<int, int> getOrientedSize(int width, int height, const Orientation& orientation) noexcept
+    {
+        return orientation.transpose ? std::make_tuple(height, width) : std::make_tuple(width, height);
+    }
+
+    // first で向きを変えてから second で向きを変えるのと同じ変換
+    // first の反転を second の転置の後に回すと、左右と上下の反転が入れ替わる
+    constexpr Orientation combineOrientations(const Orientation& first, const Orientation& second) noexcept
+    {
+        return {
+            first.transpose != second.transpose,
+            (second.transpose ? first.flipY : first.flipX) != second.flipX,
+            (second.transpose ? first.flipX : first.flipY) != second.flipY,
+        };
+    }
+
+    // imageWidth x imageHeight の画像のうち、 (x, y) から width x height の範囲の src (1行 srcStride バイト) を、
+    // 向きを変えた画像 dst (1行 dstStride バイト) の対応する位置に書き込む
+    // bytesPerPixel は 1, 3, 4 のいずれか
+    // 転置する場合は 16x16 ピクセルのタイルごとに書き込むので、 dst の読み書きはタイルの行数分のキャッシュラインに収まる
+    // 4 バイトのピクセルは SSE2 の 4x4 転置で書き込む
+    void storeOriented(
+        const Orientation& orientation,
+        int bytesPerPixel,
+        const uint8_t* src,
+        size_t srcStride,
+        int x,
+        int y,
+        int width,
+        int height,
+        int imageWidth,
+        int imageHeight,
+        uint8_t* dst,
+        size_t dstStride
+    );
+} // namespace RagiMagick2::Image::Pixel
@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include "PixelFormat.h"
+
+// PixelFormatConverters の各実装 (スカラー、 AVX2、 AVX-512) で共有する定数と関数
+// 関数は /arch:AVX2 などでビルドする翻訳単位でも使うので、 static (内部リンケージ) にする
+// (inline だとリンカーが1つにまとめるので、 AVX 命令で生成したものがスカラー版から呼ばれることがある)
+namespace RagiMagick2::Image::Pixel::SIMD
+{
+    // ycbcrToRGB の係数を 16bit の乗算で表したもの
+    // 1.402 * 65536 = 65536 + 26345 のように、1 を超える分は加算に回して mulhi (>> 16) の範囲に収める
+    // floor((a * 65536 + b) / 65536) = a + floor(b / 65536) なので、丸めもスカラー版と同じになる
+    inline constexpr int16_t COEF_R = 26345;    // 91881 - 65536
+    inline constexpr int16_t COEF_B = -14943;   // 116129 - 65536 * 2
+    inline constexpr int16_t COEF_G_CB = 22553;
+    inline constexpr int16_t COEF_G_CR = -18735; // 46801 - 65536
+
+    static inline bool isAligned(const uint8_t* dst, size_t alignment) noexcept
+    {
+        return reinterpret_cast<uintptr_t>(dst) % alignment == 0;
+    }
+
+    // format に合わせて、テンプレートの関数オブジェクト f を呼ぶ (format は isRGBFormat の形式)
+    // 形式の分岐を1ピクセルごとではなく1行に1回で済ませる
+    template <typename Func>
+    static inline void dispatchRGBFormat(PixelFormat format, Func&& f)
+    {
+        switch (format) {
+        case PixelFormat::B8G8R8A8_UINT:
+            f.template operator()<PixelFormat::B8G8R8A8_UINT>();
+            break;
+        case PixelFormat::R8G8B8A8_UINT:
+            f.template operator()<PixelFormat::R8G8B8A8_UINT>();
+            break;
+        case PixelFormat::R8G8B8_UINT:
+            f.template operator()<PixelFormat::R8G8B8_UINT>();
+            break;
+        case PixelFormat::B8G8R8_UINT:
+            f.template operator()<PixelFormat::B8G8R8_UINT>();
+            break;
+        default:
+            assert(false);
+            break;
+        }
+    }
+} // namespace RagiMagick2::Image::Pixel::SIMD